@@ -0,0 +1,423 @@
+#ifndef _EXPR_H_
+#define _EXPR_H_
+
+#include <cmath>        // std::sqrt
+#include <cstddef>      // std::size_t
+#include <stdexcept>    // std::length_error
+#include <type_traits>  // std::common_type, std::enable_if, std::is_arithmetic, std::is_base_of
+#include <utility>      // std::declval
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Base of the lazy element-wise expressions over vectors of arithmetic types.
+/*!
+ * `a * b + c`, with `a`, `b` and `c` vectors, builds a small tree of nodes instead of two
+ * temporary vectors; assigning it to a vector (or constructing one from it) runs a single
+ * loop whose body is the whole expression, which the compiler can vectorize:
+ *
+ *     sc::vector<double> r = a * b + c;
+ *     r = sc::where(a < 0.0, -a, sc::sqrt(a)) * 2.0;
+ *     r.assign(a * b + c, sc::parallel);  // One slice per thread.
+ *
+ * Operands are vectors, other expressions and scalars, which are broadcast. The operators
+ * are `+ - * /` and unary `-`; sc::sqrt(), sc::abs(), sc::min() and sc::max() work element
+ * by element. Comparisons `< <= > >=`, sc::equal() and sc::not_equal() give masks of `bool`
+ * (`==` keeps comparing whole vectors), for sc::where() or a sc::vector<bool>.
+ *
+ * Nodes read vectors through raw pointers: evaluate an expression before its vectors change.
+ */
+template <typename E>
+struct expression {
+    /// The expression as its node type.
+    const E& self(void) const { return static_cast<const E&>(*this); }
+
+    /// Writes elements [first, last) of the expression to `out`.
+    template <typename T>
+    void evaluate(T* out, std::size_t first, std::size_t last) const {
+        const E& e = self();
+        for (std::size_t i = first; i < last; ++i) out[i] = static_cast<T>(e[i]);
+    }
+};
+
+/// Implementation details.
+namespace detail {
+
+/// A vector operand, read through a raw pointer.
+template <typename T>
+class terminal : public expression<terminal<T>> {
+   private:
+    const T* m_data;     //!< First element.
+    std::size_t m_size;  //!< Number of elements.
+
+   public:
+    using value_type = T;                    //!< Element type.
+    static constexpr bool broadcast = false;  //!< Whether the node has the same value at every index.
+
+    terminal(const T* data, std::size_t size) : m_data{data}, m_size{size} {}
+    T operator[](std::size_t i) const { return m_data[i]; }
+    std::size_t size(void) const { return m_size; }
+};
+
+/// A scalar operand, the same value at every index.
+template <typename T>
+class scalar : public expression<scalar<T>> {
+   private:
+    T m_value;  //!< The value.
+
+   public:
+    using value_type = T;                   //!< Element type.
+    static constexpr bool broadcast = true;  //!< Whether the node has the same value at every index.
+
+    explicit scalar(T value) : m_value{value} {}
+    T operator[](std::size_t) const { return m_value; }
+    std::size_t size(void) const { return 0; }
+};
+
+/// Throws unless two operands can be combined element by element.
+template <typename L, typename R>
+void check_sizes(const L& lhs, const R& rhs) {
+    if (not L::broadcast and not R::broadcast and lhs.size() != rhs.size())
+        throw std::length_error("[sc::expression]: operandos com tamanhos diferentes.");
+}
+
+/// `Op(a[i])` for each index.
+template <typename Op, typename A>
+class unary : public expression<unary<Op, A>> {
+   private:
+    A m_arg;  //!< The operand.
+
+   public:
+    using value_type = decltype(Op()(std::declval<typename A::value_type>()));  //!< Element type.
+    static constexpr bool broadcast = A::broadcast;  //!< Whether the node has the same value at every index.
+
+    explicit unary(const A& arg) : m_arg(arg) {}
+    value_type operator[](std::size_t i) const { return Op()(m_arg[i]); }
+    std::size_t size(void) const { return m_arg.size(); }
+};
+
+/// `Op(l[i], r[i])` for each index.
+template <typename Op, typename L, typename R>
+class binary : public expression<binary<Op, L, R>> {
+   private:
+    L m_lhs;  //!< Left operand.
+    R m_rhs;  //!< Right operand.
+
+   public:
+    using value_type = decltype(Op()(std::declval<typename L::value_type>(),
+                                     std::declval<typename R::value_type>()));  //!< Element type.
+    static constexpr bool broadcast = L::broadcast and R::broadcast;  //!< Whether the node has the same value at every index.
+
+    binary(const L& lhs, const R& rhs) : m_lhs(lhs), m_rhs(rhs) { check_sizes(lhs, rhs); }
+    value_type operator[](std::size_t i) const { return Op()(m_lhs[i], m_rhs[i]); }
+    std::size_t size(void) const { return L::broadcast ? m_rhs.size() : m_lhs.size(); }
+};
+
+/// `m[i] ? a[i] : b[i]` for each index; both sides are computed, so the loop stays branch-free.
+template <typename M, typename A, typename B>
+class select : public expression<select<M, A, B>> {
+   private:
+    M m_mask;  //!< The mask.
+    A m_then;  //!< Values where the mask is set.
+    B m_else;  //!< Values where it is not.
+
+   public:
+    using value_type = typename std::common_type<typename A::value_type, typename B::value_type>::type;  //!< Element type.
+    static constexpr bool broadcast = M::broadcast and A::broadcast and B::broadcast;  //!< Whether the node has the same value at every index.
+
+    select(const M& mask, const A& a, const B& b) : m_mask(mask), m_then(a), m_else(b) {
+        check_sizes(mask, a);
+        check_sizes(mask, b);
+        check_sizes(a, b);
+    }
+    value_type operator[](std::size_t i) const {
+        value_type a = m_then[i], b = m_else[i];
+        return m_mask[i] ? a : b;
+    }
+    std::size_t size(void) const { return not M::broadcast ? m_mask.size() : not A::broadcast ? m_then.size() : m_else.size(); }
+};
+
+//=== Element operations.
+
+/// a + b.
+struct add_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a + b) { return a + b; }
+};
+/// a - b.
+struct sub_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a - b) { return a - b; }
+};
+/// a * b.
+struct mul_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a * b) { return a * b; }
+};
+/// a / b.
+struct div_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a / b) { return a / b; }
+};
+/// -a.
+struct neg_op {
+    template <typename A>
+    auto operator()(A a) const -> decltype(-a) { return -a; }
+};
+/// Square root; a double for integer elements, like std::sqrt.
+struct sqrt_op {
+    template <typename A>
+    auto operator()(A a) const -> decltype(std::sqrt(a)) { return std::sqrt(a); }
+};
+/// Absolute value, as a select so it vectorizes for every arithmetic type.
+struct abs_op {
+    template <typename A>
+    A operator()(A a) const { return a < A(0) ? A(-a) : a; }
+};
+/// The smaller of a and b (a when they are equal).
+struct min_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a + b) { return b < a ? b : a; }
+};
+/// The larger of a and b (a when they are equal).
+struct max_op {
+    template <typename A, typename B>
+    auto operator()(A a, B b) const -> decltype(a + b) { return a < b ? b : a; }
+};
+/// a < b.
+struct less_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a < b; }
+};
+/// a <= b.
+struct less_equal_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a <= b; }
+};
+/// a > b.
+struct greater_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a > b; }
+};
+/// a >= b.
+struct greater_equal_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a >= b; }
+};
+/// a == b.
+struct equal_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a == b; }
+};
+/// a != b.
+struct not_equal_op {
+    template <typename A, typename B>
+    bool operator()(A a, B b) const { return a != b; }
+};
+
+//=== Operands.
+
+/// How a value takes part in an expression; not at all by default.
+template <typename X, typename = void>
+struct operand {
+    static constexpr bool is_array = false;   //!< A vector or an expression.
+    static constexpr bool is_scalar = false;  //!< An arithmetic value, broadcast.
+};
+
+/// Vectors of arithmetic types become terminals.
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+struct operand<vector<T, SizeType, ShrinkPolicy, Storage>, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+    static constexpr bool is_array = true;    //!< A vector or an expression.
+    static constexpr bool is_scalar = false;  //!< An arithmetic value, broadcast.
+    using node_type = terminal<T>;            //!< Node of the operand.
+
+    static node_type node(const vector<T, SizeType, ShrinkPolicy, Storage>& v) {
+        return node_type(v.cbegin().base(), static_cast<std::size_t>(v.size()));
+    }
+};
+
+/// Expressions are their own nodes.
+template <typename E>
+struct operand<E, typename std::enable_if<std::is_base_of<expression<E>, E>::value>::type> {
+    static constexpr bool is_array = not E::broadcast;  //!< A vector or an expression.
+    static constexpr bool is_scalar = false;            //!< An arithmetic value, broadcast.
+    using node_type = E;                                //!< Node of the operand.
+
+    static const E& node(const E& e) { return e; }
+};
+
+/// Arithmetic values are broadcast.
+template <typename S>
+struct operand<S, typename std::enable_if<std::is_arithmetic<S>::value>::type> {
+    static constexpr bool is_array = false;  //!< A vector or an expression.
+    static constexpr bool is_scalar = true;  //!< An arithmetic value, broadcast.
+    using node_type = scalar<S>;             //!< Node of the operand.
+
+    static node_type node(S s) { return node_type(s); }
+};
+
+/// Node of `X` when combined with `Other`: a scalar takes the element type of the other side,
+/// so that `v * 2` multiplies doubles by 2.0 rather than promoting floats or narrowing.
+template <typename X, typename Other, typename = void>
+struct node_of {
+    using type = typename operand<X>::node_type;  //!< The node type.
+    static type make(const X& x) { return operand<X>::node(x); }
+};
+template <typename X, typename Other>
+struct node_of<X, Other, typename std::enable_if<operand<X>::is_scalar and operand<Other>::is_array>::type> {
+    using type = scalar<typename operand<Other>::node_type::value_type>;  //!< The node type.
+    static type make(const X& x) { return type(static_cast<typename type::value_type>(x)); }
+};
+
+/// The node of `Op(lhs, rhs)`, when at least one side is a vector or an expression.
+template <typename Op, typename L, typename R>
+struct enable_binary
+    : std::enable_if<(operand<L>::is_array or operand<R>::is_array) and (operand<L>::is_array or operand<L>::is_scalar) and
+                         (operand<R>::is_array or operand<R>::is_scalar),
+                     binary<Op, typename node_of<L, R>::type, typename node_of<R, L>::type>> {};
+
+/// Builds the node of `Op(lhs, rhs)`.
+template <typename Op, typename L, typename R>
+binary<Op, typename node_of<L, R>::type, typename node_of<R, L>::type> make_binary(const L& lhs, const R& rhs) {
+    return binary<Op, typename node_of<L, R>::type, typename node_of<R, L>::type>(node_of<L, R>::make(lhs),
+                                                                                   node_of<R, L>::make(rhs));
+}
+
+/// Node of a branch of sc::where(): a scalar takes the element type of the other branch,
+/// or keeps its own when both are scalars.
+template <typename X, typename Other>
+struct branch_of : node_of<X, typename std::conditional<operand<Other>::is_array, Other, X>::type> {};
+
+/// The node of `Op(arg)`, for a vector or an expression.
+template <typename Op, typename A>
+struct enable_unary : std::enable_if<operand<A>::is_array, unary<Op, typename operand<A>::node_type>> {};
+
+/// Runs `f(e[i])` for each index of the expression `e`.
+template <typename E, typename F>
+void for_each_value(const E& e, F f) {
+    const std::size_t n = e.size();
+    for (std::size_t i = 0; i < n; ++i) f(e[i]);
+}
+
+}  // namespace detail.
+
+//=== Operators and functions.
+
+/// Element-wise sum.
+template <typename L, typename R>
+typename detail::enable_binary<detail::add_op, L, R>::type operator+(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::add_op>(lhs, rhs);
+}
+/// Element-wise difference.
+template <typename L, typename R>
+typename detail::enable_binary<detail::sub_op, L, R>::type operator-(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::sub_op>(lhs, rhs);
+}
+/// Element-wise product.
+template <typename L, typename R>
+typename detail::enable_binary<detail::mul_op, L, R>::type operator*(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::mul_op>(lhs, rhs);
+}
+/// Element-wise quotient.
+template <typename L, typename R>
+typename detail::enable_binary<detail::div_op, L, R>::type operator/(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::div_op>(lhs, rhs);
+}
+/// Element-wise minimum.
+template <typename L, typename R>
+typename detail::enable_binary<detail::min_op, L, R>::type min(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::min_op>(lhs, rhs);
+}
+/// Element-wise maximum.
+template <typename L, typename R>
+typename detail::enable_binary<detail::max_op, L, R>::type max(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::max_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] < rhs[i]`.
+template <typename L, typename R>
+typename detail::enable_binary<detail::less_op, L, R>::type operator<(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::less_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] <= rhs[i]`.
+template <typename L, typename R>
+typename detail::enable_binary<detail::less_equal_op, L, R>::type operator<=(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::less_equal_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] > rhs[i]`.
+template <typename L, typename R>
+typename detail::enable_binary<detail::greater_op, L, R>::type operator>(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::greater_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] >= rhs[i]`.
+template <typename L, typename R>
+typename detail::enable_binary<detail::greater_equal_op, L, R>::type operator>=(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::greater_equal_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] == rhs[i]`; `lhs == rhs` still compares whole vectors.
+template <typename L, typename R>
+typename detail::enable_binary<detail::equal_op, L, R>::type equal(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::equal_op>(lhs, rhs);
+}
+/// Mask of `lhs[i] != rhs[i]`.
+template <typename L, typename R>
+typename detail::enable_binary<detail::not_equal_op, L, R>::type not_equal(const L& lhs, const R& rhs) {
+    return detail::make_binary<detail::not_equal_op>(lhs, rhs);
+}
+
+/// Element-wise negation.
+template <typename A>
+typename detail::enable_unary<detail::neg_op, A>::type operator-(const A& arg) {
+    return typename detail::enable_unary<detail::neg_op, A>::type(detail::operand<A>::node(arg));
+}
+/// Element-wise square root.
+template <typename A>
+typename detail::enable_unary<detail::sqrt_op, A>::type sqrt(const A& arg) {
+    return typename detail::enable_unary<detail::sqrt_op, A>::type(detail::operand<A>::node(arg));
+}
+/// Element-wise absolute value.
+template <typename A>
+typename detail::enable_unary<detail::abs_op, A>::type abs(const A& arg) {
+    return typename detail::enable_unary<detail::abs_op, A>::type(detail::operand<A>::node(arg));
+}
+
+/// `mask[i] ? a[i] : b[i]` for each index; `a` and `b` may be scalars.
+template <typename M, typename A, typename B>
+typename std::enable_if<detail::operand<M>::is_array and (detail::operand<A>::is_array or detail::operand<A>::is_scalar) and
+                            (detail::operand<B>::is_array or detail::operand<B>::is_scalar),
+                        detail::select<typename detail::operand<M>::node_type, typename detail::branch_of<A, B>::type,
+                                       typename detail::branch_of<B, A>::type>>::type
+where(const M& mask, const A& a, const B& b) {
+    return detail::select<typename detail::operand<M>::node_type, typename detail::branch_of<A, B>::type,
+                          typename detail::branch_of<B, A>::type>(detail::operand<M>::node(mask), detail::branch_of<A, B>::make(a),
+                                                                  detail::branch_of<B, A>::make(b));
+}
+
+/// Sum of the elements of a vector or an expression, computed in one pass.
+template <typename E>
+auto sum(const E& e) -> typename std::enable_if<detail::operand<E>::is_array,
+                                                typename detail::operand<E>::node_type::value_type>::type {
+    typename detail::operand<E>::node_type::value_type total{};
+    detail::for_each_value(detail::operand<E>::node(e), [&total](typename detail::operand<E>::node_type::value_type x) {
+        total += x;
+    });
+    return total;
+}
+/// Whether any element of a mask is set.
+template <typename E>
+typename std::enable_if<detail::operand<E>::is_array, bool>::type any(const E& e) {
+    bool found = false;
+    detail::for_each_value(detail::operand<E>::node(e), [&found](bool x) { found = found or x; });
+    return found;
+}
+/// Whether every element of a mask is set.
+template <typename E>
+typename std::enable_if<detail::operand<E>::is_array, bool>::type all(const E& e) {
+    bool every = true;
+    detail::for_each_value(detail::operand<E>::node(e), [&every](bool x) { every = every and x; });
+    return every;
+}
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,565 @@
+#ifndef _GAP_VECTOR_H_
+#define _GAP_VECTOR_H_
+
+#include <algorithm>         // std::max
+#include <cstddef>           // std::ptrdiff_t
+#include <initializer_list>  // std::initializer_list
+#include <iterator>          // std::distance, std::random_access_iterator_tag
+#include <memory>            // std::allocator, std::allocator_traits
+#include <stdexcept>         // std::out_of_range, std::length_error
+#include <utility>           // std::forward, std::move, std::move_if_noexcept
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Iterator over a gap buffer: walks the logical positions and skips the gap.
+template <class T>
+class gap_iterator {
+   public:
+    typedef gap_iterator self_type;                             //!< Alias to iterator.
+    typedef std::ptrdiff_t difference_type;                     //!< Distance between iterators.
+    typedef T value_type;                                       //!< Value type the iterator points to.
+    typedef T* pointer;                                         //!< Pointer to the value type.
+    typedef T& reference;                                       //!< Reference to the value type.
+    typedef std::random_access_iterator_tag iterator_category;  //!< Iterator category.
+
+   private:
+    pointer m_base;             //!< Start of the storage area.
+    std::size_t m_index;        //!< Logical position.
+    std::size_t m_gap_begin;    //!< First slot of the gap.
+    std::size_t m_gap_length;   //!< Number of slots in the gap.
+
+    template <class U>
+    friend class gap_iterator;
+
+   public:
+    //=== [I] CONSTRUCTORS
+    /**
+     * @brief Construct an iterator at logical position `index` of a buffer with a gap.
+     */
+    gap_iterator(pointer base = nullptr, std::size_t index = 0, std::size_t gap_begin = 0, std::size_t gap_length = 0)
+        : m_base{base}, m_index{index}, m_gap_begin{gap_begin}, m_gap_length{gap_length} {}
+    /**
+     * @brief Converts a mutable iterator into a constant one.
+     */
+    template <class U>
+    gap_iterator(const gap_iterator<U>& other)
+        : m_base{other.m_base}, m_index{other.m_index}, m_gap_begin{other.m_gap_begin}, m_gap_length{other.m_gap_length} {}
+
+    //=== [II] OPERATORS
+    /**
+     * @brief The unary indirection operator.
+     */
+    reference operator*() const { return m_base[m_index < m_gap_begin ? m_index : m_index + m_gap_length]; }
+    /**
+     * @brief The operator prefix increment.
+     */
+    gap_iterator& operator++() {
+        ++m_index;
+        return *this;
+    }
+    /**
+     * @brief The operator postfix increment.
+     */
+    gap_iterator operator++(int) {
+        gap_iterator it = *this;
+        ++(*this);
+        return it;
+    }
+    /**
+     * @brief The operator prefix decrement.
+     */
+    gap_iterator& operator--() {
+        --m_index;
+        return *this;
+    }
+    /**
+     * @brief The operator postfix decrement.
+     */
+    gap_iterator operator--(int) {
+        gap_iterator it = *this;
+        --(*this);
+        return it;
+    }
+    /**
+     * @brief The subscript operator.
+     */
+    reference operator[](difference_type n) const { return *(*this + n); }
+    /**
+     * @brief The distance between two iterators.
+     */
+    difference_type operator-(const gap_iterator& other) const {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+    /**
+     * @brief The equality operator.
+     */
+    bool operator==(const gap_iterator& other) const { return m_index == other.m_index and m_base == other.m_base; }
+    /**
+     * @brief The inequality operator.
+     */
+    bool operator!=(const gap_iterator& other) const { return not(*this == other); }
+    /**
+     * @brief The operator less than.
+     */
+    bool operator<(const gap_iterator& other) const { return m_index < other.m_index; }
+    /**
+     * @brief Returns the logical position of the iterator.
+     */
+    std::size_t index(void) const { return m_index; }
+
+    //=== [III] Friend functions.
+    /**
+     * @brief The operation of sum between difference_type and gap_iterator.
+     */
+    friend gap_iterator operator+(difference_type lhs, gap_iterator rhs) {
+        rhs.m_index += lhs;
+        return rhs;
+    }
+    /**
+     * @brief The operation of sum between gap_iterator and difference_type.
+     */
+    friend gap_iterator operator+(gap_iterator lhs, difference_type rhs) {
+        lhs.m_index += rhs;
+        return lhs;
+    }
+    /**
+     * @brief The operation of minus between gap_iterator and difference_type.
+     */
+    friend gap_iterator operator-(gap_iterator lhs, difference_type rhs) {
+        lhs.m_index -= rhs;
+        return lhs;
+    }
+};
+
+/// This class implements the ADT list with a gap buffer.
+/*!
+ * sc::gap_vector keeps its elements in one storage area split by a *gap* of free slots:
+ * [0, gap_begin) holds the elements before the cursor and [gap_end, capacity) the ones
+ * after it. Inserting or erasing at the cursor only touches the edge of the gap, so it is
+ * O(1) amortized; moving the cursor moves the elements between the old and the new
+ * position, O(distance). Edits clustered around a moving position (the lines of an
+ * editor, for instance) never shift the whole tail as sc::vector::insert() does.
+ *
+ * The interface follows sc::vector: any insert() or erase() first moves the cursor to
+ * the position given, and iterators skip the gap.
+ *
+ * \tparam T The type of the elements.
+ */
+template <typename T>
+class gap_vector {
+   public:
+    using size_type = unsigned long;                //!< The size type.
+    using value_type = T;                           //!< The value type.
+    using pointer = T*;                             //!< Pointer to a value stored in the container.
+    using reference = T&;                           //!< Reference to a value stored in the container.
+    using const_reference = const T&;               //!< Const reference to a value stored in the container.
+    using iterator = gap_iterator<T>;               //!< The iterator.
+    using const_iterator = gap_iterator<const T>;   //!< The const_iterator.
+    using allocator_type = std::allocator<T>;       //!< The allocator that provides the storage area.
+
+   private:
+    using alloc_traits = std::allocator_traits<allocator_type>;  //!< Allocator interface.
+
+    size_type m_gap_begin;  //!< First slot of the gap, which is also the cursor position.
+    size_type m_gap_end;    //!< Slot following the gap.
+    size_type m_capacity;   //!< The list's storage capacity.
+    pointer m_storage;      //!< The list's data storage area.
+
+    //=== Storage helpers.
+    /// Allocates raw room for `n` elements.
+    static pointer allocate_storage(size_type n) {
+        allocator_type alloc;
+        return n == 0 ? nullptr : alloc_traits::allocate(alloc, n);
+    }
+    /// Moves the element at `from` to the raw slot `to`, leaving `from` raw.
+    static void relocate(pointer from, pointer to) {
+        allocator_type alloc;
+        alloc_traits::construct(alloc, to, std::move_if_noexcept(*from));
+        alloc_traits::destroy(alloc, from);
+    }
+    /// Destroys every element and frees the storage area.
+    void release_storage(void) {
+        allocator_type alloc;
+        for (size_type i{0}; i < m_capacity; ++i)
+            if (i < m_gap_begin or i >= m_gap_end) alloc_traits::destroy(alloc, m_storage + i);
+        if (m_storage != nullptr) alloc_traits::deallocate(alloc, m_storage, m_capacity);
+        m_storage = nullptr;
+        m_gap_begin = m_gap_end = m_capacity = 0;
+    }
+    /// Moves the elements to a new storage area of `new_cap` slots, keeping the cursor.
+    void reallocate(size_type new_cap) {
+        pointer temp = allocate_storage(new_cap);
+        size_type after = m_capacity - m_gap_end;
+
+        for (size_type i{0}; i < m_gap_begin; ++i) relocate(m_storage + i, temp + i);
+        for (size_type i{0}; i < after; ++i) relocate(m_storage + m_gap_end + i, temp + new_cap - after + i);
+
+        allocator_type alloc;
+        if (m_storage != nullptr) alloc_traits::deallocate(alloc, m_storage, m_capacity);
+        m_storage = temp;
+        m_gap_end = new_cap - after;
+        m_capacity = new_cap;
+    }
+    /// Makes sure the gap has room for `n` more elements.
+    void reserve_gap(size_type n) {
+        if (m_gap_end - m_gap_begin < n) reallocate(std::max(size() + n, m_capacity + (m_capacity / 2) + 1));
+    }
+    /// Returns the storage slot of the logical position `i`.
+    size_type physical(size_type i) const { return i < m_gap_begin ? i : i + (m_gap_end - m_gap_begin); }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct a new gap vector with `count` value-initialized elements.
+     *
+     * @param count Number of elements.
+     */
+    explicit gap_vector(size_type count = 0)
+        : m_gap_begin{0}, m_gap_end{0}, m_capacity{count}, m_storage{allocate_storage(count)} {
+        allocator_type alloc;
+        for (; m_gap_begin < count; m_gap_begin++) alloc_traits::construct(alloc, m_storage + m_gap_begin);
+        m_gap_end = m_capacity;
+    }
+    /**
+     * @brief Destroy the gap vector object.
+     */
+    ~gap_vector(void) { release_storage(); }
+    /**
+     * @brief Construct a new gap vector identical to `other`, with the gap at the end.
+     *
+     * @param other Another gap vector.
+     */
+    gap_vector(const gap_vector& other) : gap_vector() {
+        reserve(other.size());
+        for (const auto& e : other) push_back(e);
+    }
+    /**
+     * @brief Construct a new gap vector from an initializer list.
+     *
+     * @param il Initializer list to copy.
+     */
+    gap_vector(std::initializer_list<value_type> il) : gap_vector() {
+        reserve(il.size());
+        for (const auto& e : il) push_back(e);
+    }
+    /**
+     * @brief Constructs the container with the contents of the range [first, last).
+     *
+     * @param first Iterator to the beginning of range.
+     * @param last Iterator to the location just past the last valid value of the range.
+     */
+    template <typename InputItr>
+    gap_vector(InputItr first, InputItr last) : gap_vector() {
+        for (; first != last; ++first) push_back(*first);
+    }
+    /**
+     * @brief Implements the operator = that replaces the container's contents.
+     *
+     * @param other Another container to use as data source.
+     * @return The gap vector with its updated content.
+     */
+    gap_vector& operator=(const gap_vector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            for (const auto& e : other) push_back(e);
+        }
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /**
+     * @brief Return iterator to the first element.
+     */
+    iterator begin(void) { return iterator(m_storage, 0, m_gap_begin, m_gap_end - m_gap_begin); }
+    /**
+     * @brief Return iterator to the element following the last element.
+     */
+    iterator end(void) { return iterator(m_storage, size(), m_gap_begin, m_gap_end - m_gap_begin); }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator cbegin(void) const { return const_iterator(m_storage, 0, m_gap_begin, m_gap_end - m_gap_begin); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator cend(void) const {
+        return const_iterator(m_storage, size(), m_gap_begin, m_gap_end - m_gap_begin);
+    }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator begin(void) const { return cbegin(); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator end(void) const { return cend(); }
+
+    //=== [III] Capacity
+    /**
+     * @brief Return size of the gap vector.
+     */
+    size_type size(void) const { return m_capacity - (m_gap_end - m_gap_begin); }
+    /**
+     * @brief Return capacity of the gap vector.
+     */
+    size_type capacity(void) const { return m_capacity; }
+    /**
+     * @brief Checks if the gap vector is empty.
+     */
+    bool empty(void) const { return size() == 0; }
+    /**
+     * @brief Return the cursor, the logical position where the gap currently is.
+     */
+    size_type cursor(void) const { return m_gap_begin; }
+
+    //=== [IV] Modifiers
+    /**
+     * @brief Moves the gap so that it starts at logical position `pos`, in O(|pos - cursor()|).
+     *
+     * @param pos New cursor position, in [0, size()].
+     */
+    void move_cursor(size_type pos) {
+        if (pos > size()) throw std::out_of_range("[gap_vector::move_cursor()]: posição fora do vetor.");
+
+        if (m_gap_begin == m_gap_end) {  // Nothing to cross: the gap just changes place.
+            m_gap_begin = m_gap_end = pos;
+            return;
+        }
+        // Each element crosses the gap once; the slot it lands on is always raw.
+        while (m_gap_begin > pos) relocate(m_storage + --m_gap_begin, m_storage + --m_gap_end);
+        while (m_gap_begin < pos) relocate(m_storage + m_gap_end++, m_storage + m_gap_begin++);
+    }
+    /**
+     * @brief Erases all elements from the list.
+     */
+    void clear(void) {
+        allocator_type alloc;
+        for (size_type i{0}; i < m_capacity; ++i)
+            if (i < m_gap_begin or i >= m_gap_end) alloc_traits::destroy(alloc, m_storage + i);
+        m_gap_begin = 0;
+        m_gap_end = m_capacity;
+    }
+    /**
+     * @brief Inserts `value` at the cursor and advances the cursor past it, in O(1) amortized.
+     *
+     * @param value The value to insert.
+     */
+    void insert_at_cursor(const_reference value) {
+        if (m_gap_begin == m_gap_end) {
+            value_type copy(value);  // `value` may be one of our elements.
+            reserve_gap(1);
+            alloc_insert(std::move(copy));
+        } else {
+            alloc_insert(value);
+        }
+    }
+    /**
+     * @brief Removes the element right after the cursor, in O(1).
+     */
+    void erase_at_cursor(void) {
+        if (m_gap_end == m_capacity)
+            throw std::out_of_range("[gap_vector::erase_at_cursor()]: não há elemento após o cursor.");
+
+        allocator_type alloc;
+        alloc_traits::destroy(alloc, m_storage + m_gap_end++);
+    }
+    /**
+     * @brief Appends the given element value to the end of the container.
+     * @param value the value of the element to append.
+     */
+    void push_back(const_reference value) {
+        if (m_gap_end == m_capacity) {
+            insert_at_cursor(value);  // The gap is already at the end.
+        } else {
+            insert(cend(), value);
+        }
+    }
+    /**
+     * @brief Removes the last element of the container, if it exists.
+     */
+    void pop_back(void) {
+        if (empty())
+            throw std::length_error("[gap_vector::pop_back()]: não é possível remover um elemento de um vetor vazio.");
+
+        erase(cend() - 1);
+    }
+    /**
+     * @brief Inserts element before pos, moving the cursor there first.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param value_ Element to be insert.
+     * @return iterator Iterator pointing to the element inserted.
+     */
+    iterator insert(const_iterator pos_, const_reference value_) {
+        value_type copy(value_);  // Moving the gap may move `value_` if it is one of our elements.
+        move_cursor(pos_.index());
+        reserve_gap(1);
+        alloc_insert(std::move(copy));
+        return begin() + static_cast<std::ptrdiff_t>(pos_.index());
+    }
+    /**
+     * @brief Inserts elements of range [first, last) before pos.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param first_ Iterator to first element to be insert.
+     * @param last_ Iterator to one position after the last element to be insert.
+     * @return iterator Iterator pointing to the first element inserted.
+     */
+    template <typename InputItr>
+    iterator insert(const_iterator pos_, InputItr first_, InputItr last_) {
+        gap_vector temp(first_, last_);  // The range may refer to our own elements.
+        move_cursor(pos_.index());
+        reserve_gap(temp.size());
+        for (auto& e : temp) alloc_insert(std::move(e));
+        return begin() + static_cast<std::ptrdiff_t>(pos_.index());
+    }
+    /**
+     * @brief Inserts elements from initializer list ilist before pos.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param ilist_ Initializer list to insert the values from.
+     * @return Iterator pointing to the first element inserted.
+     */
+    iterator insert(const_iterator pos_, std::initializer_list<value_type> ilist_) {
+        return insert(pos_, ilist_.begin(), ilist_.end());
+    }
+    /**
+     * @brief Erase an element, moving the cursor to its position first.
+     *
+     * @param pos Iterator to element to be erased.
+     * @return iterator Iterator to the element that followed the one erased.
+     */
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    /**
+     * @brief Erase elements in range [first, last).
+     *
+     * @param first Iterator to first element to be erased.
+     * @param last Iterator to one position after the last element to be erased.
+     * @return iterator Iterator to the element that followed the last one erased.
+     */
+    iterator erase(const_iterator first, const_iterator last) {
+        move_cursor(first.index());
+        for (auto n = last - first; n > 0; --n) erase_at_cursor();
+        return begin() + static_cast<std::ptrdiff_t>(first.index());
+    }
+    /**
+     * @brief Increase the capacity to at least `new_cap`; the gap grows by the difference.
+     * @param new_cap new capacity of the gap vector.
+     */
+    void reserve(size_type new_cap) {
+        if (new_cap > m_capacity) reallocate(new_cap);
+    }
+    /**
+     * @brief Requests the removal of unused capacity (the gap).
+     */
+    void shrink_to_fit(void) {
+        if (m_gap_begin != m_gap_end) reallocate(size());
+    }
+
+    //=== [V] Element access
+    /**
+     * @brief Implements the operator [], skipping the gap.
+     */
+    const_reference operator[](size_type position) const { return m_storage[physical(position)]; }
+    /**
+     * @brief Implements the operator [], skipping the gap.
+     */
+    reference operator[](size_type position) { return m_storage[physical(position)]; }
+    /**
+     * @brief Returns element at index `position`.
+     */
+    const_reference at(size_type position) const {
+        if (position >= size()) throw std::out_of_range("[gap_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Returns element at index `position`, for eventual content alteration.
+     */
+    reference at(size_type position) {
+        if (position >= size()) throw std::out_of_range("[gap_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Return the constant first element of the list.
+     */
+    const_reference front(void) const {
+        if (empty()) throw std::length_error("[gap_vector::front()]: vetor vazio.");
+
+        return (*this)[0];
+    }
+    /**
+     * @brief Return the constant last element of the list.
+     */
+    const_reference back(void) const {
+        if (empty()) throw std::length_error("[gap_vector::back()]: vetor vazio.");
+
+        return (*this)[size() - 1];
+    }
+    /**
+     * @brief Returns the element at the beginning of the list.
+     */
+    reference front(void) { return (*this)[0]; }
+    /**
+     * @brief Returns the element at the end of the list.
+     */
+    reference back(void) { return (*this)[size() - 1]; }
+
+    //=== [VI] Conversions
+    /**
+     * @brief Copies the elements into a sc::vector with two block copies, one per side of the gap.
+     *
+     * @return sc::vector<value_type> A vector with the same elements.
+     */
+    sc::vector<value_type> to_vector(void) const {
+        sc::vector<value_type> out;
+        out.reserve(size());
+        const value_type* first = m_storage;
+        out.insert(out.cend(), first, first + m_gap_begin);
+        out.insert(out.cend(), first + m_gap_end, first + m_capacity);
+        return out;
+    }
+
+   private:
+    /// Constructs `value` at the cursor, which must have room, and advances the cursor.
+    template <typename U>
+    void alloc_insert(U&& value) {
+        allocator_type alloc;
+        alloc_traits::construct(alloc, m_storage + m_gap_begin, std::forward<U>(value));
+        ++m_gap_begin;
+    }
+};  // class gap_vector.
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal.
+ * @param lhs gap vector whose content is compared with `rhs`.
+ * @param rhs gap vector whose content is compared with `lhs`.
+ * @return true if the contents of the gap vectors are equal, false otherwise.
+ */
+template <typename T>
+bool operator==(const gap_vector<T>& lhs, const gap_vector<T>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+
+    for (typename gap_vector<T>::size_type i = 0; i < lhs.size(); i++)
+        if (lhs[i] != rhs[i]) return false;
+
+    return true;
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ * @param lhs gap vector whose content is compared with `rhs`.
+ * @param rhs gap vector whose content is compared with `lhs`.
+ * @return true if the contents of the gap vectors are not equal, false otherwise.
+ */
+template <typename T>
+bool operator!=(const gap_vector<T>& lhs, const gap_vector<T>& rhs) {
+    return not(lhs == rhs);
+}
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,334 @@
+#ifndef _PACKED_VECTOR_H_
+#define _PACKED_VECTOR_H_
+
+#include <cstddef>           // std::ptrdiff_t
+#include <cstdint>           // std::uint64_t, std::uint8_t
+#include <initializer_list>  // std::initializer_list
+#include <iterator>          // std::input_iterator_tag
+#include <stdexcept>         // std::out_of_range
+#include <type_traits>       // std::is_integral, std::make_unsigned
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// This class implements a compressed list of integers with random access.
+/*!
+ * The values are grouped in blocks of `block_size`. A full block is sealed with
+ * frame-of-reference encoding: it keeps its minimum (the *base*) and stores each value as
+ * `value - base` in the fewest bits that fit the largest difference. A block of 128 values
+ * of width `w` takes exactly `2 * w` 64-bit words, so sorted IDs with small gaps or small
+ * counters shrink several times.
+ *
+ * Values go to an open *tail* block until it fills up, so push_back() is O(1) amortized.
+ * operator[] finds the block and extracts one value in O(1); the iterator decodes a whole
+ * block at a time with a branch-free loop the compiler can vectorize. The values are read
+ * only: there is no reference to an element, only copies.
+ *
+ * \tparam T An integral type of up to 64 bits.
+ */
+template <typename T>
+class packed_vector {
+    static_assert(std::is_integral<T>::value and sizeof(T) <= sizeof(std::uint64_t), "packed_vector stores integers");
+
+   public:
+    using size_type = unsigned long;  //!< The size type.
+    using value_type = T;             //!< The value type.
+
+    enum : size_type { block_size = 128 };  //!< Number of values in a sealed block.
+
+    class const_iterator;
+    using iterator = const_iterator;  //!< Values are read only.
+
+   private:
+    using unsigned_type = typename std::make_unsigned<T>::type;  //!< For wrap-around differences.
+
+    /// Encoding of a sealed block.
+    struct block_info {
+        T base;              //!< Smallest value of the block.
+        std::uint8_t width;  //!< Bits per value, from 0 to 64.
+        size_type offset;    //!< First word of the block in `m_words`.
+    };
+
+    sc::vector<block_info> m_blocks;    //!< Sealed blocks.
+    sc::vector<std::uint64_t> m_words;  //!< Packed bits of the sealed blocks, plus a trailing zero word.
+    sc::vector<T> m_tail;               //!< Open block, not encoded yet.
+
+    /// Returns the mask of the `width` low bits.
+    static std::uint64_t low_bits(unsigned width) { return width == 0 ? 0 : ~std::uint64_t{0} >> (64 - width); }
+
+    /// Encodes the (full) tail as a new sealed block.
+    void seal_tail(void) {
+        T lo = m_tail[0];
+        T hi = m_tail[0];
+        for (size_type i{1}; i < block_size; ++i) {
+            if (m_tail[i] < lo) lo = m_tail[i];
+            if (m_tail[i] > hi) hi = m_tail[i];
+        }
+        std::uint64_t range = static_cast<unsigned_type>(static_cast<unsigned_type>(hi) - static_cast<unsigned_type>(lo));
+        unsigned width{0};
+        while (width < 64 and (range >> width) != 0) ++width;
+
+        // Drop the trailing zero word, append the block's words, and put the trailing word back.
+        m_words.pop_back();
+        size_type offset = m_words.size();
+        for (size_type i{0}; i < 2 * width + 1; ++i) m_words.push_back(0);
+        for (size_type i{0}; i < block_size; ++i) {
+            std::uint64_t v = static_cast<unsigned_type>(static_cast<unsigned_type>(m_tail[i]) -
+                                                         static_cast<unsigned_type>(lo));
+            size_type bit = i * width;
+            size_type k = offset + bit / 64;
+            unsigned shift = static_cast<unsigned>(bit % 64);
+            m_words[k] |= v << shift;
+            if (shift + width > 64) m_words[k + 1] |= v >> (64 - shift);
+        }
+
+        m_blocks.push_back(block_info{lo, static_cast<std::uint8_t>(width), offset});
+        m_tail.clear();
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty packed vector.
+     */
+    packed_vector(void) : m_blocks{}, m_words{0}, m_tail{} { m_tail.reserve(block_size); }
+    /**
+     * @brief Construct a packed vector with the values of `v`.
+     *
+     * @param v Vector to compress.
+     */
+    template <typename SizeType, typename ShrinkPolicy, typename Storage>
+    explicit packed_vector(const sc::vector<T, SizeType, ShrinkPolicy, Storage>& v) : packed_vector() {
+        m_blocks.reserve(v.size() / block_size);
+        for (auto it = v.cbegin(); it != v.cend(); ++it) push_back(*it);
+        shrink_to_fit();
+    }
+    /**
+     * @brief Construct a packed vector from an initializer list.
+     *
+     * @param il Initializer list to compress.
+     */
+    packed_vector(std::initializer_list<value_type> il) : packed_vector() {
+        for (const auto& e : il) push_back(e);
+    }
+
+    //=== [II] ITERATORS
+    /**
+     * @brief Return iterator to the first value.
+     */
+    const_iterator begin(void) const { return const_iterator(this, 0); }
+    /**
+     * @brief Return iterator to the position following the last value.
+     */
+    const_iterator end(void) const { return const_iterator(this, size()); }
+    /**
+     * @brief Return iterator to the first value.
+     */
+    const_iterator cbegin(void) const { return begin(); }
+    /**
+     * @brief Return iterator to the position following the last value.
+     */
+    const_iterator cend(void) const { return end(); }
+
+    //=== [III] Capacity
+    /**
+     * @brief Return the number of values.
+     */
+    size_type size(void) const { return m_blocks.size() * block_size + m_tail.size(); }
+    /**
+     * @brief Checks if the packed vector is empty.
+     */
+    bool empty(void) const { return size() == 0; }
+    /**
+     * @brief Return the bytes used by the encoded values, block descriptors and open block.
+     */
+    size_type memory_bytes(void) const {
+        return m_words.capacity() * sizeof(std::uint64_t) + m_blocks.capacity() * sizeof(block_info) +
+               m_tail.capacity() * sizeof(T);
+    }
+
+    //=== [IV] Modifiers
+    /**
+     * @brief Appends a value, sealing the open block when it becomes full.
+     * @param value the value to append.
+     */
+    void push_back(value_type value) {
+        m_tail.push_back(value);
+        if (m_tail.size() == block_size) seal_tail();
+    }
+    /**
+     * @brief Releases the unused capacity of the encoded blocks.
+     */
+    void shrink_to_fit(void) {
+        m_words.shrink_to_fit();
+        m_blocks.shrink_to_fit();
+    }
+    /**
+     * @brief Erases all values.
+     */
+    void clear(void) {
+        m_blocks.clear();
+        m_words.clear();
+        m_words.push_back(0);
+        m_tail.clear();
+    }
+
+    //=== [V] Element access
+    /**
+     * @brief Returns the value at index `position`, in O(1).
+     */
+    value_type operator[](size_type position) const {
+        size_type b = position / block_size;
+        if (b == m_blocks.size()) return m_tail[position % block_size];
+
+        const block_info& info = m_blocks[b];
+        size_type bit = (position % block_size) * info.width;
+        const std::uint64_t* w = m_words.cbegin().base() + info.offset + bit / 64;
+        unsigned shift = static_cast<unsigned>(bit % 64);
+        std::uint64_t v = w[0] >> shift;
+        if (shift + info.width > 64) v |= w[1] << (64 - shift);
+
+        return static_cast<T>(static_cast<unsigned_type>(static_cast<unsigned_type>(info.base) +
+                                                         static_cast<unsigned_type>(v & low_bits(info.width))));
+    }
+    /**
+     * @brief Returns the value at index `position`, checking the bounds.
+     */
+    value_type at(size_type position) const {
+        if (position >= size())
+            throw std::out_of_range("[packed_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Decodes the sealed block `b` into `out[0, block_size)`.
+     *
+     * The loop has no branches and no dependency between iterations; each value is read
+     * from two adjacent words (the trailing zero word keeps the last read in bounds).
+     */
+    void decode_block(size_type b, value_type* out) const {
+        const block_info& info = m_blocks[b];
+        const unsigned width = info.width;
+        const unsigned_type base = static_cast<unsigned_type>(info.base);
+
+        if (width == 0) {
+            for (size_type i{0}; i < block_size; ++i) out[i] = info.base;
+            return;
+        }
+        const std::uint64_t* w = m_words.cbegin().base() + info.offset;
+        const std::uint64_t mask = low_bits(width);
+        for (unsigned i{0}; i < block_size; ++i) {
+            unsigned bit = i * width;
+            unsigned k = bit >> 6;
+            unsigned shift = bit & 63;
+            std::uint64_t v = ((w[k] >> shift) | ((w[k + 1] << 1) << (63 - shift))) & mask;
+            out[i] = static_cast<T>(static_cast<unsigned_type>(base + static_cast<unsigned_type>(v)));
+        }
+    }
+    /**
+     * @brief Returns the number of sealed blocks.
+     */
+    size_type sealed_blocks(void) const { return m_blocks.size(); }
+
+    //=== [VI] Conversions
+    /**
+     * @brief Decodes all values into a sc::vector, a block at a time.
+     */
+    sc::vector<T> to_vector(void) const {
+        sc::vector<T> out;
+        out.reserve(size());
+        value_type buffer[block_size];
+        for (size_type b{0}; b < m_blocks.size(); ++b) {
+            decode_block(b, buffer);
+            out.insert(out.cend(), buffer + 0, buffer + block_size);
+        }
+        out.insert(out.cend(), m_tail.cbegin(), m_tail.cend());
+        return out;
+    }
+
+    /// Input iterator that decodes one block at a time into a buffer of its own.
+    class const_iterator {
+       public:
+        typedef std::ptrdiff_t difference_type;             //!< Distance between iterators.
+        typedef T value_type;                               //!< Value type the iterator yields.
+        typedef const T* pointer;                           //!< Pointer to the value type.
+        typedef T reference;                                //!< Values are returned by copy.
+        typedef std::input_iterator_tag iterator_category;  //!< Iterator category.
+
+       private:
+        const packed_vector* m_owner;    //!< Container being read.
+        size_type m_index;               //!< Position of the iterator.
+        mutable size_type m_block;       //!< Block held in `m_buffer`, or `npos`.
+        mutable T m_buffer[block_size];  //!< Decoded values of `m_block`.
+
+        static constexpr size_type npos(void) { return ~size_type{0}; }
+
+       public:
+        /**
+         * @brief Construct an iterator at position `index` of `owner`.
+         */
+        const_iterator(const packed_vector* owner = nullptr, size_type index = 0)
+            : m_owner{owner}, m_index{index}, m_block{npos()} {}
+        /**
+         * @brief The unary indirection operator, which decodes the current block on first use.
+         */
+        reference operator*() const {
+            size_type b = m_index / block_size;
+            if (b == m_owner->m_blocks.size()) return m_owner->m_tail[m_index % block_size];
+            if (b != m_block) {
+                m_owner->decode_block(b, m_buffer);
+                m_block = b;
+            }
+            return m_buffer[m_index % block_size];
+        }
+        /**
+         * @brief The operator prefix increment.
+         */
+        const_iterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        /**
+         * @brief The operator postfix increment.
+         */
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++(*this);
+            return it;
+        }
+        /**
+         * @brief The equality operator.
+         */
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        /**
+         * @brief The inequality operator.
+         */
+        bool operator!=(const const_iterator& other) const { return not(*this == other); }
+    };
+};  // class packed_vector.
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal.
+ */
+template <typename T>
+bool operator==(const packed_vector<T>& lhs, const packed_vector<T>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+
+    auto l = lhs.begin();
+    for (auto r = rhs.begin(); r != rhs.end(); ++l, ++r)
+        if (*l != *r) return false;
+
+    return true;
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ */
+template <typename T>
+bool operator!=(const packed_vector<T>& lhs, const packed_vector<T>& rhs) {
+    return not(lhs == rhs);
+}
+
+}  // namespace sc.
+#endif
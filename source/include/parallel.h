@@ -0,0 +1,92 @@
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uintptr_t
+#include <exception>  // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <thread>     // std::thread
+#include <vector>     // std::vector (of threads)
+
+// Included by vector.h.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Selects the multi-threaded overload of a member of sc::vector.
+/*!
+ * Pass `sc::parallel` for as many threads as the hardware offers, or `sc::parallel_t{n}`
+ * for at most `n`. The parallel paths only pay off for large vectors; smaller ones are
+ * handled by the calling thread alone.
+ */
+struct parallel_t {
+    unsigned threads;  //!< Maximum number of threads; 0 uses std::thread::hardware_concurrency().
+
+    /// Allows up to `n` threads.
+    constexpr explicit parallel_t(unsigned n = 0) : threads{n} {}
+};
+
+/// Runs the parallel overloads on every hardware thread.
+constexpr parallel_t parallel{};
+
+/// Implementation details.
+namespace detail {
+
+/// Runs `f(k)` for k in [0, threads) on as many threads, rethrowing the first exception.
+template <typename F>
+void run_on_threads(unsigned threads, F f) {
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    try {
+        for (unsigned k{0}; k < threads; ++k) {
+            workers.emplace_back([&, k]() {
+                try {
+                    f(k);
+                } catch (...) {
+                    errors[k] = std::current_exception();
+                }
+            });
+        }
+    } catch (...) {
+        // A thread could not be started: wait for the others before leaving.
+        for (auto& w : workers) w.join();
+        throw;
+    }
+    for (auto& w : workers) w.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+}
+
+/// Calls `f(first, last)` on slices of [0, n) covering the `n` slots at `data`, one slice per thread.
+/*!
+ * The slices start on page boundaries, so each page of a fresh storage area is touched
+ * first by a single thread, and a first-touch NUMA policy places it on that thread's node.
+ * Ranges of less than `min_bytes` per thread use fewer threads, down to just the caller.
+ */
+template <typename T, typename F>
+void for_each_slice(T* data, std::size_t n, parallel_t policy, F f) {
+    const std::size_t min_bytes = std::size_t{1} << 20;  // Below this, a thread costs more than it saves.
+    const std::uintptr_t page = 4096;
+
+    unsigned threads = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+    if (threads > n / (min_bytes / sizeof(T) + 1)) threads = static_cast<unsigned>(n / (min_bytes / sizeof(T) + 1));
+    if (threads <= 1) {
+        f(std::size_t{0}, n);
+        return;
+    }
+
+    // Slice k is [bounds[k], bounds[k + 1]); inner bounds move forward to the first element of a page.
+    std::vector<std::size_t> bounds(threads + 1, n);
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(data);
+    bounds[0] = 0;
+    for (unsigned k{1}; k < threads; ++k) {
+        std::uintptr_t target = base + n / threads * k * sizeof(T);
+        std::uintptr_t aligned = (target + page - 1) / page * page;
+        std::size_t index = static_cast<std::size_t>((aligned - base + sizeof(T) - 1) / sizeof(T));
+        bounds[k] = index < n ? index : n;
+    }
+    run_on_threads(threads, [&](unsigned k) { f(bounds[k], bounds[k + 1]); });
+}
+
+}  // namespace detail.
+}  // namespace sc.
+#endif
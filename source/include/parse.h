@@ -0,0 +1,289 @@
+#ifndef _PARSE_H_
+#define _PARSE_H_
+
+#include <cerrno>        // errno, ERANGE
+#include <cstddef>       // std::size_t
+#include <clocale>       // LC_ALL (the "C" locale of the pre-C++17 float parser)
+#include <cstdlib>       // strtod_l, strtof_l, strtold_l
+#include <exception>     // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <limits>        // std::numeric_limits
+#include <stdexcept>     // std::invalid_argument, std::out_of_range
+#include <string>        // std::to_string
+#include <thread>        // std::thread
+#include <type_traits>   // std::is_arithmetic, std::is_integral, std::is_same, std::is_signed
+#include <vector>        // std::vector (of threads)
+#if __cplusplus >= 201703L
+#include <charconv>      // std::from_chars (used when __cpp_lib_to_chars is defined)
+#endif
+#if not defined(_WIN32)
+#include <locale.h>      // newlocale, locale_t
+#endif
+#if defined(__APPLE__)
+#include <xlocale.h>     // strtod_l and friends
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>   // _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Checks whether `c` ends a token: the delimiter or ASCII whitespace.
+inline bool is_separator(char c, char delim) {
+    return c == delim or c == ' ' or c == '\n' or c == '\r' or c == '\t';
+}
+
+/// Number of bits set in a 16-bit mask.
+inline unsigned popcount16(unsigned mask) {
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+    unsigned n{0};
+    for (; mask != 0; mask &= mask - 1) ++n;
+    return n;
+#endif
+}
+
+/**
+ * @brief Counts the tokens (maximal runs of non-separators) in [first, last).
+ *
+ * With SSE2 the separators of 16 bytes are found at once and a token start is a
+ * non-separator whose previous byte is a separator, so the count is exact.
+ */
+inline std::size_t count_tokens(const char* first, const char* last, char delim) {
+    std::size_t count{0};
+    unsigned prev_sep{1};  // The byte before `first` counts as a separator.
+
+#if defined(__SSE2__)
+    const __m128i d = _mm_set1_epi8(delim);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i tab = _mm_set1_epi8('\t');
+    for (; last - first >= 16; first += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, d), _mm_cmpeq_epi8(x, space)),
+                                 _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, nl), _mm_cmpeq_epi8(x, cr)),
+                                              _mm_cmpeq_epi8(x, tab)));
+        unsigned sep = static_cast<unsigned>(_mm_movemask_epi8(m));
+        count += popcount16(~sep & ((sep << 1) | prev_sep) & 0xFFFFu);
+        prev_sep = sep >> 15;
+    }
+#endif
+    for (; first != last; ++first) {
+        unsigned sep = is_separator(*first, delim) ? 1 : 0;
+        if (not sep and prev_sep) ++count;
+        prev_sep = sep;
+    }
+    return count;
+}
+
+/// Throws the error of a token that could not be parsed.
+[[noreturn]] inline void parse_error(std::size_t offset, bool range) {
+    if (range)
+        throw std::out_of_range("[parse_into()]: valor fora do intervalo na posição " + std::to_string(offset) + ".");
+    throw std::invalid_argument("[parse_into()]: valor inválido na posição " + std::to_string(offset) + ".");
+}
+
+#if defined(__cpp_lib_to_chars)
+/**
+ * @brief Parses a value at the start of [first, last) with std::from_chars (locale-free).
+ *
+ * @return const char* Past the last character read, or `nullptr` when there is no value.
+ */
+template <typename T>
+const char* parse_value(const char* first, const char* last, T& value, bool& range) {
+    if (last - first > 1 and *first == '+' and first[1] != '-') ++first;  // from_chars rejects a plus sign.
+    std::from_chars_result r = std::from_chars(first, last, value);
+    range = r.ec == std::errc::result_out_of_range;
+    return r.ec == std::errc() ? r.ptr : nullptr;
+}
+#else
+/// Parses an integer without locale, detecting overflow.
+template <typename T>
+const char* parse_number(const char* first, const char* last, T& value, bool& range, std::true_type) {
+    bool negative = false;
+    if (first != last and (*first == '+' or (std::is_signed<T>::value and *first == '-'))) negative = *first++ == '-';
+
+    // The magnitude of min() is max() + 1 for signed types.
+    using U = typename std::make_unsigned<T>::type;
+    const U limit = static_cast<U>(static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0));
+    U acc{0};
+    const char* p = first;
+    range = false;
+    for (; p != last and *p >= '0' and *p <= '9'; ++p) {
+        U digit = static_cast<U>(*p - '0');
+        if (acc > (limit - digit) / 10) range = true;
+        acc = static_cast<U>(acc * 10 + digit);
+    }
+    if (p == first or range) return nullptr;
+    value = negative ? static_cast<T>(U(0) - acc) : static_cast<T>(acc);
+    return p;
+}
+#if defined(_WIN32)
+/// The "C" locale, created once: plain strtod would follow the global locale's decimal point.
+inline _locale_t c_numeric_locale(void) {
+    static const _locale_t locale = _create_locale(LC_ALL, "C");
+    return locale;
+}
+/// Converts a null-terminated token with the strtod family, in the "C" locale.
+inline void to_floating(const char* s, char** end, float& v) { v = _strtof_l(s, end, c_numeric_locale()); }
+inline void to_floating(const char* s, char** end, double& v) { v = _strtod_l(s, end, c_numeric_locale()); }
+inline void to_floating(const char* s, char** end, long double& v) { v = _strtold_l(s, end, c_numeric_locale()); }
+#else
+/// The "C" locale, created once: plain strtod would follow the global locale's decimal point.
+inline locale_t c_numeric_locale(void) {
+    static const locale_t locale = newlocale(LC_ALL_MASK, "C", static_cast<locale_t>(0));
+    return locale;
+}
+/// Converts a null-terminated token with the strtod family, in the "C" locale.
+inline void to_floating(const char* s, char** end, float& v) { v = strtof_l(s, end, c_numeric_locale()); }
+inline void to_floating(const char* s, char** end, double& v) { v = strtod_l(s, end, c_numeric_locale()); }
+inline void to_floating(const char* s, char** end, long double& v) { v = strtold_l(s, end, c_numeric_locale()); }
+#endif
+/// Parses a floating-point number; the text is copied so strtod never reads past `last`.
+template <typename T>
+const char* parse_number(const char* first, const char* last, T& value, bool& range, std::false_type) {
+    char buffer[128];  // Longer numbers are cut and then rejected by the caller.
+    std::size_t n{0};
+    for (const char* p = first; p != last and n + 1 < sizeof buffer; ++p) buffer[n++] = *p;
+    buffer[n] = '\0';
+
+    char* end = nullptr;
+    errno = 0;
+    to_floating(buffer, &end, value);
+    range = errno == ERANGE;
+    if (end == buffer or range) return nullptr;
+    return first + (end - buffer);
+}
+/**
+ * @brief Parses a value at the start of [first, last) without std::from_chars (pre-C++17).
+ *
+ * @return const char* Past the last character read, or `nullptr` when there is no value.
+ */
+template <typename T>
+const char* parse_value(const char* first, const char* last, T& value, bool& range) {
+    return parse_number(first, last, value, range, std::is_integral<T>());
+}
+#endif
+
+/**
+ * @brief Appends the values of [first, last) to `vec`, which must already have room for them.
+ *
+ * @param offset Position of `first` in the whole input, for error messages.
+ * @return size_type How many values were appended.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+typename vector<T, SizeType>::size_type parse_range(vector<T, SizeType, ShrinkPolicy, Storage>& vec, const char* first,
+                                                    const char* last, char delim, std::size_t offset) {
+    auto before = vec.size();
+    const char* p = first;
+    for (;;) {
+        while (p != last and is_separator(*p, delim)) ++p;
+        if (p == last) break;
+
+        T value{};
+        bool range{false};
+        const char* end = parse_value(p, last, value, range);
+        if (end == nullptr or (end != last and not is_separator(*end, delim)))
+            parse_error(offset + static_cast<std::size_t>(p - first), range);
+
+        vec.push_back(value);
+        p = end;
+    }
+    return vec.size() - before;
+}
+
+}  // namespace detail.
+
+/**
+ * @brief Parses the numbers of the text [first, last) and appends them to `vec`.
+ *
+ * The numbers are separated by `delim` and/or ASCII whitespace; runs of separators are
+ * skipped. The text is parsed with std::from_chars when available (C++17), else with the
+ * strtod family in the "C" locale, so it never depends on the global locale. A first pass counts the tokens so the vector grows at most once.
+ *
+ * @param vec Vector that receives the values.
+ * @param first First character of the text.
+ * @param last Past the last character of the text.
+ * @param delim Separator besides whitespace, e.g. `','`.
+ * @return size_type How many values were appended.
+ * @throw std::invalid_argument When a token is not a number; std::out_of_range when it does not fit `T`.
+ *        The values before the bad token remain in `vec`.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+typename vector<T, SizeType>::size_type parse_into(vector<T, SizeType, ShrinkPolicy, Storage>& vec, const char* first,
+                                                   const char* last, char delim = ' ') {
+    static_assert(std::is_arithmetic<T>::value and not std::is_same<T, bool>::value, "parse_into() reads numbers");
+
+    vec.reserve(vec.size() + detail::count_tokens(first, last, delim));
+    return detail::parse_range(vec, first, last, delim, 0);
+}
+
+/**
+ * @brief Parses the numbers of the text [first, last) with up to `threads` threads.
+ *
+ * The text is cut at separators into one chunk per thread; each thread counts and
+ * parses its chunk into a vector of its own, and the pieces are then appended to `vec`
+ * in order. Inputs too small to pay for the threads are parsed sequentially.
+ *
+ * @param threads Maximum number of threads; 0 uses std::thread::hardware_concurrency().
+ * @return size_type How many values were appended.
+ * @throw std::invalid_argument, std::out_of_range As the sequential version, for the first bad chunk;
+ *        `vec` is then left unchanged.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+typename vector<T, SizeType>::size_type parse_into(vector<T, SizeType, ShrinkPolicy, Storage>& vec, const char* first,
+                                                   const char* last, char delim, unsigned threads) {
+    static_assert(std::is_arithmetic<T>::value and not std::is_same<T, bool>::value, "parse_into() reads numbers");
+    const std::size_t min_chunk = 1 << 16;  // Below this, starting a thread costs more than parsing.
+
+    std::size_t len = static_cast<std::size_t>(last - first);
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads > len / min_chunk) threads = static_cast<unsigned>(len / min_chunk);
+    if (threads <= 1) return parse_into(vec, first, last, delim);
+
+    // Chunk k is [bounds[k], bounds[k + 1]); each bound is moved forward to a separator.
+    sc::vector<const char*> bounds;
+    bounds.push_back(first);
+    for (unsigned k{1}; k < threads; ++k) {
+        const char* b = first + len / threads * k;
+        if (b < bounds.back()) b = bounds.back();
+        while (b != last and not detail::is_separator(*b, delim)) ++b;
+        bounds.push_back(b);
+    }
+    bounds.push_back(last);
+
+    sc::vector<vector<T, SizeType>> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (unsigned k{0}; k < threads; ++k) {
+        workers.emplace_back([&, k]() {
+            try {
+                parts[k].reserve(detail::count_tokens(bounds[k], bounds[k + 1], delim));
+                detail::parse_range(parts[k], bounds[k], bounds[k + 1], delim,
+                                    static_cast<std::size_t>(bounds[k] - first));
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    for (auto& e : errors)
+        if (e) std::rethrow_exception(e);
+
+    auto before = vec.size();
+    typename vector<T, SizeType>::size_type total{0};
+    for (unsigned k{0}; k < threads; ++k) total += parts[k].size();
+    vec.reserve(before + total);
+    for (unsigned k{0}; k < threads; ++k) vec.insert(vec.cend(), parts[k].cbegin(), parts[k].cend());
+    return total;
+}
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,676 @@
+#ifndef _PERSISTENT_VECTOR_H_
+#define _PERSISTENT_VECTOR_H_
+
+#include <atomic>            // std::atomic
+#include <initializer_list>  // std::initializer_list
+#include <iterator>          // std::distance, std::bidirectional_iterator_tag
+#include <memory>            // std::shared_ptr, std::make_shared
+#include <stdexcept>         // std::out_of_range, std::length_error
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implements an immutable vector whose versions share their unchanged parts.
+/*!
+ * sc::persistent_vector is a relaxed radix-balanced tree (RRB-tree) with 32-way nodes.
+ * Every "modifier" (push_back(), set(), concat(), slice()) leaves the object untouched and
+ * returns a new version in O(log n), copying only the nodes on the path that changed.
+ * Keeping every historical version of a list therefore costs O(log n) per version instead
+ * of a full copy.
+ *
+ * Nodes built by appends are *regular*: all children but the last are full, so an index is
+ * resolved with shifts and masks. Concatenation and slicing may leave partially filled
+ * children; those nodes are *relaxed* and keep a table with the cumulative size of their
+ * children. Concatenation only repacks the nodes along the seam of the two trees.
+ *
+ * For bulk loads, transient() returns a mutable builder that edits the nodes it owns in place.
+ *
+ * \tparam T The type of the elements.
+ */
+template <typename T>
+class persistent_vector {
+   public:
+    using size_type = unsigned long;           //!< The size type.
+    using value_type = T;                      //!< The value type.
+    using const_reference = const T&;          //!< Const reference to a value stored in the container.
+    using const_pointer = const T*;            //!< Pointer to a value stored in the container.
+    class const_iterator;                      // Read-only iterator.
+    class transient_type;                      // Mutable builder.
+
+   private:
+    /// Tree geometry.
+    enum : unsigned { bits = 5, branching = 1u << bits, mask = branching - 1 };
+
+    struct node;
+    using node_ptr = std::shared_ptr<node>;  //!< Nodes are shared among versions.
+
+    /// A tree node; leaves use `values`, inner nodes use `children`.
+    struct node {
+        sc::vector<value_type> values;  //!< Leaf payload.
+        sc::vector<node_ptr> children;  //!< Inner node children.
+        sc::vector<size_type> sizes;    //!< Cumulative children sizes; empty when the node is regular.
+        size_type count{0};             //!< Number of elements in the subtree.
+        unsigned long owner{0};         //!< Transient allowed to edit the node in place (0 means none).
+    };
+
+    node_ptr m_root;      //!< Root of the tree (null when empty).
+    unsigned m_height{0};  //!< Height of the root; leaves have height 0.
+
+    //=== Tree helpers.
+    /// Returns a new identifier for a transient; identifiers are never reused.
+    static unsigned long next_owner(void) {
+        static std::atomic<unsigned long> counter{0};
+        return ++counter;
+    }
+    /// Creates an empty node owned by `owner`.
+    static node_ptr make_node(unsigned long owner) {
+        node_ptr n = std::make_shared<node>();
+        n->owner = owner;
+        return n;
+    }
+    /// Makes `n` safe to modify: nodes not owned by `owner` are copied first (path copying).
+    static node* editable(node_ptr& n, unsigned long owner) {
+        if (owner == 0 or n->owner != owner) {
+            n = std::make_shared<node>(*n);
+            n->owner = owner;
+        }
+        return n.get();
+    }
+    /// Recomputes the element count of `n` and whether it needs a size table.
+    static void refresh(node* n, unsigned h) {
+        if (h == 0) {
+            n->count = n->values.size();
+            return;
+        }
+        const size_type full = size_type(1) << (bits * h);  // Capacity of a child.
+        bool regular = true;
+        size_type total{0};
+        for (size_type j{0}; j < n->children.size(); ++j) {
+            if (j + 1 < n->children.size() and n->children[j]->count != full) regular = false;
+            total += n->children[j]->count;
+        }
+        n->count = total;
+
+        n->sizes.clear();
+        if (not regular) {
+            total = 0;
+            for (size_type j{0}; j < n->children.size(); ++j) n->sizes.push_back(total += n->children[j]->count);
+        }
+    }
+    /// Builds an inner node of height `h` with the given children.
+    static node_ptr make_inner(const node_ptr* first, const node_ptr* last, unsigned h) {
+        node_ptr n = make_node(0);
+        n->children.reserve(last - first);
+        for (; first != last; ++first) n->children.push_back(*first);
+        refresh(n.get(), h);
+        return n;
+    }
+    /**
+     * @brief Finds the child of `n` (height `h` > 0) that holds index `i`.
+     *
+     * @param i Index inside `n`; on return, the index inside the selected child.
+     * @return size_type Position of the child.
+     */
+    static size_type locate(const node* n, unsigned h, size_type& i) {
+        const unsigned shift = bits * h;
+        size_type idx = i >> shift;
+        if (n->sizes.empty()) {
+            i -= idx << shift;
+        } else {
+            // The radix guess is a lower bound: a child never holds more than 2^shift elements.
+            while (n->sizes[idx] <= i) ++idx;
+            if (idx > 0) i -= n->sizes[idx - 1];
+        }
+        return idx;
+    }
+    /// Returns the leaf that holds index `i`, which becomes the index inside that leaf.
+    const node* leaf_for(size_type& i) const {
+        const node* n = m_root.get();
+        for (unsigned h = m_height; h > 0; --h) n = n->children[locate(n, h, i)].get();
+        return n;
+    }
+    /// Checks whether the rightmost path of `n` can take one more element.
+    static bool has_room(const node* n, unsigned h) {
+        if (h == 0) return n->values.size() < branching;
+        return n->children.size() < branching or has_room(n->children.back().get(), h - 1);
+    }
+    /// Creates a path of height `h` down to a leaf holding `value`.
+    static node_ptr new_path(unsigned h, const_reference value, unsigned long owner) {
+        node_ptr n = make_node(owner);
+        if (h == 0) {
+            n->values.reserve(branching);
+            n->values.push_back(value);
+        } else {
+            n->children.push_back(new_path(h - 1, value, owner));
+        }
+        refresh(n.get(), h);
+        return n;
+    }
+    /// Appends `value` to the rightmost path of `n`, which must have room for it.
+    static void push_tail(node_ptr& n, unsigned h, const_reference value, unsigned long owner) {
+        node* e = editable(n, owner);
+        if (h == 0) {
+            e->values.push_back(value);
+        } else if (has_room(e->children.back().get(), h - 1)) {
+            push_tail(e->children.back(), h - 1, value, owner);
+        } else {
+            e->children.push_back(new_path(h - 1, value, owner));
+        }
+        refresh(e, h);
+    }
+    /// Appends `value`, editing in place the nodes owned by `owner`.
+    void append(const_reference value, unsigned long owner) {
+        if (not m_root) {
+            m_root = new_path(0, value, owner);
+            m_height = 0;
+        } else if (has_room(m_root.get(), m_height)) {
+            push_tail(m_root, m_height, value, owner);
+        } else {
+            node_ptr root = make_node(owner);
+            root->children.push_back(m_root);
+            root->children.push_back(new_path(m_height, value, owner));
+            m_root = root;
+            refresh(root.get(), ++m_height);
+        }
+    }
+    /// Replaces the element at index `i` of `n`, copying the path unless `owner` owns it.
+    static void assign_at(node_ptr& n, unsigned h, size_type i, const_reference value, unsigned long owner) {
+        node* e = editable(n, owner);
+        if (h == 0) {
+            e->values[i] = value;
+            return;
+        }
+        size_type idx = locate(e, h, i);
+        assign_at(e->children[idx], h - 1, i, value, owner);
+    }
+    /// Returns a tree with the first `count` elements of `n` (0 < count).
+    static node_ptr take(const node_ptr& n, unsigned h, size_type count) {
+        if (count == n->count) return n;
+
+        node_ptr e = make_node(0);
+        if (h == 0) {
+            e->values.assign(n->values.cbegin(), n->values.cbegin() + count);
+        } else {
+            size_type i = count - 1;
+            size_type idx = locate(n.get(), h, i);
+            e->children.assign(n->children.cbegin(), n->children.cbegin() + idx);
+            e->children.push_back(take(n->children[idx], h - 1, i + 1));
+        }
+        refresh(e.get(), h);
+        return e;
+    }
+    /// Returns a tree without the first `count` elements of `n` (count < size).
+    static node_ptr drop(const node_ptr& n, unsigned h, size_type count) {
+        if (count == 0) return n;
+
+        node_ptr e = make_node(0);
+        if (h == 0) {
+            e->values.assign(n->values.cbegin() + count, n->values.cend());
+        } else {
+            size_type idx = locate(n.get(), h, count);
+            e->children.push_back(drop(n->children[idx], h - 1, count));
+            e->children.insert(e->children.end(), n->children.cbegin() + idx + 1, n->children.cend());
+        }
+        refresh(e.get(), h);
+        return e;
+    }
+    /// Wraps `n` in single-child nodes until it reaches height `target`.
+    static node_ptr raise(node_ptr n, unsigned h, unsigned target) {
+        for (; h < target; ++h) n = make_inner(&n, &n + 1, h + 1);
+        return n;
+    }
+    /**
+     * @brief Concatenates two trees of the same height `h`, repacking only along the seam.
+     *
+     * @return sc::vector<node_ptr> One node, or two nodes when the result overflows a node.
+     */
+    static sc::vector<node_ptr> merge(const node_ptr& a, const node_ptr& b, unsigned h) {
+        sc::vector<node_ptr> result;
+        if (h == 0) {
+            if (a->count + b->count <= branching) {
+                node_ptr leaf = make_node(0);
+                leaf->values.reserve(branching);
+                leaf->values.assign(a->values.cbegin(), a->values.cend());
+                leaf->values.insert(leaf->values.end(), b->values.cbegin(), b->values.cend());
+                refresh(leaf.get(), 0);
+                result.push_back(leaf);
+            } else if (a->count == branching) {
+                result.push_back(a);
+                result.push_back(b);
+            } else {
+                // Fill the left leaf so the result stays left-packed.
+                auto split = b->values.cbegin() + (branching - a->count);
+                node_ptr left = make_node(0), right = make_node(0);
+                left->values.assign(a->values.cbegin(), a->values.cend());
+                left->values.insert(left->values.end(), b->values.cbegin(), split);
+                right->values.assign(split, b->values.cend());
+                refresh(left.get(), 0);
+                refresh(right.get(), 0);
+                result.push_back(left);
+                result.push_back(right);
+            }
+            return result;
+        }
+
+        sc::vector<node_ptr> seam = merge(a->children.back(), b->children[0], h - 1);
+        sc::vector<node_ptr> all;
+        all.reserve(a->children.size() + b->children.size() + 1);
+        all.assign(a->children.cbegin(), a->children.cend() - 1);
+        all.insert(all.end(), seam.cbegin(), seam.cend());
+        all.insert(all.end(), b->children.cbegin() + 1, b->children.cend());
+
+        const node_ptr* first = all.data();
+        if (all.size() <= branching) {
+            result.push_back(make_inner(first, first + all.size(), h));
+        } else {
+            result.push_back(make_inner(first, first + branching, h));
+            result.push_back(make_inner(first + branching, first + all.size(), h));
+        }
+        return result;
+    }
+    /// Removes single-child roots left behind by slicing.
+    void normalize(void) {
+        if (m_root and m_root->count == 0) m_root.reset();
+        if (not m_root) m_height = 0;
+        while (m_height > 0 and m_root->children.size() == 1) {
+            m_root = m_root->children[0];
+            --m_height;
+        }
+    }
+    /// Builds a regular tree holding the `n` elements starting at `first`.
+    template <typename InputItr>
+    void build(InputItr first, size_type n) {
+        if (n == 0) return;
+
+        sc::vector<node_ptr> level;
+        level.reserve((n + mask) / branching);
+        for (size_type i{0}; i < n; i += branching) {
+            node_ptr leaf = make_node(0);
+            size_type len = std::min<size_type>(branching, n - i);
+            leaf->values.reserve(len);
+            for (size_type j{0}; j < len; ++j, ++first) leaf->values.push_back(*first);
+            refresh(leaf.get(), 0);
+            level.push_back(leaf);
+        }
+
+        unsigned h = 0;
+        while (level.size() > 1) {
+            sc::vector<node_ptr> parents;
+            parents.reserve((level.size() + mask) / branching);
+            const node_ptr* nodes = level.data();
+            for (size_type i{0}; i < level.size(); i += branching)
+                parents.push_back(make_inner(nodes + i, nodes + std::min<size_type>(i + branching, level.size()), h + 1));
+            swap(level, parents);
+            ++h;
+        }
+        m_root = level[0];
+        m_height = h;
+    }
+    /// Appends every element of `n` to `out`, in order.
+    static void collect(const node* n, unsigned h, sc::vector<value_type>& out) {
+        if (h == 0) {
+            for (size_type i{0}; i < n->values.size(); ++i) out.push_back(n->values[i]);
+            return;
+        }
+        for (size_type i{0}; i < n->children.size(); ++i) collect(n->children[i].get(), h - 1, out);
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty persistent vector.
+     */
+    persistent_vector(void) = default;
+    /**
+     * @brief Construct a persistent vector with the contents of a sc::vector in O(n).
+     *
+     * @param other The vector to copy.
+     */
+    explicit persistent_vector(const sc::vector<value_type>& other) { build(other.cbegin(), other.size()); }
+    /**
+     * @brief Construct a persistent vector with the contents of an initializer list.
+     *
+     * @param il Initializer list to copy.
+     */
+    persistent_vector(std::initializer_list<value_type> il) { build(il.begin(), il.size()); }
+    /**
+     * @brief Constructs the container with the contents of the range [first, last).
+     *
+     * @param first Iterator to the beginning of range.
+     * @param last Iterator to the location just past the last valid value of the range.
+     */
+    template <typename InputItr>
+    persistent_vector(InputItr first, InputItr last) {
+        build(first, static_cast<size_type>(std::distance(first, last)));
+    }
+
+    //=== [II] ITERATORS
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator begin(void) const { return const_iterator(this, 0); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator end(void) const { return const_iterator(this, size()); }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator cbegin(void) const { return begin(); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator cend(void) const { return end(); }
+
+    //=== [III] Capacity
+    /**
+     * @brief Return size of the vector.
+     */
+    size_type size(void) const { return m_root ? m_root->count : 0; }
+    /**
+     * @brief Checks if the vector is empty.
+     */
+    bool empty(void) const { return size() == 0; }
+
+    //=== [IV] Versioning modifiers (each returns a new version)
+    /**
+     * @brief Returns a new version with `value` appended.
+     *
+     * @param value The value of the element to append.
+     * @return persistent_vector The new version; `*this` is unchanged.
+     */
+    persistent_vector push_back(const_reference value) const {
+        persistent_vector result(*this);
+        result.append(value, 0);
+        return result;
+    }
+    /**
+     * @brief Returns a new version without the last element.
+     *
+     * @return persistent_vector The new version; `*this` is unchanged.
+     */
+    persistent_vector pop_back(void) const {
+        if (empty())
+            throw std::length_error(
+                "[persistent_vector::pop_back()]: não é possível remover um elemento de um vetor vazio.");
+
+        return slice(0, size() - 1);
+    }
+    /**
+     * @brief Returns a new version with the element at `position` replaced by `value`.
+     *
+     * @param position Index of the element to replace.
+     * @param value The new value.
+     * @return persistent_vector The new version; `*this` is unchanged.
+     */
+    persistent_vector set(size_type position, const_reference value) const {
+        if (position >= size())
+            throw std::out_of_range("[persistent_vector::set()]: tentativa de escrita fora do vetor.");
+
+        persistent_vector result(*this);
+        assign_at(result.m_root, result.m_height, position, value, 0);
+        return result;
+    }
+    /**
+     * @brief Returns a new version with the elements of `other` appended.
+     *
+     * @param other The vector to append.
+     * @return persistent_vector The new version; `*this` and `other` are unchanged.
+     */
+    persistent_vector concat(const persistent_vector& other) const {
+        if (other.empty()) return *this;
+        if (empty()) return other;
+
+        unsigned h = std::max(m_height, other.m_height);
+        sc::vector<node_ptr> parts =
+            merge(raise(m_root, m_height, h), raise(other.m_root, other.m_height, h), h);
+
+        persistent_vector result;
+        if (parts.size() == 1) {
+            result.m_root = parts[0];
+            result.m_height = h;
+        } else {
+            result.m_root = make_inner(parts.data(), parts.data() + parts.size(), h + 1);
+            result.m_height = h + 1;
+        }
+        result.normalize();
+        return result;
+    }
+    /**
+     * @brief Returns a new version with the elements in [first, last).
+     *
+     * @param first Index of the first element kept.
+     * @param last Index one past the last element kept.
+     * @return persistent_vector The new version; `*this` is unchanged.
+     */
+    persistent_vector slice(size_type first, size_type last) const {
+        if (first > last or last > size())
+            throw std::out_of_range("[persistent_vector::slice()]: intervalo fora do vetor.");
+        if (first == last) return persistent_vector();
+
+        persistent_vector result(*this);
+        if (last < size()) result.m_root = take(result.m_root, result.m_height, last);
+        if (first > 0) result.m_root = drop(result.m_root, result.m_height, first);
+        result.normalize();
+        return result;
+    }
+
+    //=== [V] Element access
+    /**
+     * @brief Implements the operator [].
+     * @param position index of the element to be accessed.
+     * @return constant reference to the requested element.
+     */
+    const_reference operator[](size_type position) const {
+        const node* leaf = leaf_for(position);  // Turns `position` into an index inside the leaf.
+        return leaf->values[position];
+    }
+    /**
+     * @brief Returns element at index `position`.
+     * @param position index of the element that should be returned.
+     * @return the element of the index `position`.
+     */
+    const_reference at(size_type position) const {
+        if (position >= size())
+            throw std::out_of_range("[persistent_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Return the first element of the list.
+     */
+    const_reference front(void) const {
+        if (empty()) throw std::length_error("[persistent_vector::front()]: vetor vazio.");
+
+        return (*this)[0];
+    }
+    /**
+     * @brief Return the last element of the list.
+     */
+    const_reference back(void) const {
+        if (empty()) throw std::length_error("[persistent_vector::back()]: vetor vazio.");
+
+        return (*this)[size() - 1];
+    }
+
+    //=== [VI] Conversions
+    /**
+     * @brief Copies the elements into a sc::vector in O(n), one leaf at a time.
+     *
+     * @return sc::vector<value_type> A vector with the same elements.
+     */
+    sc::vector<value_type> to_vector(void) const {
+        sc::vector<value_type> out;
+        out.reserve(size());
+        if (m_root) collect(m_root.get(), m_height, out);
+        return out;
+    }
+    /**
+     * @brief Returns a mutable builder that starts from this version.
+     *
+     * @return transient_type The builder; call transient_type::persistent() to get a version back.
+     */
+    transient_type transient(void) const { return transient_type(*this); }
+
+    //=== [VII] Nested classes.
+    /// Iterator that walks the leaves in order, resolving a new leaf only when crossing one.
+    class const_iterator {
+       public:
+        typedef std::ptrdiff_t difference_type;                     //!< Distance between iterators.
+        typedef T value_type;                                       //!< Value type the iterator points to.
+        typedef const T* pointer;                                   //!< Pointer to the value type.
+        typedef const T& reference;                                 //!< Reference to the value type.
+        typedef std::bidirectional_iterator_tag iterator_category;  //!< Iterator category.
+
+       private:
+        const persistent_vector* m_vec{nullptr};  //!< The vector being walked.
+        size_type m_index{0};                    //!< Current position.
+        const node* m_leaf{nullptr};             //!< Leaf holding m_index.
+        size_type m_leaf_begin{0};               //!< Index of the first element of m_leaf.
+        size_type m_leaf_end{0};                 //!< Index one past the last element of m_leaf.
+
+        /// Resolves the leaf for the current index when it is outside the cached one.
+        void seek(void) {
+            if (m_index >= m_vec->size() or (m_index >= m_leaf_begin and m_index < m_leaf_end and m_leaf)) return;
+            size_type local = m_index;
+            m_leaf = m_vec->leaf_for(local);
+            m_leaf_begin = m_index - local;
+            m_leaf_end = m_leaf_begin + m_leaf->values.size();
+        }
+
+       public:
+        /**
+         * @brief Construct an iterator at `index` of `vec`.
+         */
+        const_iterator(const persistent_vector* vec = nullptr, size_type index = 0) : m_vec{vec}, m_index{index} {
+            if (m_vec) seek();
+        }
+        /**
+         * @brief The unary indirection operator.
+         */
+        reference operator*() const { return m_leaf->values[m_index - m_leaf_begin]; }
+        /**
+         * @brief The operator prefix increment.
+         */
+        const_iterator& operator++() {
+            ++m_index;
+            seek();
+            return *this;
+        }
+        /**
+         * @brief The operator postfix increment.
+         */
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++(*this);
+            return it;
+        }
+        /**
+         * @brief The operator prefix decrement.
+         */
+        const_iterator& operator--() {
+            --m_index;
+            seek();
+            return *this;
+        }
+        /**
+         * @brief The operator postfix decrement.
+         */
+        const_iterator operator--(int) {
+            const_iterator it = *this;
+            --(*this);
+            return it;
+        }
+        /**
+         * @brief The equality operator.
+         */
+        bool operator==(const const_iterator& other) const {
+            return m_vec == other.m_vec and m_index == other.m_index;
+        }
+        /**
+         * @brief The inequality operator.
+         */
+        bool operator!=(const const_iterator& other) const { return not(*this == other); }
+    };
+
+    /// Mutable builder: edits in place the nodes it created and copies shared ones on first write.
+    class transient_type {
+       private:
+        persistent_vector m_vec;  //!< Contents being built.
+        unsigned long m_owner;    //!< Identifier stamped on the nodes this builder may edit.
+
+       public:
+        /**
+         * @brief Construct a builder starting from `origin`.
+         */
+        explicit transient_type(const persistent_vector& origin) : m_vec{origin}, m_owner{next_owner()} {}
+        transient_type(const transient_type&) = delete;
+        transient_type& operator=(const transient_type&) = delete;
+        transient_type(transient_type&&) = default;
+        transient_type& operator=(transient_type&&) = default;
+
+        /**
+         * @brief Appends `value` in place.
+         */
+        void push_back(const_reference value) { m_vec.append(value, m_owner); }
+        /**
+         * @brief Replaces the element at `position` in place.
+         */
+        void set(size_type position, const_reference value) {
+            if (position >= size())
+                throw std::out_of_range("[persistent_vector::transient_type::set()]: tentativa de escrita fora do vetor.");
+
+            assign_at(m_vec.m_root, m_vec.m_height, position, value, m_owner);
+        }
+        /**
+         * @brief Return size of the vector being built.
+         */
+        size_type size(void) const { return m_vec.size(); }
+        /**
+         * @brief Implements the operator [].
+         */
+        const_reference operator[](size_type position) const { return m_vec[position]; }
+        /**
+         * @brief Returns the current contents as an immutable version.
+         *
+         * The builder keeps working afterwards, but it no longer edits the nodes shared with
+         * the returned version.
+         */
+        persistent_vector persistent(void) {
+            m_owner = next_owner();
+            return m_vec;
+        }
+    };
+};  // class persistent_vector.
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal.
+ * @param lhs vector whose content is compared with `rhs`.
+ * @param rhs vector whose content is compared with `lhs`.
+ * @return true if the contents of the vectors are equal, false otherwise.
+ */
+template <typename T>
+bool operator==(const persistent_vector<T>& lhs, const persistent_vector<T>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+
+    auto it = rhs.begin();
+    for (const auto& e : lhs)
+        if (not(e == *it++)) return false;
+
+    return true;
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ * @param lhs vector whose content is compared with `rhs`.
+ * @param rhs vector whose content is compared with `lhs`.
+ * @return true if the contents of the vectors are not equal, false otherwise.
+ */
+template <typename T>
+bool operator!=(const persistent_vector<T>& lhs, const persistent_vector<T>& rhs) {
+    return not(lhs == rhs);
+}
+
+}  // namespace sc.
+#endif
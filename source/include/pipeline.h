@@ -0,0 +1,568 @@
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <iterator>     // std::input_iterator_tag
+#include <stdexcept>    // std::invalid_argument
+#include <type_traits>  // std::decay, std::enable_if, std::is_base_of, std::remove_pointer
+#include <utility>      // std::declval, std::forward, std::move, std::pair
+
+#include "span.h"  // Also vector.h.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Base of the lazy views of a pipeline.
+/*!
+ * A view holds the view it is built on by value and a source view holds two pointers, so
+ * building a pipeline copies no element. Each view has `begin()`, `end()` and `size_hint()`,
+ * an upper bound on its number of elements. Its iterators read the view they come from
+ * (for its function), so they must not outlive it.
+ */
+struct view_base {};
+
+/// Whether `V` is a pipeline view.
+template <typename V>
+struct is_view : std::is_base_of<view_base, typename std::decay<V>::type> {};
+
+/// Whether `V` is an sc::span.
+template <typename V>
+struct is_span : std::false_type {};
+template <typename T>
+struct is_span<span<T>> : std::true_type {};
+
+/// Iterator of the view `V`.
+template <typename V>
+using iterator_of = decltype(std::declval<const V&>().begin());
+/// What the iterators of `V` give when dereferenced: a reference into the source, or a computed value.
+template <typename V>
+using reference_of = decltype(*std::declval<iterator_of<V>&>());
+/// Type of the elements of `V`.
+template <typename V>
+using value_of = typename std::decay<reference_of<V>>::type;
+
+/// Common members of the view iterators. They are input iterators, since dereferencing may
+/// compute a value, but they can be copied and traversed again (the views never consume their source).
+template <typename D, typename Ref>
+struct view_iterator {
+    using iterator_category = std::input_iterator_tag;  //!< Iterator category.
+    using value_type = typename std::decay<Ref>::type;  //!< Value type the iterator points to.
+    using difference_type = std::ptrdiff_t;             //!< Difference between iterators.
+    using pointer = void;                               //!< Values may be computed, so no pointer.
+    using reference = Ref;                              //!< What dereferencing gives.
+
+    D operator++(int) {
+        D old = static_cast<D&>(*this);
+        ++static_cast<D&>(*this);
+        return old;
+    }
+    friend bool operator!=(const D& a, const D& b) { return not(a == b); }
+};
+
+/// The elements of a contiguous container (or span), where every pipeline starts.
+template <typename T>
+class source_view : public view_base {
+   private:
+    T* m_first;  //!< First element.
+    T* m_last;   //!< Past the last element.
+
+   public:
+    using iterator = T*;  //!< The iterator.
+
+    source_view(T* first, T* last) : m_first{first}, m_last{last} {}
+    iterator begin(void) const { return m_first; }
+    iterator end(void) const { return m_last; }
+    std::size_t size_hint(void) const { return static_cast<std::size_t>(m_last - m_first); }
+};
+
+/// Whether `V` is a source view, whose elements are contiguous.
+template <typename V>
+struct is_source : std::false_type {};
+template <typename T>
+struct is_source<source_view<T>> : std::true_type {};
+
+/// Views are taken by value.
+template <typename V, typename = typename std::enable_if<is_view<V>::value>::type>
+typename std::decay<V>::type as_view(V&& v) {
+    return std::forward<V>(v);
+}
+/// A span views storage owned elsewhere, so it may be a temporary.
+template <typename T>
+source_view<T> as_view(span<T> s) {
+    return source_view<T>(s.data(), s.data() + s.size());
+}
+/// Containers with `data()` and `size()` must be lvalues: the pipeline does not own them.
+template <typename C, typename = typename std::enable_if<not is_view<C>::value and not is_span<C>::value>::type>
+auto as_view(C& c) -> source_view<typename std::remove_pointer<decltype(c.data())>::type> {
+    return source_view<typename std::remove_pointer<decltype(c.data())>::type>(c.data(), c.data() + c.size());
+}
+/// Raw arrays.
+template <typename T, std::size_t N>
+source_view<T> as_view(T (&array)[N]) {
+    return source_view<T>(array, array + N);
+}
+
+/// The view of a range: a view, a span, or an lvalue container or array.
+template <typename R>
+using view_t = decltype(as_view(std::declval<R>()));
+
+/// The elements of `V` for which `P` holds.
+template <typename V, typename P>
+class filter_view : public view_base {
+   private:
+    V m_base;  //!< The view filtered.
+    P m_pred;  //!< The predicate.
+
+   public:
+    /// Skips the elements the predicate rejects.
+    class iterator : public view_iterator<iterator, reference_of<V>> {
+       private:
+        iterator_of<V> m_cur;  //!< Current element of the base.
+        iterator_of<V> m_end;  //!< End of the base.
+        const P* m_pred;       //!< The predicate.
+
+        void skip(void) {
+            while (m_cur != m_end and not(*m_pred)(*m_cur)) ++m_cur;
+        }
+
+       public:
+        iterator(iterator_of<V> cur, iterator_of<V> end, const P* pred) : m_cur(cur), m_end(end), m_pred{pred} {
+            skip();
+        }
+        reference_of<V> operator*() const { return *m_cur; }
+        iterator& operator++() {
+            ++m_cur;
+            skip();
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_cur == b.m_cur; }
+    };
+
+    filter_view(V base, P pred) : m_base(std::move(base)), m_pred(std::move(pred)) {}
+    iterator begin(void) const { return iterator(m_base.begin(), m_base.end(), &m_pred); }
+    iterator end(void) const { return iterator(m_base.end(), m_base.end(), &m_pred); }
+    std::size_t size_hint(void) const { return m_base.size_hint(); }
+};
+
+/// `F(x)` for each element `x` of `V`.
+template <typename V, typename F>
+class transform_view : public view_base {
+   public:
+    using reference = decltype(std::declval<const F&>()(std::declval<reference_of<V>>()));  //!< What `F` returns.
+
+   private:
+    V m_base;  //!< The view transformed.
+    F m_fn;    //!< The function.
+
+   public:
+    /// Calls the function on dereference.
+    class iterator : public view_iterator<iterator, reference> {
+       private:
+        iterator_of<V> m_cur;  //!< Current element of the base.
+        const F* m_fn;         //!< The function.
+
+       public:
+        iterator(iterator_of<V> cur, const F* fn) : m_cur(cur), m_fn{fn} {}
+        reference operator*() const { return (*m_fn)(*m_cur); }
+        iterator& operator++() {
+            ++m_cur;
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_cur == b.m_cur; }
+    };
+
+    transform_view(V base, F fn) : m_base(std::move(base)), m_fn(std::move(fn)) {}
+    iterator begin(void) const { return iterator(m_base.begin(), &m_fn); }
+    iterator end(void) const { return iterator(m_base.end(), &m_fn); }
+    std::size_t size_hint(void) const { return m_base.size_hint(); }
+};
+
+/// The first `n` elements of `V`.
+template <typename V>
+class take_view : public view_base {
+   private:
+    V m_base;         //!< The view.
+    std::size_t m_n;  //!< Elements to take.
+
+   public:
+    /// Counts down the elements left.
+    class iterator : public view_iterator<iterator, reference_of<V>> {
+       private:
+        iterator_of<V> m_cur;  //!< Current element of the base.
+        iterator_of<V> m_end;  //!< End of the base.
+        std::size_t m_left;    //!< Elements left, including the current one.
+
+        bool done(void) const { return m_left == 0 or m_cur == m_end; }
+
+       public:
+        iterator(iterator_of<V> cur, iterator_of<V> end, std::size_t left) : m_cur(cur), m_end(end), m_left{left} {}
+        reference_of<V> operator*() const { return *m_cur; }
+        iterator& operator++() {
+            // The base stays on the last element taken: advancing a filter past it could scan
+            // the whole rest of the input.
+            if (--m_left != 0) ++m_cur;
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.done() or b.done() ? a.done() == b.done() : a.m_cur == b.m_cur;
+        }
+    };
+
+    take_view(V base, std::size_t n) : m_base(std::move(base)), m_n{n} {}
+    iterator begin(void) const { return iterator(m_base.begin(), m_base.end(), m_n); }
+    iterator end(void) const { return iterator(m_base.end(), m_base.end(), 0); }
+    std::size_t size_hint(void) const { return m_n < m_base.size_hint() ? m_n : m_base.size_hint(); }
+};
+
+/// `V` without its first `n` elements.
+template <typename V>
+class drop_view : public view_base {
+   private:
+    V m_base;         //!< The view.
+    std::size_t m_n;  //!< Elements to skip.
+
+   public:
+    using iterator = iterator_of<V>;  //!< The iterator of the base.
+
+    drop_view(V base, std::size_t n) : m_base(std::move(base)), m_n{n} {}
+    iterator begin(void) const {
+        iterator it = m_base.begin(), last = m_base.end();
+        for (std::size_t i{0}; i < m_n and it != last; ++i) ++it;
+        return it;
+    }
+    iterator end(void) const { return m_base.end(); }
+    std::size_t size_hint(void) const { return m_n < m_base.size_hint() ? m_base.size_hint() - m_n : 0; }
+};
+
+/// Pairs of (index, element) of `V`.
+template <typename V>
+class enumerate_view : public view_base {
+   public:
+    using value_type = std::pair<std::size_t, value_of<V>>;  //!< The pairs.
+
+   private:
+    V m_base;  //!< The view.
+
+   public:
+    /// Counts the elements it passes.
+    class iterator : public view_iterator<iterator, value_type> {
+       private:
+        iterator_of<V> m_cur;  //!< Current element of the base.
+        std::size_t m_index;   //!< Its index.
+
+       public:
+        iterator(iterator_of<V> cur, std::size_t index) : m_cur(cur), m_index{index} {}
+        value_type operator*() const { return value_type(m_index, *m_cur); }
+        iterator& operator++() {
+            ++m_cur;
+            ++m_index;
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_cur == b.m_cur; }
+    };
+
+    explicit enumerate_view(V base) : m_base(std::move(base)) {}
+    iterator begin(void) const { return iterator(m_base.begin(), 0); }
+    iterator end(void) const { return iterator(m_base.end(), 0); }
+    std::size_t size_hint(void) const { return m_base.size_hint(); }
+};
+
+/// Pairs of elements of `A` and `B` at the same position, as long as the shorter one.
+template <typename A, typename B>
+class zip_view : public view_base {
+   public:
+    using value_type = std::pair<value_of<A>, value_of<B>>;  //!< The pairs.
+
+   private:
+    A m_first;   //!< Left view.
+    B m_second;  //!< Right view.
+
+   public:
+    /// Walks both views in step.
+    class iterator : public view_iterator<iterator, value_type> {
+       private:
+        iterator_of<A> m_a;  //!< Current element of the left view.
+        iterator_of<B> m_b;  //!< Current element of the right view.
+
+       public:
+        iterator(iterator_of<A> a, iterator_of<B> b) : m_a(a), m_b(b) {}
+        value_type operator*() const { return value_type(*m_a, *m_b); }
+        iterator& operator++() {
+            ++m_a;
+            ++m_b;
+            return *this;
+        }
+        /// Either side reaching the other's position ends the walk at the shorter view.
+        friend bool operator==(const iterator& x, const iterator& y) { return x.m_a == y.m_a or x.m_b == y.m_b; }
+    };
+
+    zip_view(A first, B second) : m_first(std::move(first)), m_second(std::move(second)) {}
+    iterator begin(void) const { return iterator(m_first.begin(), m_second.begin()); }
+    iterator end(void) const { return iterator(m_first.end(), m_second.end()); }
+    std::size_t size_hint(void) const {
+        return m_first.size_hint() < m_second.size_hint() ? m_first.size_hint() : m_second.size_hint();
+    }
+};
+
+/// Consecutive groups of `n` elements of `V` (the last one may be shorter), each gathered
+/// into an sc::vector, since the elements of a lazy view are not stored anywhere.
+template <typename V, bool = is_source<V>::value>
+class chunk_view : public view_base {
+   public:
+    using value_type = sc::vector<value_of<V>>;  //!< A chunk.
+
+   private:
+    V m_base;         //!< The view.
+    std::size_t m_n;  //!< Elements per chunk.
+
+   public:
+    /// Holds the current chunk, filled once per step.
+    class iterator : public view_iterator<iterator, const value_type&> {
+       private:
+        iterator_of<V> m_cur;  //!< First element of the base after the chunk.
+        iterator_of<V> m_end;  //!< End of the base.
+        std::size_t m_n;       //!< Elements per chunk.
+        value_type m_chunk;    //!< The current chunk; empty at the end.
+
+        void fill(void) {
+            m_chunk.clear();
+            for (; m_chunk.size() < m_n and m_cur != m_end; ++m_cur) m_chunk.push_back(*m_cur);
+        }
+
+       public:
+        iterator(iterator_of<V> cur, iterator_of<V> end, std::size_t n) : m_cur(cur), m_end(end), m_n{n}, m_chunk{} {
+            if (m_cur != m_end) m_chunk.reserve(n);
+            fill();
+        }
+        const value_type& operator*() const { return m_chunk; }
+        iterator& operator++() {
+            fill();
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) {
+            return a.m_cur == b.m_cur and a.m_chunk.empty() == b.m_chunk.empty();
+        }
+    };
+
+    chunk_view(V base, std::size_t n) : m_base(std::move(base)), m_n{n} {}
+    iterator begin(void) const { return iterator(m_base.begin(), m_base.end(), m_n); }
+    iterator end(void) const { return iterator(m_base.end(), m_base.end(), m_n); }
+    std::size_t size_hint(void) const { return (m_base.size_hint() + m_n - 1) / m_n; }
+};
+
+/// Consecutive groups of `n` elements of a contiguous source, as spans of it: no copies.
+template <typename V>
+class chunk_view<V, true> : public view_base {
+   public:
+    using element_type = typename std::remove_pointer<iterator_of<V>>::type;  //!< Type of the elements, maybe const.
+    using value_type = span<element_type>;                                     //!< A chunk.
+
+   private:
+    V m_base;         //!< The view.
+    std::size_t m_n;  //!< Elements per chunk.
+
+   public:
+    /// Moves `n` elements at a time.
+    class iterator : public view_iterator<iterator, value_type> {
+       private:
+        element_type* m_cur;  //!< First element of the chunk.
+        element_type* m_end;  //!< End of the source.
+        std::size_t m_n;      //!< Elements per chunk.
+
+        std::size_t length(void) const {
+            return static_cast<std::size_t>(m_end - m_cur) < m_n ? static_cast<std::size_t>(m_end - m_cur) : m_n;
+        }
+
+       public:
+        iterator(element_type* cur, element_type* end, std::size_t n) : m_cur{cur}, m_end{end}, m_n{n} {}
+        value_type operator*() const { return value_type(m_cur, length()); }
+        iterator& operator++() {
+            m_cur += length();
+            return *this;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_cur == b.m_cur; }
+    };
+
+    chunk_view(V base, std::size_t n) : m_base(std::move(base)), m_n{n} {}
+    iterator begin(void) const { return iterator(m_base.begin(), m_base.end(), m_n); }
+    iterator end(void) const { return iterator(m_base.end(), m_base.end(), m_n); }
+    std::size_t size_hint(void) const { return (m_base.size_hint() + m_n - 1) / m_n; }
+};
+
+//=== Adaptors: what `range | adaptor` applies to the view of the range.
+
+/// Base of the adaptors.
+template <typename A>
+struct adaptor {
+    /// The adaptor as its own type.
+    const A& self(void) const { return static_cast<const A&>(*this); }
+};
+
+/// Builds a filter_view.
+template <typename P>
+struct filter_fn : adaptor<filter_fn<P>> {
+    P pred;  //!< The predicate.
+
+    explicit filter_fn(P p) : pred(std::move(p)) {}
+    template <typename V>
+    filter_view<V, P> operator()(V view) const {
+        return filter_view<V, P>(std::move(view), pred);
+    }
+};
+
+/// Builds a transform_view.
+template <typename F>
+struct transform_fn : adaptor<transform_fn<F>> {
+    F fn;  //!< The function.
+
+    explicit transform_fn(F f) : fn(std::move(f)) {}
+    template <typename V>
+    transform_view<V, F> operator()(V view) const {
+        return transform_view<V, F>(std::move(view), fn);
+    }
+};
+
+/// Builds a take_view.
+struct take_fn : adaptor<take_fn> {
+    std::size_t n;  //!< Elements to take.
+
+    explicit take_fn(std::size_t count) : n{count} {}
+    template <typename V>
+    take_view<V> operator()(V view) const {
+        return take_view<V>(std::move(view), n);
+    }
+};
+
+/// Builds a drop_view.
+struct drop_fn : adaptor<drop_fn> {
+    std::size_t n;  //!< Elements to skip.
+
+    explicit drop_fn(std::size_t count) : n{count} {}
+    template <typename V>
+    drop_view<V> operator()(V view) const {
+        return drop_view<V>(std::move(view), n);
+    }
+};
+
+/// Builds a chunk_view.
+struct chunk_fn : adaptor<chunk_fn> {
+    std::size_t n;  //!< Elements per chunk.
+
+    explicit chunk_fn(std::size_t count) : n{count} {}
+    template <typename V>
+    chunk_view<V> operator()(V view) const {
+        return chunk_view<V>(std::move(view), n);
+    }
+};
+
+/// Builds an enumerate_view.
+struct enumerate_fn : adaptor<enumerate_fn> {
+    template <typename V>
+    enumerate_view<V> operator()(V view) const {
+        return enumerate_view<V>(std::move(view));
+    }
+};
+
+/// Builds a zip_view with the view it holds on the right.
+template <typename B>
+struct zip_fn : adaptor<zip_fn<B>> {
+    B other;  //!< The right view.
+
+    explicit zip_fn(B b) : other(std::move(b)) {}
+    template <typename V>
+    zip_view<V, B> operator()(V view) const {
+        return zip_view<V, B>(std::move(view), other);
+    }
+};
+
+/// Ends a pipeline: copies its elements into a new `C<value_type>`.
+template <template <typename...> class C>
+struct collect_fn : adaptor<collect_fn<C>> {
+    template <typename V>
+    C<value_of<V>> operator()(const V& view) const {
+        C<value_of<V>> out;
+        out.reserve(view.size_hint());
+        for (iterator_of<V> it = view.begin(), last = view.end(); it != last; ++it) out.push_back(*it);
+        return out;
+    }
+};
+
+/// Applies an adaptor to a range (a view, a span, or an lvalue container or array).
+template <typename R, typename A>
+auto operator|(R&& range, const adaptor<A>& a) -> decltype(a.self()(as_view(std::forward<R>(range)))) {
+    return a.self()(as_view(std::forward<R>(range)));
+}
+
+}  // namespace detail.
+
+/// Keeps the elements for which `pred(x)` holds.
+/*!
+ * Pipelines chain lazy views over an sc::vector (or span, any container with `data()` and
+ * `size()`, or array) and end in sc::collect(), which reserves its result once and fills it
+ * in one pass; no stage builds a temporary vector:
+ *
+ *     auto out = v | sc::filter(is_valid) | sc::transform(normalize) | sc::take(1000)
+ *                  | sc::collect<sc::vector>();
+ *
+ * A pipeline is also a range: `for (auto x : v | sc::drop(1))`. It reads the container
+ * it starts from, which must stay alive and unchanged while the pipeline is used; a
+ * temporary container cannot start a pipeline.
+ */
+template <typename P>
+detail::filter_fn<typename std::decay<P>::type> filter(P&& pred) {
+    return detail::filter_fn<typename std::decay<P>::type>(std::forward<P>(pred));
+}
+
+/// Replaces each element `x` with `fn(x)`, computed when it is read.
+template <typename F>
+detail::transform_fn<typename std::decay<F>::type> transform(F&& fn) {
+    return detail::transform_fn<typename std::decay<F>::type>(std::forward<F>(fn));
+}
+
+/// Keeps the first `n` elements; the elements after them are never read.
+inline detail::take_fn take(std::size_t n) { return detail::take_fn(n); }
+
+/// Skips the first `n` elements.
+inline detail::drop_fn drop(std::size_t n) { return detail::drop_fn(n); }
+
+/**
+ * @brief Groups the elements by `n`; the last group may be shorter.
+ *
+ * Straight over a container the groups are spans of it; after other views they are
+ * sc::vectors, gathered as the pipeline runs.
+ *
+ * @throws std::invalid_argument if `n` is zero.
+ */
+inline detail::chunk_fn chunk(std::size_t n) {
+    if (n == 0) throw std::invalid_argument("[sc::chunk()]: tamanho de grupo nulo.");
+    return detail::chunk_fn(n);
+}
+
+/// Pairs each element with its index, from 0.
+inline detail::enumerate_fn enumerate(void) { return detail::enumerate_fn(); }
+
+/// Pairs each element with the element of `other` at the same position, up to the end of the shorter one.
+template <typename R>
+detail::zip_fn<detail::view_t<R>> zip(R&& other) {
+    return detail::zip_fn<detail::view_t<R>>(detail::as_view(std::forward<R>(other)));
+}
+
+/// Pairs the elements of `a` and `b` at the same position, up to the end of the shorter one.
+template <typename A, typename B>
+detail::zip_view<detail::view_t<A>, detail::view_t<B>> zip(A&& a, B&& b) {
+    return detail::zip_view<detail::view_t<A>, detail::view_t<B>>(detail::as_view(std::forward<A>(a)),
+                                                                  detail::as_view(std::forward<B>(b)));
+}
+
+/// Ends a pipeline with a container of its elements, e.g. `collect<sc::vector>()`: the container
+/// reserves the size hint of the pipeline (an upper bound after filter) and is filled in one pass.
+template <template <typename...> class C>
+detail::collect_fn<C> collect(void) {
+    return detail::collect_fn<C>();
+}
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,578 @@
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include <atomic>       // std::atomic
+#include <cstddef>      // std::size_t
+#include <cstring>      // std::memcpy
+#include <new>          // placement new
+#include <stdexcept>    // std::invalid_argument
+#include <thread>       // std::this_thread::yield
+#include <type_traits>  // std::is_trivially_copyable, std::is_nothrow_move_constructible, std::is_nothrow_copy_constructible
+#include <utility>      // std::move
+
+#include "span.h"  // Also vector.h.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Tells the CPU that the thread is spinning, so its sibling hyperthread gets the core.
+inline void cpu_relax(void) {
+#if defined(__x86_64__) or defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/// Spins on `a` a little while it holds `old`; returns whether it changed.
+template <typename U>
+bool spin_while_equal(const std::atomic<U>& a, U old) {
+    for (int i{0}; i < 64; ++i) {
+        if (a.load(std::memory_order_acquire) != old) return true;
+        cpu_relax();
+    }
+    return false;
+}
+
+/// Room for one `T`, constructed and destroyed by the queue.
+template <typename T>
+struct queue_slot {
+    alignas(T) unsigned char bytes[sizeof(T)];  //!< The element, when the slot is full.
+
+    T* get(void) { return reinterpret_cast<T*>(bytes); }
+};
+
+/// Smallest power of two not below `n`.
+/**
+ * @throws std::invalid_argument if `n` is zero or too large.
+ */
+inline std::size_t queue_capacity(std::size_t n) {
+    if (n == 0 or n > (~std::size_t{0} >> 2)) throw std::invalid_argument("[sc::queue]: capacidade inválida.");
+    std::size_t c{1};
+    while (c < n) c <<= 1;
+    return c;
+}
+
+}  // namespace detail.
+
+/// Wait policy of the queues: a blocked push() or pop() spins briefly, then yields the processor until it can go on.
+/*!
+ * Pushes and pops never notify anybody, so the lock-free operations stay as cheap as they
+ * can be; the price is that a blocked thread keeps polling.
+ */
+struct spin_wait {
+    /// Blocks while `a` holds `old`.
+    template <typename U>
+    static void wait(const std::atomic<U>& a, U old) {
+        if (detail::spin_while_equal(a, old)) return;
+        while (a.load(std::memory_order_acquire) == old) std::this_thread::yield();
+    }
+    /// Called after `a` changes; nothing to do.
+    template <typename U>
+    static void notify(std::atomic<U>&) {}
+};
+
+/// Wait policy of the queues: a blocked push() or pop() spins briefly, then sleeps.
+/*!
+ * With C++20 the thread sleeps on `std::atomic::wait` (a futex on Linux) and every push and
+ * pop calls `notify_all`, which costs some nanoseconds even with nobody asleep; choose it when
+ * threads may stay blocked for long. Before C++20 it behaves as sc::spin_wait.
+ */
+struct sleep_wait {
+    /// Blocks while `a` holds `old`.
+    template <typename U>
+    static void wait(const std::atomic<U>& a, U old) {
+        if (detail::spin_while_equal(a, old)) return;
+#if defined(__cpp_lib_atomic_wait)
+        a.wait(old, std::memory_order_acquire);
+#else
+        while (a.load(std::memory_order_acquire) == old) std::this_thread::yield();
+#endif
+    }
+    /// Wakes the threads blocked on `a`.
+    template <typename U>
+    static void notify(std::atomic<U>& a) {
+#if defined(__cpp_lib_atomic_wait)
+        a.notify_all();
+#else
+        (void)a;
+#endif
+    }
+};
+
+/// A bounded lock-free queue for exactly one producer thread and one consumer thread.
+/*!
+ * The elements live in a ring of preallocated slots (a power of two, so positions wrap with a
+ * mask). The producer owns the tail and the consumer the head; each keeps a private copy of
+ * the other's index and reads the shared one only when that copy says the ring is full (or
+ * empty), so a handoff usually touches no cache line written by the other thread. The two
+ * ends are padded a whole cache line apart.
+ *
+ * try_push_n() and try_pop_n() move a batch in at most two contiguous runs (memcpy for
+ * trivially copyable types) and publish it with a single atomic store. push() and pop()
+ * block as the wait policy says.
+ *
+ * \tparam T The type of the elements; moving it must not throw.
+ * \tparam WaitPolicy sc::spin_wait (the default) or sc::sleep_wait.
+ */
+template <typename T, typename WaitPolicy = spin_wait>
+class spsc_queue {
+    static_assert(std::is_nothrow_move_constructible<T>::value, "queue elements must be nothrow movable");
+
+   public:
+    using size_type = std::size_t;  //!< The size type.
+    using value_type = T;           //!< The value type.
+
+   private:
+    enum : size_type { cache_line = 64 };
+    using slot_type = detail::queue_slot<T>;
+
+    char m_pad0[cache_line];        //!< Keeps the consumer's line away from whatever precedes the queue.
+    std::atomic<size_type> m_head;  //!< Next position to pop; written by the consumer.
+    size_type m_tail_cache;         //!< The consumer's last view of m_tail.
+    char m_pad1[cache_line];        //!< Keeps the two ends on different cache lines.
+    std::atomic<size_type> m_tail;  //!< Next position to push; written by the producer.
+    size_type m_head_cache;         //!< The producer's last view of m_head.
+    char m_pad2[cache_line];        //!< Keeps the producer's line away from the read-only members.
+    size_type m_mask;               //!< Capacity minus one.
+    sc::vector<slot_type> m_slots;  //!< The ring.
+
+    /// Free slots as the producer sees them, refreshing its view of the head when it needs `wanted`.
+    size_type free_slots(size_type tail, size_type wanted) {
+        size_type room = m_mask + 1 - (tail - m_head_cache);
+        if (room < wanted) {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            room = m_mask + 1 - (tail - m_head_cache);
+        }
+        return room;
+    }
+    /// Full slots as the consumer sees them, refreshing its view of the tail when it needs `wanted`.
+    size_type full_slots(size_type head, size_type wanted) {
+        size_type ready = m_tail_cache - head;
+        if (ready < wanted) {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            ready = m_tail_cache - head;
+        }
+        return ready;
+    }
+    /// Publishes the new tail and wakes a consumer blocked in pop().
+    void publish_tail(size_type tail) {
+        m_tail.store(tail, std::memory_order_release);
+        WaitPolicy::notify(m_tail);
+    }
+    /// Publishes the new head and wakes a producer blocked in push().
+    void publish_head(size_type head) {
+        m_head.store(head, std::memory_order_release);
+        WaitPolicy::notify(m_head);
+    }
+
+    /// Copies `count` elements into the ring from position `tail`; trivial types in at most two memcpy.
+    void copy_in(const T* items, size_type tail, size_type count, std::true_type /* trivially copyable */) {
+        size_type first = tail & m_mask, run = count < m_mask + 1 - first ? count : m_mask + 1 - first;
+        std::memcpy(m_slots[first].bytes, items, run * sizeof(T));
+        if (run < count) std::memcpy(m_slots[0].bytes, items + run, (count - run) * sizeof(T));
+    }
+    /// Others one by one; if a copy throws, the ones already built are destroyed (the tail is not published yet).
+    void copy_in(const T* items, size_type tail, size_type count, std::false_type /* trivially copyable */) {
+        size_type i{0};
+        try {
+            for (; i < count; ++i) ::new (static_cast<void*>(m_slots[(tail + i) & m_mask].get())) T(items[i]);
+        } catch (...) {
+            while (i > 0) m_slots[(tail + --i) & m_mask].get()->~T();
+            throw;
+        }
+    }
+    /// Moves `count` elements out of the ring from position `head`.
+    void move_out(T* out, size_type head, size_type count, std::true_type /* trivially copyable */) {
+        size_type first = head & m_mask, run = count < m_mask + 1 - first ? count : m_mask + 1 - first;
+        std::memcpy(out, m_slots[first].bytes, run * sizeof(T));
+        if (run < count) std::memcpy(out + run, m_slots[0].bytes, (count - run) * sizeof(T));
+    }
+    void move_out(T* out, size_type head, size_type count, std::false_type /* trivially copyable */) {
+        for (size_type i{0}; i < count; ++i) {
+            T* item = m_slots[(head + i) & m_mask].get();
+            out[i] = std::move(*item);
+            item->~T();
+        }
+    }
+
+   public:
+    /**
+     * @brief Construct an empty queue.
+     *
+     * @param capacity Most elements held at once, rounded up to a power of two.
+     * @throws std::invalid_argument if `capacity` is zero.
+     */
+    explicit spsc_queue(size_type capacity)
+        : m_pad0{}, m_head{0}, m_tail_cache{0}, m_pad1{}, m_tail{0}, m_head_cache{0}, m_pad2{},
+          m_mask{detail::queue_capacity(capacity) - 1}, m_slots(m_mask + 1) {}
+    /**
+     * @brief Destroy the queue and the elements left in it.
+     */
+    ~spsc_queue(void) {
+        for (size_type i = m_head.load(), last = m_tail.load(); i != last; ++i) m_slots[i & m_mask].get()->~T();
+    }
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    //=== Producer.
+    /**
+     * @brief Appends a copy of `value`, unless the queue is full.
+     * @return Whether it was appended.
+     */
+    bool try_push(const T& value) {
+        size_type tail = m_tail.load(std::memory_order_relaxed);
+        if (free_slots(tail, 1) == 0) return false;
+        ::new (static_cast<void*>(m_slots[tail & m_mask].get())) T(value);
+        publish_tail(tail + 1);
+        return true;
+    }
+    /**
+     * @brief Appends `value`, moved, unless the queue is full.
+     * @return Whether it was appended.
+     */
+    bool try_push(T&& value) {
+        size_type tail = m_tail.load(std::memory_order_relaxed);
+        if (free_slots(tail, 1) == 0) return false;
+        ::new (static_cast<void*>(m_slots[tail & m_mask].get())) T(std::move(value));
+        publish_tail(tail + 1);
+        return true;
+    }
+    /**
+     * @brief Appends copies of as many of the `count` elements at `items` as fit, in order.
+     * @return How many were appended.
+     */
+    size_type try_push_n(const T* items, size_type count) {
+        size_type tail = m_tail.load(std::memory_order_relaxed);
+        size_type room = free_slots(tail, count);
+        if (count > room) count = room;
+        if (count == 0) return 0;
+        copy_in(items, tail, count, std::is_trivially_copyable<T>());
+        publish_tail(tail + count);
+        return count;
+    }
+    /**
+     * @brief Appends copies of as many of the elements of `items` as fit, in order.
+     * @return How many were appended.
+     */
+    size_type try_push_n(span<const T> items) { return try_push_n(items.data(), items.size()); }
+    /**
+     * @brief Appends a copy of `value`, waiting while the queue is full.
+     */
+    void push(const T& value) {
+        while (not try_push(value)) WaitPolicy::wait(m_head, m_head_cache);
+    }
+    /**
+     * @brief Appends `value`, moved, waiting while the queue is full.
+     */
+    void push(T&& value) {
+        while (not try_push(std::move(value))) WaitPolicy::wait(m_head, m_head_cache);
+    }
+
+    //=== Consumer.
+    /**
+     * @brief Moves the first element into `out`, unless the queue is empty.
+     * @return Whether an element was popped.
+     */
+    bool try_pop(T& out) {
+        size_type head = m_head.load(std::memory_order_relaxed);
+        if (full_slots(head, 1) == 0) return false;
+        move_out(&out, head, 1, std::false_type());
+        publish_head(head + 1);
+        return true;
+    }
+    /**
+     * @brief Moves up to `count` elements, in order, into the (constructed) elements at `out`.
+     * @return How many were popped.
+     */
+    size_type try_pop_n(T* out, size_type count) {
+        size_type head = m_head.load(std::memory_order_relaxed);
+        size_type ready = full_slots(head, count);
+        if (count > ready) count = ready;
+        if (count == 0) return 0;
+        move_out(out, head, count, std::is_trivially_copyable<T>());
+        publish_head(head + count);
+        return count;
+    }
+    /**
+     * @brief Moves up to `out.size()` elements, in order, into `out`.
+     * @return How many were popped.
+     */
+    size_type try_pop_n(span<T> out) { return try_pop_n(out.data(), out.size()); }
+    /**
+     * @brief Moves the first element into `out`, waiting while the queue is empty.
+     */
+    void pop(T& out) {
+        while (not try_pop(out)) WaitPolicy::wait(m_tail, m_tail_cache);
+    }
+
+    //=== Either side.
+    /// Most elements held at once.
+    size_type capacity(void) const { return m_mask + 1; }
+    /// Number of elements; exact only when neither side is active.
+    size_type size(void) const {
+        size_type head = m_head.load(std::memory_order_acquire);
+        return m_tail.load(std::memory_order_acquire) - head;
+    }
+    /// Whether the queue is empty; exact only when neither side is active.
+    bool empty(void) const { return size() == 0; }
+};
+
+/// A bounded lock-free queue for any number of producer and consumer threads.
+/*!
+ * Dmitry Vyukov's bounded MPMC queue: every slot of the power-of-two ring carries a sequence
+ * number that says whether it is free or full in the current lap, so producers and consumers
+ * claim positions with one compare-and-swap on the tail or head and then fill or empty their
+ * slot without touching the other end. Head and tail are padded a whole cache line apart.
+ *
+ * try_push_n() and try_pop_n() claim a run of consecutive slots with a single compare-and-swap.
+ * push() and pop() block on the sequence number of the slot they wait for, as the wait
+ * policy says.
+ *
+ * \tparam T The type of the elements; moving it must not throw.
+ * \tparam WaitPolicy sc::spin_wait (the default) or sc::sleep_wait.
+ */
+template <typename T, typename WaitPolicy = spin_wait>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible<T>::value, "queue elements must be nothrow movable");
+
+   public:
+    using size_type = std::size_t;  //!< The size type.
+    using value_type = T;           //!< The value type.
+
+   private:
+    enum : size_type { cache_line = 64 };
+
+    /// A slot and its sequence number: its position when free, its position plus one when full.
+    struct cell {
+        std::atomic<size_type> sequence;   //!< Lap state of the slot.
+        detail::queue_slot<T> slot;        //!< The element, when full.
+    };
+
+    char m_pad0[cache_line];        //!< Keeps the head away from whatever precedes the queue.
+    std::atomic<size_type> m_head;  //!< Next position to pop.
+    char m_pad1[cache_line];        //!< Keeps head and tail on different cache lines.
+    std::atomic<size_type> m_tail;  //!< Next position to push.
+    char m_pad2[cache_line];        //!< Keeps the tail away from the read-only members.
+    size_type m_mask;               //!< Capacity minus one.
+    sc::vector<cell> m_cells;       //!< The ring.
+
+    /// Distance of a sequence number from what is expected, as a signed number.
+    static std::ptrdiff_t lag(size_type sequence, size_type expected) {
+        return static_cast<std::ptrdiff_t>(sequence - expected);
+    }
+
+    /// Claims up to `count` consecutive free slots; returns how many, and their first position in `pos`.
+    size_type claim_push(size_type count, size_type& pos) {
+        pos = m_tail.load(std::memory_order_relaxed);
+        for (;;) {
+            size_type n{0};
+            while (n < count and n <= m_mask and
+                   lag(m_cells[(pos + n) & m_mask].sequence.load(std::memory_order_acquire), pos + n) == 0)
+                ++n;
+            if (n == 0) {
+                std::ptrdiff_t d = lag(m_cells[pos & m_mask].sequence.load(std::memory_order_acquire), pos);
+                if (d < 0) return 0;  // Full: the slot still holds an element of the previous lap.
+                pos = m_tail.load(std::memory_order_relaxed);  // Another producer took it.
+            } else if (m_tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                return n;
+            }
+        }
+    }
+    /// Claims up to `count` consecutive full slots; returns how many, and their first position in `pos`.
+    size_type claim_pop(size_type count, size_type& pos) {
+        pos = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            size_type n{0};
+            while (n < count and n <= m_mask and
+                   lag(m_cells[(pos + n) & m_mask].sequence.load(std::memory_order_acquire), pos + n + 1) == 0)
+                ++n;
+            if (n == 0) {
+                std::ptrdiff_t d = lag(m_cells[pos & m_mask].sequence.load(std::memory_order_acquire), pos + 1);
+                if (d < 0) return 0;  // Empty: the slot has not been filled in this lap yet.
+                pos = m_head.load(std::memory_order_relaxed);  // Another consumer took it.
+            } else if (m_head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                return n;
+            }
+        }
+    }
+    /// Marks the slot of `pos` full and wakes a consumer blocked on it.
+    void release_full(size_type pos) {
+        cell& c = m_cells[pos & m_mask];
+        c.sequence.store(pos + 1, std::memory_order_release);
+        WaitPolicy::notify(c.sequence);
+    }
+    /// Marks the slot of `pos` free for the next lap and wakes a producer blocked on it.
+    void release_free(size_type pos) {
+        cell& c = m_cells[pos & m_mask];
+        c.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        WaitPolicy::notify(c.sequence);
+    }
+
+    /// Copies `value` into a claimed slot; the copy cannot throw.
+    bool push_copy(const T& value, std::true_type /* nothrow copyable */) {
+        size_type pos;
+        if (claim_push(1, pos) == 0) return false;
+        ::new (static_cast<void*>(m_cells[pos & m_mask].slot.get())) T(value);
+        release_full(pos);
+        return true;
+    }
+    /// Copies `value` before claiming a slot, so a throwing copy leaves no claimed slot unfilled.
+    bool push_copy(const T& value, std::false_type /* nothrow copyable */) {
+        T copy(value);
+        return try_push(std::move(copy));
+    }
+    /// Copies the elements into a claimed run of slots; the copies cannot throw.
+    size_type push_copies(const T* items, size_type count, std::true_type /* nothrow copyable */) {
+        size_type pos;
+        size_type n = claim_push(count, pos);
+        for (size_type i{0}; i < n; ++i) {
+            ::new (static_cast<void*>(m_cells[(pos + i) & m_mask].slot.get())) T(items[i]);
+            release_full(pos + i);
+        }
+        return n;
+    }
+    /// Copies the elements aside before claiming a run, then moves them in, which cannot throw.
+    size_type push_copies(const T* items, size_type count, std::false_type /* nothrow copyable */) {
+        if (count > m_mask + 1) count = m_mask + 1;
+        sc::vector<T> copies;
+        copies.reserve(count);
+        for (size_type i{0}; i < count; ++i) copies.push_back(items[i]);
+        size_type pos;
+        size_type n = claim_push(count, pos);
+        for (size_type i{0}; i < n; ++i) {
+            ::new (static_cast<void*>(m_cells[(pos + i) & m_mask].slot.get())) T(std::move(copies[i]));
+            release_full(pos + i);
+        }
+        return n;
+    }
+
+   public:
+    /**
+     * @brief Construct an empty queue.
+     *
+     * @param capacity Most elements held at once, rounded up to a power of two.
+     * @throws std::invalid_argument if `capacity` is zero.
+     */
+    explicit mpmc_queue(size_type capacity)
+        : m_pad0{}, m_head{0}, m_pad1{}, m_tail{0}, m_pad2{}, m_mask{detail::queue_capacity(capacity) - 1},
+          m_cells(m_mask + 1) {
+        for (size_type i{0}; i <= m_mask; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    /**
+     * @brief Destroy the queue and the elements left in it.
+     */
+    ~mpmc_queue(void) {
+        for (size_type i = m_head.load(), last = m_tail.load(); i != last; ++i) m_cells[i & m_mask].slot.get()->~T();
+    }
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    /**
+     * @brief Appends a copy of `value`, unless the queue is full.
+     * @return Whether it was appended.
+     */
+    bool try_push(const T& value) { return push_copy(value, std::is_nothrow_copy_constructible<T>()); }
+    /**
+     * @brief Appends `value`, moved, unless the queue is full.
+     * @return Whether it was appended.
+     */
+    bool try_push(T&& value) {
+        size_type pos;
+        if (claim_push(1, pos) == 0) return false;
+        ::new (static_cast<void*>(m_cells[pos & m_mask].slot.get())) T(std::move(value));
+        release_full(pos);
+        return true;
+    }
+    /**
+     * @brief Appends copies of as many of the `count` elements at `items` as there are free
+     * consecutive slots, in order and without elements of other producers in between.
+     *
+     * Elements whose copy may throw are copied aside first, so a throw appends nothing.
+     * @return How many were appended.
+     */
+    size_type try_push_n(const T* items, size_type count) {
+        return push_copies(items, count, std::is_nothrow_copy_constructible<T>());
+    }
+    /**
+     * @brief Appends copies of as many of the elements of `items` as fit, as try_push_n(pointer, count).
+     * @return How many were appended.
+     */
+    size_type try_push_n(span<const T> items) { return try_push_n(items.data(), items.size()); }
+    /**
+     * @brief Appends a copy of `value`, waiting while the queue is full.
+     */
+    void push(const T& value) {
+        for (;;) {
+            size_type pos = m_tail.load(std::memory_order_relaxed);
+            size_type seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+            if (try_push(value)) return;
+            if (lag(seq, pos) < 0) WaitPolicy::wait(m_cells[pos & m_mask].sequence, seq);
+        }
+    }
+    /**
+     * @brief Appends `value`, moved, waiting while the queue is full.
+     */
+    void push(T&& value) {
+        for (;;) {
+            size_type pos = m_tail.load(std::memory_order_relaxed);
+            size_type seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+            if (try_push(std::move(value))) return;
+            if (lag(seq, pos) < 0) WaitPolicy::wait(m_cells[pos & m_mask].sequence, seq);
+        }
+    }
+
+    /**
+     * @brief Moves the first element into `out`, unless the queue is empty.
+     * @return Whether an element was popped.
+     */
+    bool try_pop(T& out) { return try_pop_n(&out, 1) == 1; }
+    /**
+     * @brief Moves up to `count` consecutive elements, in order, into the (constructed) elements at `out`.
+     * @return How many were popped.
+     */
+    size_type try_pop_n(T* out, size_type count) {
+        size_type pos;
+        size_type n = claim_pop(count, pos);
+        for (size_type i{0}; i < n; ++i) {
+            T* item = m_cells[(pos + i) & m_mask].slot.get();
+            out[i] = std::move(*item);
+            item->~T();
+            release_free(pos + i);
+        }
+        return n;
+    }
+    /**
+     * @brief Moves up to `out.size()` consecutive elements, in order, into `out`.
+     * @return How many were popped.
+     */
+    size_type try_pop_n(span<T> out) { return try_pop_n(out.data(), out.size()); }
+    /**
+     * @brief Moves the first element into `out`, waiting while the queue is empty.
+     */
+    void pop(T& out) {
+        for (;;) {
+            size_type pos = m_head.load(std::memory_order_relaxed);
+            size_type seq = m_cells[pos & m_mask].sequence.load(std::memory_order_acquire);
+            if (try_pop(out)) return;
+            if (lag(seq, pos + 1) < 0) WaitPolicy::wait(m_cells[pos & m_mask].sequence, seq);
+        }
+    }
+
+    /// Most elements held at once.
+    size_type capacity(void) const { return m_mask + 1; }
+    /// Number of elements claimed by producers and not yet by consumers; a hint while threads are active.
+    size_type size(void) const {
+        size_type head = m_head.load(std::memory_order_acquire);
+        size_type tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    /// Whether the queue is empty; a hint while threads are active.
+    bool empty(void) const { return size() == 0; }
+};
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,319 @@
+#ifndef _RCU_VECTOR_H_
+#define _RCU_VECTOR_H_
+
+#include <atomic>     // std::atomic
+#include <cassert>    // assert()
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint64_t
+#include <memory>     // std::unique_ptr, std::align
+#include <new>        // placement new
+#include <stdexcept>  // std::length_error, std::invalid_argument
+#include <thread>     // std::this_thread::yield
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// A vector published in immutable versions: one writer, many lock-free readers.
+/*!
+ * Each version is a sc::vector that never changes after it is published. A reader takes a
+ * *snapshot* (a pointer plus a size) of the current version with two atomic operations and
+ * then iterates it without any lock, no matter what the writer does meanwhile. The writer
+ * builds the next version aside and publishes it with one atomic exchange.
+ *
+ * Old versions are reclaimed with epoch-based reclamation: a snapshot announces the global
+ * epoch in a per-reader slot, publishing retires the old version with the current epoch and
+ * advances it, and a retired version is freed once no slot announces an epoch up to its own.
+ * Reclaimed versions are kept for reuse, so updates stop allocating once the sizes settle.
+ *
+ * Readers must register (see `reader`), up to the number given to the constructor. All the
+ * members outside `reader` and `snapshot` belong to the single writer thread.
+ *
+ * \tparam T The type of the elements.
+ */
+template <typename T>
+class rcu_vector {
+   public:
+    using size_type = unsigned long;    //!< The size type.
+    using value_type = T;               //!< The value type.
+    using const_reference = const T&;   //!< Const reference to a stored value.
+    using const_iterator = const T*;    //!< Snapshots are iterated through plain pointers.
+    using vector_type = sc::vector<T>;  //!< Representation of one version.
+
+    class snapshot;
+    class reader;
+
+   private:
+    enum : size_type { cache_line = 64, max_spares = 2 };
+
+    /// One published version.
+    struct version {
+        vector_type items;         //!< The elements, immutable once published.
+        std::uint64_t retired_at;  //!< Epoch in which the version was replaced.
+    };
+
+    /// Per-reader announcement, on a cache line of its own so readers do not share lines.
+    struct alignas(cache_line) slot {
+        std::atomic<std::uint64_t> epoch;  //!< Epoch announced by the active snapshot, 0 when idle.
+        std::atomic<bool> claimed;         //!< Whether a reader owns the slot.
+    };
+    static_assert(sizeof(slot) == cache_line, "a reader slot must fill one cache line");
+
+    size_type m_slot_count;               //!< Number of reader slots.
+    std::unique_ptr<char[]> m_slot_block;  //!< Storage of the slots, with room to align them.
+    slot* m_slots;                        //!< Reader slots, in `m_slot_block`.
+    std::atomic<version*> m_current;     //!< The published version.
+    std::atomic<std::uint64_t> m_epoch;  //!< Global epoch, starting at 1.
+    sc::vector<version*> m_retired;      //!< Replaced versions that readers may still see (writer only).
+    sc::vector<version*> m_spares;       //!< Reclaimed versions kept for reuse (writer only).
+
+    /// Validates the number of reader slots.
+    static size_type checked_readers(size_type n) {
+        if (n == 0) throw std::invalid_argument("[rcu_vector()]: é preciso ao menos um leitor.");
+        return n;
+    }
+
+    /// Bytes of storage for `n` slots: `new slot[n]` only aligns them from C++17 on.
+    static std::size_t slot_block_bytes(size_type n) { return n * sizeof(slot) + cache_line - 1; }
+    /// Constructs `n` slots at the first cache line boundary of `block`.
+    static slot* place_slots(char* block, size_type n) {
+        void* p = block;
+        std::size_t room = slot_block_bytes(n);
+        std::align(cache_line, n * sizeof(slot), p, room);
+        slot* slots = static_cast<slot*>(p);
+        for (size_type i{0}; i < n; ++i) ::new (static_cast<void*>(slots + i)) slot;
+        return slots;
+    }
+
+    /// Returns an unpublished version, reusing a reclaimed one when possible.
+    version* acquire_version(void) {
+        if (m_spares.empty()) return new version{vector_type{}, 0};
+
+        version* v = m_spares.back();
+        m_spares.pop_back();
+        return v;
+    }
+    /// Keeps a version nobody can see for reuse, or frees it.
+    void recycle(version* v) {
+        if (m_spares.size() < max_spares)
+            m_spares.push_back(v);
+        else
+            delete v;
+    }
+    /// Publishes `next` and retires the version it replaces.
+    void publish_version(version* next) {
+        version* old = m_current.exchange(next, std::memory_order_seq_cst);
+        old->retired_at = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_retired.push_back(old);
+        reclaim();
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty rcu vector.
+     *
+     * @param max_readers Number of readers that may be registered at the same time.
+     */
+    explicit rcu_vector(size_type max_readers = 64)
+        : m_slot_count{checked_readers(max_readers)},
+          m_slot_block{new char[slot_block_bytes(max_readers)]},
+          m_slots{place_slots(m_slot_block.get(), max_readers)},
+          m_current{new version{vector_type{}, 0}},
+          m_epoch{1},
+          m_retired{},
+          m_spares{} {
+        for (size_type i{0}; i < m_slot_count; ++i) {
+            m_slots[i].epoch.store(0, std::memory_order_relaxed);
+            m_slots[i].claimed.store(false, std::memory_order_relaxed);
+        }
+    }
+    /**
+     * @brief Construct an rcu vector whose first version is a copy of `v`.
+     */
+    explicit rcu_vector(const vector_type& v, size_type max_readers = 64) : rcu_vector(max_readers) {
+        m_current.load(std::memory_order_relaxed)->items = v;
+    }
+    /**
+     * @brief Destroys every version; no reader may be registered anymore.
+     */
+    ~rcu_vector(void) {
+        delete m_current.load(std::memory_order_relaxed);
+        for (auto it = m_retired.begin(); it != m_retired.end(); ++it) delete *it;
+        for (auto it = m_spares.begin(); it != m_spares.end(); ++it) delete *it;
+    }
+
+    rcu_vector(const rcu_vector&) = delete;
+    rcu_vector& operator=(const rcu_vector&) = delete;
+
+    //=== [II] Writer
+    /**
+     * @brief Returns the published version (writer only).
+     */
+    const vector_type& get(void) const { return m_current.load(std::memory_order_relaxed)->items; }
+    /**
+     * @brief Publishes a copy of `next` as the new version.
+     */
+    void publish(const vector_type& next) {
+        version* v = acquire_version();
+        try {
+            v->items.assign(next.cbegin(), next.cend());
+        } catch (...) {
+            recycle(v);
+            throw;
+        }
+        publish_version(v);
+    }
+    /**
+     * @brief Publishes a modified copy of the current version.
+     *
+     * The copy is written over a reclaimed version when there is one, so its storage is
+     * reused instead of allocated.
+     *
+     * @param f Callable taking a `vector_type&` that makes the changes.
+     */
+    template <typename F>
+    void update(F f) {
+        version* v = acquire_version();
+        try {
+            const vector_type& current = get();
+            v->items.assign(current.cbegin(), current.cend());
+            f(v->items);
+        } catch (...) {
+            recycle(v);
+            throw;
+        }
+        publish_version(v);
+    }
+    /**
+     * @brief Frees (or keeps for reuse) the retired versions that no snapshot can reach.
+     *
+     * @return size_type How many retired versions are still waiting for readers.
+     */
+    size_type reclaim(void) {
+        // Oldest epoch any active snapshot may be using.
+        std::uint64_t oldest = ~std::uint64_t{0};
+        for (size_type i{0}; i < m_slot_count; ++i) {
+            std::uint64_t e = m_slots[i].epoch.load(std::memory_order_seq_cst);
+            if (e != 0 and e < oldest) oldest = e;
+        }
+
+        size_type kept{0};
+        for (size_type i{0}; i < m_retired.size(); ++i) {
+            if (m_retired[i]->retired_at < oldest)
+                recycle(m_retired[i]);
+            else
+                m_retired[kept++] = m_retired[i];
+        }
+        while (m_retired.size() > kept) m_retired.pop_back();
+        return kept;
+    }
+    /**
+     * @brief Waits until every retired version has been reclaimed.
+     */
+    void synchronize(void) {
+        while (reclaim() != 0) std::this_thread::yield();
+    }
+    /**
+     * @brief Returns the number of retired versions not reclaimed yet.
+     */
+    size_type pending(void) const { return m_retired.size(); }
+
+    /// A consistent view of one version, valid while the object lives.
+    class snapshot {
+       private:
+        const T* m_data;   //!< First element of the version.
+        size_type m_size;  //!< Number of elements of the version.
+        slot* m_slot;      //!< Announcement to clear on destruction.
+
+        friend class reader;
+
+        /// Announces the current epoch, then reads the published version.
+        snapshot(const rcu_vector& owner, slot& s) : m_data{nullptr}, m_size{0}, m_slot{&s} {
+            assert(s.epoch.load(std::memory_order_relaxed) == 0 and "one snapshot per reader at a time");
+            s.epoch.store(owner.m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            const version* v = owner.m_current.load(std::memory_order_seq_cst);
+            m_data = v->items.cbegin().base();
+            m_size = v->items.size();
+        }
+
+       public:
+        snapshot(const snapshot&) = delete;
+        snapshot& operator=(const snapshot&) = delete;
+        /**
+         * @brief Takes over the view of `other`.
+         */
+        snapshot(snapshot&& other) noexcept : m_data{other.m_data}, m_size{other.m_size}, m_slot{other.m_slot} {
+            other.m_slot = nullptr;
+        }
+        /**
+         * @brief Releases the version, letting the writer reclaim it.
+         */
+        ~snapshot(void) {
+            if (m_slot != nullptr) m_slot->epoch.store(0, std::memory_order_release);
+        }
+
+        /**
+         * @brief Return iterator to the first element.
+         */
+        const_iterator begin(void) const { return m_data; }
+        /**
+         * @brief Return iterator to the element following the last element.
+         */
+        const_iterator end(void) const { return m_data + m_size; }
+        /**
+         * @brief Return size of the version.
+         */
+        size_type size(void) const { return m_size; }
+        /**
+         * @brief Checks if the version is empty.
+         */
+        bool empty(void) const { return m_size == 0; }
+        /**
+         * @brief Implements the operator [].
+         */
+        const_reference operator[](size_type position) const { return m_data[position]; }
+        /**
+         * @brief Returns a pointer to the elements of the version.
+         */
+        const T* data(void) const { return m_data; }
+    };
+
+    /// Registration of a reader thread, which owns one slot while it lives.
+    class reader {
+       private:
+        const rcu_vector* m_owner;  //!< Container being read.
+        slot* m_slot;               //!< Claimed slot.
+
+       public:
+        /**
+         * @brief Claims a free reader slot of `owner`.
+         * @throw std::length_error When all the slots are taken.
+         */
+        explicit reader(const rcu_vector& owner) : m_owner{&owner}, m_slot{nullptr} {
+            for (size_type i{0}; i < owner.m_slot_count and m_slot == nullptr; ++i) {
+                bool expected = false;
+                if (owner.m_slots[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    m_slot = &owner.m_slots[i];
+            }
+            if (m_slot == nullptr)
+                throw std::length_error("[rcu_vector::reader()]: todos os leitores já estão registrados.");
+        }
+        /**
+         * @brief Gives the slot back.
+         */
+        ~reader(void) { m_slot->claimed.store(false, std::memory_order_release); }
+
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+
+        /**
+         * @brief Takes a snapshot of the published version; wait-free.
+         */
+        snapshot read(void) const { return snapshot(*m_owner, *m_slot); }
+    };
+};  // class rcu_vector.
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,534 @@
+#ifndef _RING_VECTOR_H_
+#define _RING_VECTOR_H_
+
+#include <algorithm>         // std::rotate
+#include <cstddef>           // std::ptrdiff_t
+#include <initializer_list>  // std::initializer_list
+#include <iterator>          // std::random_access_iterator_tag
+#include <memory>            // std::allocator, std::allocator_traits
+#include <stdexcept>         // std::out_of_range, std::length_error
+#include <utility>           // std::forward, std::move, std::move_if_noexcept
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Iterator over a circular buffer: walks the logical positions and wraps around the storage end.
+template <class T>
+class ring_iterator {
+   public:
+    typedef ring_iterator self_type;                            //!< Alias to iterator.
+    typedef std::ptrdiff_t difference_type;                     //!< Distance between iterators.
+    typedef T value_type;                                       //!< Value type the iterator points to.
+    typedef T* pointer;                                         //!< Pointer to the value type.
+    typedef T& reference;                                       //!< Reference to the value type.
+    typedef std::random_access_iterator_tag iterator_category;  //!< Iterator category.
+
+   private:
+    pointer m_base;          //!< Start of the storage area.
+    std::size_t m_capacity;  //!< Number of slots in the storage area.
+    std::size_t m_head;      //!< Slot of the first element.
+    std::size_t m_index;     //!< Logical position.
+
+    template <class U>
+    friend class ring_iterator;
+
+   public:
+    //=== [I] CONSTRUCTORS
+    /**
+     * @brief Construct an iterator at logical position `index` of a ring starting at slot `head`.
+     */
+    ring_iterator(pointer base = nullptr, std::size_t capacity = 0, std::size_t head = 0, std::size_t index = 0)
+        : m_base{base}, m_capacity{capacity}, m_head{head}, m_index{index} {}
+    /**
+     * @brief Converts a mutable iterator into a constant one.
+     */
+    template <class U>
+    ring_iterator(const ring_iterator<U>& other)
+        : m_base{other.m_base}, m_capacity{other.m_capacity}, m_head{other.m_head}, m_index{other.m_index} {}
+
+    //=== [II] OPERATORS
+    /**
+     * @brief The unary indirection operator.
+     */
+    reference operator*() const {
+        std::size_t slot = m_head + m_index;
+        return m_base[slot < m_capacity ? slot : slot - m_capacity];
+    }
+    /**
+     * @brief The operator prefix increment.
+     */
+    ring_iterator& operator++() {
+        ++m_index;
+        return *this;
+    }
+    /**
+     * @brief The operator postfix increment.
+     */
+    ring_iterator operator++(int) {
+        ring_iterator it = *this;
+        ++(*this);
+        return it;
+    }
+    /**
+     * @brief The operator prefix decrement.
+     */
+    ring_iterator& operator--() {
+        --m_index;
+        return *this;
+    }
+    /**
+     * @brief The operator postfix decrement.
+     */
+    ring_iterator operator--(int) {
+        ring_iterator it = *this;
+        --(*this);
+        return it;
+    }
+    /**
+     * @brief The subscript operator.
+     */
+    reference operator[](difference_type n) const { return *(*this + n); }
+    /**
+     * @brief The distance between two iterators.
+     */
+    difference_type operator-(const ring_iterator& other) const {
+        return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index);
+    }
+    /**
+     * @brief The equality operator.
+     */
+    bool operator==(const ring_iterator& other) const { return m_index == other.m_index and m_base == other.m_base; }
+    /**
+     * @brief The inequality operator.
+     */
+    bool operator!=(const ring_iterator& other) const { return not(*this == other); }
+    /**
+     * @brief The operator less than.
+     */
+    bool operator<(const ring_iterator& other) const { return m_index < other.m_index; }
+
+    //=== [III] Friend functions.
+    /**
+     * @brief The operation of sum between difference_type and ring_iterator.
+     */
+    friend ring_iterator operator+(difference_type lhs, ring_iterator rhs) {
+        rhs.m_index += lhs;
+        return rhs;
+    }
+    /**
+     * @brief The operation of sum between ring_iterator and difference_type.
+     */
+    friend ring_iterator operator+(ring_iterator lhs, difference_type rhs) {
+        lhs.m_index += rhs;
+        return lhs;
+    }
+    /**
+     * @brief The operation of minus between ring_iterator and difference_type.
+     */
+    friend ring_iterator operator-(ring_iterator lhs, difference_type rhs) {
+        lhs.m_index -= rhs;
+        return lhs;
+    }
+};
+
+/// This class implements a double-ended queue with a growable circular buffer.
+/*!
+ * The elements occupy `size()` consecutive slots starting at the *head*, wrapping around
+ * the end of the storage area, so push and pop at either end are O(1) amortized and never
+ * shift the other elements. When the buffer is full it grows by half, as sc::vector does,
+ * unwrapping the contents at the start of the new storage area.
+ *
+ * The contents are at most two contiguous blocks; as_spans() exposes them for bulk
+ * processing and linearize() turns them into one.
+ *
+ * \tparam T The type of the elements.
+ */
+template <typename T>
+class ring_vector {
+   public:
+    using size_type = unsigned long;               //!< The size type.
+    using value_type = T;                          //!< The value type.
+    using pointer = T*;                            //!< Pointer to a value stored in the container.
+    using const_pointer = const T*;                //!< Pointer to a constant value stored in the container.
+    using reference = T&;                          //!< Reference to a value stored in the container.
+    using const_reference = const T&;              //!< Const reference to a value stored in the container.
+    using iterator = ring_iterator<T>;             //!< The iterator.
+    using const_iterator = ring_iterator<const T>; //!< The const_iterator.
+    using allocator_type = std::allocator<T>;      //!< The allocator that provides the storage area.
+
+    /// A contiguous block of elements.
+    template <typename P>
+    struct basic_segment {
+        P data;          //!< First element of the block.
+        size_type size;  //!< Number of elements in the block.
+    };
+    using segment = basic_segment<pointer>;              //!< A block of mutable elements.
+    using const_segment = basic_segment<const_pointer>;  //!< A block of constant elements.
+
+   private:
+    using alloc_traits = std::allocator_traits<allocator_type>;  //!< Allocator interface.
+
+    size_type m_head;      //!< Slot of the first element.
+    size_type m_size;      //!< Number of elements.
+    size_type m_capacity;  //!< The list's storage capacity.
+    pointer m_storage;     //!< The list's data storage area.
+
+    //=== Storage helpers.
+    /// Allocates raw room for `n` elements.
+    static pointer allocate_storage(size_type n) {
+        allocator_type alloc;
+        return n == 0 ? nullptr : alloc_traits::allocate(alloc, n);
+    }
+    /// Returns the storage slot of the logical position `i`.
+    size_type slot(size_type i) const {
+        size_type s = m_head + i;
+        return s < m_capacity ? s : s - m_capacity;
+    }
+    /// Destroys every element and frees the storage area.
+    void release_storage(void) {
+        clear();
+        allocator_type alloc;
+        if (m_storage != nullptr) alloc_traits::deallocate(alloc, m_storage, m_capacity);
+        m_storage = nullptr;
+        m_capacity = 0;
+    }
+    /// Moves the elements, unwrapped, to the start of a new storage area of `new_cap` slots.
+    void reallocate(size_type new_cap) {
+        allocator_type alloc;
+        pointer temp = allocate_storage(new_cap);
+        for (size_type i{0}; i < m_size; ++i) {
+            pointer from = m_storage + slot(i);
+            alloc_traits::construct(alloc, temp + i, std::move_if_noexcept(*from));
+            alloc_traits::destroy(alloc, from);
+        }
+        if (m_storage != nullptr) alloc_traits::deallocate(alloc, m_storage, m_capacity);
+        m_storage = temp;
+        m_capacity = new_cap;
+        m_head = 0;
+    }
+    /// Grows the storage area when it is full.
+    void grow_if_full(void) {
+        if (m_size == m_capacity) reallocate(m_capacity + (m_capacity / 2) + 1);
+    }
+    /// Constructs a new last element from `value`.
+    template <typename U>
+    void emplace_back(U&& value) {
+        allocator_type alloc;
+        alloc_traits::construct(alloc, m_storage + slot(m_size), std::forward<U>(value));
+        ++m_size;
+    }
+    /// Constructs a new first element from `value`.
+    template <typename U>
+    void emplace_front(U&& value) {
+        allocator_type alloc;
+        size_type new_head = m_head == 0 ? m_capacity - 1 : m_head - 1;
+        alloc_traits::construct(alloc, m_storage + new_head, std::forward<U>(value));
+        m_head = new_head;
+        ++m_size;
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct a new ring vector with `count` value-initialized elements.
+     *
+     * @param count Number of elements.
+     */
+    explicit ring_vector(size_type count = 0)
+        : m_head{0}, m_size{0}, m_capacity{count}, m_storage{allocate_storage(count)} {
+        allocator_type alloc;
+        for (; m_size < count; m_size++) alloc_traits::construct(alloc, m_storage + m_size);
+    }
+    /**
+     * @brief Destroy the ring vector object.
+     */
+    ~ring_vector(void) { release_storage(); }
+    /**
+     * @brief Construct a new ring vector identical to `other`, unwrapped.
+     *
+     * @param other Another ring vector.
+     */
+    ring_vector(const ring_vector& other) : ring_vector() {
+        reserve(other.size());
+        for (const auto& e : other) emplace_back(e);
+    }
+    /**
+     * @brief Construct a new ring vector from an initializer list.
+     *
+     * @param il Initializer list to copy.
+     */
+    ring_vector(std::initializer_list<value_type> il) : ring_vector() {
+        reserve(il.size());
+        for (const auto& e : il) emplace_back(e);
+    }
+    /**
+     * @brief Constructs the container with the contents of the range [first, last).
+     *
+     * @param first Iterator to the beginning of range.
+     * @param last Iterator to the location just past the last valid value of the range.
+     */
+    template <typename InputItr>
+    ring_vector(InputItr first, InputItr last) : ring_vector() {
+        for (; first != last; ++first) push_back(*first);
+    }
+    /**
+     * @brief Implements the operator = that replaces the container's contents.
+     *
+     * @param other Another container to use as data source.
+     * @return The ring vector with its updated content.
+     */
+    ring_vector& operator=(const ring_vector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            for (const auto& e : other) emplace_back(e);
+        }
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /**
+     * @brief Return iterator to the first element.
+     */
+    iterator begin(void) { return iterator(m_storage, m_capacity, m_head, 0); }
+    /**
+     * @brief Return iterator to the element following the last element.
+     */
+    iterator end(void) { return iterator(m_storage, m_capacity, m_head, m_size); }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator cbegin(void) const { return const_iterator(m_storage, m_capacity, m_head, 0); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator cend(void) const { return const_iterator(m_storage, m_capacity, m_head, m_size); }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator begin(void) const { return cbegin(); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator end(void) const { return cend(); }
+
+    //=== [III] Capacity
+    /**
+     * @brief Return size of the ring vector.
+     */
+    size_type size(void) const { return m_size; }
+    /**
+     * @brief Return capacity of the ring vector.
+     */
+    size_type capacity(void) const { return m_capacity; }
+    /**
+     * @brief Checks if the ring vector is empty.
+     */
+    bool empty(void) const { return m_size == 0; }
+    /**
+     * @brief Checks if the ring vector is full, i.e. the next push will grow it.
+     */
+    bool full(void) const { return m_size == m_capacity; }
+
+    //=== [IV] Modifiers
+    /**
+     * @brief Erases all elements from the list.
+     */
+    void clear(void) {
+        allocator_type alloc;
+        for (size_type i{0}; i < m_size; ++i) alloc_traits::destroy(alloc, m_storage + slot(i));
+        m_head = m_size = 0;
+    }
+    /**
+     * @brief Appends the given element value to the end of the container.
+     * @param value the value of the element to append.
+     */
+    void push_back(const_reference value) {
+        if (full()) {
+            value_type copy(value);  // `value` may be one of our elements.
+            grow_if_full();
+            emplace_back(std::move(copy));
+        } else {
+            emplace_back(value);
+        }
+    }
+    /**
+     * @brief Prepends the given element value to the beginning of the container.
+     * @param value the value of the element to prepend.
+     */
+    void push_front(const_reference value) {
+        if (full()) {
+            value_type copy(value);  // `value` may be one of our elements.
+            grow_if_full();
+            emplace_front(std::move(copy));
+        } else {
+            emplace_front(value);
+        }
+    }
+    /**
+     * @brief Removes the last element of the container, if it exists.
+     */
+    void pop_back(void) {
+        if (empty())
+            throw std::length_error("[ring_vector::pop_back()]: não é possível remover um elemento de um vetor vazio.");
+
+        allocator_type alloc;
+        alloc_traits::destroy(alloc, m_storage + slot(--m_size));
+    }
+    /**
+     * @brief Removes the first element of the container, if it exists.
+     */
+    void pop_front(void) {
+        if (empty())
+            throw std::length_error("[ring_vector::pop_front()]: não é possível remover um elemento de um vetor vazio.");
+
+        allocator_type alloc;
+        alloc_traits::destroy(alloc, m_storage + m_head);
+        m_head = slot(1);
+        if (--m_size == 0) m_head = 0;
+    }
+    /**
+     * @brief Increase the capacity of the ring vector to a value that's greater or equal to new_cap.
+     * @param new_cap new capacity of the ring vector.
+     */
+    void reserve(size_type new_cap) {
+        if (new_cap > m_capacity) reallocate(new_cap);
+    }
+    /**
+     * @brief Requests the removal of unused capacity.
+     */
+    void shrink_to_fit(void) {
+        if (m_size != m_capacity) reallocate(m_size);
+    }
+    /**
+     * @brief Rotates the contents in place so that they form a single contiguous block.
+     *
+     * Does nothing when the contents do not wrap around. Otherwise the block at the end of the
+     * storage slides down next to the one at the start, through the free slots between them,
+     * and one std::rotate puts it first; nothing is allocated.
+     *
+     * @return pointer The first element of the block.
+     */
+    pointer linearize(void) {
+        if (m_head + m_size <= m_capacity) return m_storage + m_head;
+
+        // [m_head, m_capacity) holds the first `front` elements and [0, back) the others.
+        allocator_type alloc;
+        size_type front = m_capacity - m_head;
+        size_type back = m_size - front;
+        if (back < m_head) {
+            // Low to high: into free slots by construction, over moved-from ones by assignment.
+            for (size_type i{0}; i < front; ++i) {
+                pointer to = m_storage + back + i;
+                if (back + i < m_head)
+                    alloc_traits::construct(alloc, to, std::move(m_storage[m_head + i]));
+                else
+                    *to = std::move(m_storage[m_head + i]);
+            }
+            size_type first_left = back + front > m_head ? back + front : m_head;
+            for (size_type i{first_left}; i < m_capacity; ++i) alloc_traits::destroy(alloc, m_storage + i);
+        }
+        std::rotate(m_storage, m_storage + back, m_storage + m_size);
+        m_head = 0;
+        return m_storage;
+    }
+
+    //=== [V] Element access
+    /**
+     * @brief Implements the operator [], wrapping around the storage end.
+     */
+    const_reference operator[](size_type position) const { return m_storage[slot(position)]; }
+    /**
+     * @brief Implements the operator [], wrapping around the storage end.
+     */
+    reference operator[](size_type position) { return m_storage[slot(position)]; }
+    /**
+     * @brief Returns element at index `position`.
+     */
+    const_reference at(size_type position) const {
+        if (position >= m_size) throw std::out_of_range("[ring_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Returns element at index `position`, for eventual content alteration.
+     */
+    reference at(size_type position) {
+        if (position >= m_size) throw std::out_of_range("[ring_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return (*this)[position];
+    }
+    /**
+     * @brief Return the constant first element of the list.
+     */
+    const_reference front(void) const {
+        if (empty()) throw std::length_error("[ring_vector::front()]: vetor vazio.");
+
+        return (*this)[0];
+    }
+    /**
+     * @brief Return the constant last element of the list.
+     */
+    const_reference back(void) const {
+        if (empty()) throw std::length_error("[ring_vector::back()]: vetor vazio.");
+
+        return (*this)[m_size - 1];
+    }
+    /**
+     * @brief Returns the element at the beginning of the list.
+     */
+    reference front(void) { return (*this)[0]; }
+    /**
+     * @brief Returns the element at the end of the list.
+     */
+    reference back(void) { return (*this)[m_size - 1]; }
+    /**
+     * @brief Returns the contents as two contiguous blocks, in order.
+     *
+     * The second block is empty when the contents do not wrap around.
+     *
+     * @return std::pair<segment, segment> The blocks [head, storage end) and [storage start, tail).
+     */
+    std::pair<segment, segment> as_spans(void) {
+        size_type first = m_capacity - m_head < m_size ? m_capacity - m_head : m_size;
+        return {segment{m_storage + m_head, first}, segment{m_storage, m_size - first}};
+    }
+    /**
+     * @brief Returns the constant contents as two contiguous blocks, in order.
+     *
+     * @return std::pair<const_segment, const_segment> The blocks [head, storage end) and [storage start, tail).
+     */
+    std::pair<const_segment, const_segment> as_spans(void) const {
+        size_type first = m_capacity - m_head < m_size ? m_capacity - m_head : m_size;
+        return {const_segment{m_storage + m_head, first}, const_segment{m_storage, m_size - first}};
+    }
+};  // class ring_vector.
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal.
+ * @param lhs ring vector whose content is compared with `rhs`.
+ * @param rhs ring vector whose content is compared with `lhs`.
+ * @return true if the contents of the ring vectors are equal, false otherwise.
+ */
+template <typename T>
+bool operator==(const ring_vector<T>& lhs, const ring_vector<T>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+
+    for (typename ring_vector<T>::size_type i = 0; i < lhs.size(); i++)
+        if (lhs[i] != rhs[i]) return false;
+
+    return true;
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ * @param lhs ring vector whose content is compared with `rhs`.
+ * @param rhs ring vector whose content is compared with `lhs`.
+ * @return true if the contents of the ring vectors are not equal, false otherwise.
+ */
+template <typename T>
+bool operator!=(const ring_vector<T>& lhs, const ring_vector<T>& rhs) {
+    return not(lhs == rhs);
+}
+
+}  // namespace sc.
+#endif
@@ -0,0 +1,357 @@
+#ifndef _SHM_VECTOR_H_
+#define _SHM_VECTOR_H_
+
+#include <atomic>        // std::atomic, std::atomic_thread_fence
+#include <cerrno>        // errno
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t, std::uint64_t
+#include <cstring>       // std::memcpy
+#include <new>           // placement new
+#include <stdexcept>     // std::length_error, std::invalid_argument, std::logic_error
+#include <string>        // std::string
+#include <system_error>  // std::system_error
+#include <thread>        // std::this_thread::yield
+#include <type_traits>   // std::is_trivially_copyable
+#include <utility>       // std::swap
+
+#include <fcntl.h>     // O_* flags
+#include <sys/mman.h>  // shm_open, mmap, memfd_create (Linux)
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // ftruncate, close, dup
+
+#include "span.h"  // Also vector.h.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// How a process maps an sc::shm_vector.
+enum class shm_access : int { read_only, read_write };
+
+/// Implementation details.
+namespace detail {
+
+/// Start of a shared region: everything in it is an offset or a number, never a pointer, so
+/// each process may map the region at its own address.
+struct shm_header {
+    std::uint64_t magic;                  //!< shm_magic, once the header is complete.
+    std::uint32_t version;                //!< Layout version.
+    std::uint32_t element_size;           //!< sizeof(T) of the creator, checked by open().
+    std::uint64_t capacity;               //!< Room for this many elements.
+    std::uint64_t data_offset;            //!< Bytes from the header to the first element.
+    std::atomic<std::uint64_t> size;      //!< Published elements, [0, size).
+    std::atomic<std::uint64_t> reserved;  //!< Elements claimed by appenders, published or not.
+    std::atomic<std::uint64_t> sequence;  //!< Sequence lock: odd while the elements are changed in place.
+};
+
+/// Identifies a region made by sc::shm_vector ("SCSHMVEC").
+enum : std::uint64_t { shm_magic = 0x5343534853564543ULL };
+
+/// Offset of the first element: past the header, at a cache line (or stricter alignment) boundary.
+template <typename T>
+std::size_t shm_data_offset(void) {
+    const std::size_t align = alignof(T) > 64 ? alignof(T) : 64;
+    return (sizeof(shm_header) + align - 1) / align * align;
+}
+
+/// Throws the error in `errno` as a std::system_error.
+[[noreturn]] inline void shm_fail(const char* what) { throw std::system_error(errno, std::generic_category(), what); }
+
+}  // namespace detail.
+
+/// A fixed-capacity vector in shared memory, for zero-copy handoff between processes.
+/*!
+ * The region (a POSIX shared memory object, or a memfd on Linux) holds a small header (size,
+ * capacity, a sequence lock) and the elements; it stores offsets only, so every process maps
+ * it wherever it likes. Producers map it read-write and append in place; consumers may map it
+ * read-only and iterate the elements where they are, with no copy:
+ *
+ *     // Producer.
+ *     auto out = sc::shm_vector<sample>::create("/samples", 1 << 20);
+ *     out.append(batch);
+ *     // Consumer, in another process.
+ *     auto in = sc::shm_vector<sample>::open("/samples");
+ *     for (const sample& s : in) use(s);
+ *
+ * Appending writes the elements first and publishes them by storing the size (release), so
+ * readers see only complete elements, and an element, once published, is never moved: plain
+ * iteration is safe while others append. Several processes may append at once: each claims
+ * its room with a compare-and-swap and publishes after the earlier claims.
+ *
+ * Changes in place (modify(), clear()) run under the sequence lock; readers that may overlap
+ * them use read(), which retries until it saw no change. Only one process may change the
+ * elements in place at a time, and not while others append.
+ *
+ * The capacity is fixed when the region is created: growing would move the mapping in
+ * every process.
+ *
+ * \tparam T The type of the elements, trivially copyable (no pointers into a process).
+ */
+template <typename T>
+class shm_vector {
+    static_assert(std::is_trivially_copyable<T>::value, "shm_vector elements must be trivially copyable");
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shm_vector needs lock-free 64-bit atomics to share them");
+
+   public:
+    using size_type = std::size_t;       //!< The size type.
+    using value_type = T;                //!< The value type.
+    using const_reference = const T&;    //!< Const reference to a value in the region.
+    using const_iterator = const T*;     //!< Elements are iterated through plain pointers.
+
+   private:
+    int m_fd;          //!< Descriptor of the region.
+    void* m_base;      //!< Where this process mapped it.
+    size_type m_bytes;  //!< Length of the mapping.
+    bool m_writable;   //!< Whether the mapping allows writes.
+
+    detail::shm_header* header(void) const { return static_cast<detail::shm_header*>(m_base); }
+    T* elements(void) const {
+        return reinterpret_cast<T*>(static_cast<char*>(m_base) + header()->data_offset);
+    }
+    void require_writable(const char* what) const {
+        if (not m_writable) throw std::logic_error(std::string(what) + ": mapeamento somente leitura.");
+    }
+
+    /// Maps the region of `fd`, which it then owns; writes a new header with `capacity` if `init`.
+    shm_vector(int fd, shm_access access, bool init, size_type capacity)
+        : m_fd{fd}, m_base{nullptr}, m_bytes{0}, m_writable{access == shm_access::read_write} {
+        try {
+            if (init) {
+                if (capacity > (size_type(-1) - detail::shm_data_offset<T>()) / sizeof(T))
+                    throw std::length_error("[shm_vector]: capacidade máxima do tipo de tamanho excedida.");
+                m_bytes = detail::shm_data_offset<T>() + capacity * sizeof(T);
+                if (::ftruncate(m_fd, static_cast<off_t>(m_bytes)) != 0) detail::shm_fail("[shm_vector]: ftruncate");
+            } else {
+                struct stat info;
+                if (::fstat(m_fd, &info) != 0) detail::shm_fail("[shm_vector]: fstat");
+                m_bytes = static_cast<size_type>(info.st_size);
+                if (m_bytes < sizeof(detail::shm_header))
+                    throw std::invalid_argument("[shm_vector]: a região não contém um shm_vector.");
+            }
+            int prot = m_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* base = ::mmap(nullptr, m_bytes, prot, MAP_SHARED, m_fd, 0);
+            if (base == MAP_FAILED) detail::shm_fail("[shm_vector]: mmap");
+            m_base = base;
+
+            detail::shm_header* h = header();
+            if (init) {
+                ::new (static_cast<void*>(h)) detail::shm_header{};
+                h->version = 1;
+                h->element_size = static_cast<std::uint32_t>(sizeof(T));
+                h->capacity = capacity;
+                h->data_offset = detail::shm_data_offset<T>();
+                std::atomic_thread_fence(std::memory_order_release);
+                h->magic = detail::shm_magic;
+            } else if (h->magic != detail::shm_magic or h->version != 1) {
+                throw std::invalid_argument("[shm_vector]: a região não contém um shm_vector.");
+            } else if (h->element_size != sizeof(T)) {
+                throw std::invalid_argument("[shm_vector]: tamanho de elemento diferente do da região.");
+            } else if (h->data_offset + h->capacity * sizeof(T) > m_bytes) {
+                throw std::invalid_argument("[shm_vector]: região menor que a capacidade anunciada.");
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    /// Unmaps the region and closes its descriptor.
+    void release(void) {
+        if (m_base != nullptr) ::munmap(m_base, m_bytes);
+        if (m_fd >= 0) ::close(m_fd);
+        m_base = nullptr;
+        m_fd = -1;
+    }
+
+   public:
+    //=== [I] CREATION
+    /**
+     * @brief Creates the shared memory object `name` (e.g. "/frames") with room for `capacity` elements.
+     *
+     * @throws std::system_error if the object exists or cannot be created; std::length_error if
+     * `capacity` elements do not fit in size_type bytes.
+     */
+    static shm_vector create(const std::string& name, size_type capacity) {
+        int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) detail::shm_fail("[shm_vector::create()]: shm_open");
+        try {
+            return shm_vector(fd, shm_access::read_write, true, capacity);
+        } catch (...) {
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+    }
+    /**
+     * @brief Maps the shared memory object `name`, made by create().
+     *
+     * @throws std::system_error if it cannot be opened; std::invalid_argument if it does not
+     * hold an shm_vector of elements of this size.
+     */
+    static shm_vector open(const std::string& name, shm_access access = shm_access::read_only) {
+        int fd = ::shm_open(name.c_str(), access == shm_access::read_write ? O_RDWR : O_RDONLY, 0);
+        if (fd < 0) detail::shm_fail("[shm_vector::open()]: shm_open");
+        return shm_vector(fd, access, false, 0);
+    }
+    /**
+     * @brief Maps the region of the descriptor `fd`, e.g. inherited or received over a socket;
+     * `fd` is duplicated, so the caller keeps its own.
+     */
+    static shm_vector from_fd(int fd, shm_access access = shm_access::read_only) {
+        int own = ::dup(fd);
+        if (own < 0) detail::shm_fail("[shm_vector::from_fd()]: dup");
+        return shm_vector(own, access, false, 0);
+    }
+#if defined(__linux__)
+    /**
+     * @brief Creates an unnamed region (a memfd) with room for `capacity` elements. Other processes
+     * reach it through fd(): children inherit it, others get it over a Unix socket.
+     *
+     * @throws std::system_error if it cannot be created; std::length_error as create().
+     */
+    static shm_vector create_anonymous(size_type capacity) {
+        int fd = ::memfd_create("sc::shm_vector", 0);
+        if (fd < 0) detail::shm_fail("[shm_vector::create_anonymous()]: memfd_create");
+        return shm_vector(fd, shm_access::read_write, true, capacity);
+    }
+#endif
+    /**
+     * @brief Removes the name of a shared memory object; the mappings stay valid until closed.
+     * @return Whether the name existed.
+     */
+    static bool unlink(const std::string& name) { return ::shm_unlink(name.c_str()) == 0; }
+
+    //=== [II] SPECIAL MEMBERS
+    shm_vector(shm_vector&& other) noexcept
+        : m_fd{other.m_fd}, m_base{other.m_base}, m_bytes{other.m_bytes}, m_writable{other.m_writable} {
+        other.m_fd = -1;
+        other.m_base = nullptr;
+    }
+    shm_vector& operator=(shm_vector&& other) noexcept {
+        std::swap(m_fd, other.m_fd);
+        std::swap(m_base, other.m_base);
+        std::swap(m_bytes, other.m_bytes);
+        std::swap(m_writable, other.m_writable);
+        return *this;
+    }
+    shm_vector(const shm_vector&) = delete;
+    shm_vector& operator=(const shm_vector&) = delete;
+    /**
+     * @brief Unmaps the region; it lives on while other processes map it (or, if named, until unlinked).
+     */
+    ~shm_vector(void) { release(); }
+
+    //=== [III] READING
+    /// Number of published elements.
+    size_type size(void) const { return static_cast<size_type>(header()->size.load(std::memory_order_acquire)); }
+    /// Room for this many elements.
+    size_type capacity(void) const { return static_cast<size_type>(header()->capacity); }
+    /// Whether no element is published.
+    bool empty(void) const { return size() == 0; }
+    /// Returns a pointer to the first element, in this process's mapping.
+    const T* data(void) const { return elements(); }
+    /// Returns an iterator to the first element.
+    const_iterator begin(void) const { return elements(); }
+    /// Returns an iterator past the elements published when called.
+    const_iterator end(void) const { return elements() + size(); }
+    /// Returns the element at `position`, unchecked.
+    const_reference operator[](size_type position) const { return elements()[position]; }
+    /// The elements published when called, viewed in place.
+    span<const T> view(void) const { return span<const T>(elements(), size()); }
+    /// Current value of the sequence lock: odd while the elements are changed in place.
+    std::uint64_t sequence(void) const { return header()->sequence.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Returns `f(view())` from a moment when no change in place was running.
+     *
+     * `f` runs again whenever a change overlapped it, so it may see torn values in the runs
+     * that are thrown away: it must only read them (no side effects, no indexing with them).
+     */
+    template <typename F>
+    auto read(F f) const -> decltype(f(span<const T>())) {
+        detail::shm_header* h = header();
+        for (;;) {
+            std::uint64_t before = h->sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            auto result = f(view());
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (h->sequence.load(std::memory_order_relaxed) == before) return result;
+        }
+    }
+    /// A consistent private copy of the elements.
+    sc::vector<T> snapshot(void) const {
+        return read([](span<const T> s) { return sc::vector<T>(s.begin(), s.end()); });
+    }
+
+    //=== [IV] WRITING (read-write mappings)
+    /// Whether this mapping allows writes.
+    bool writable(void) const { return m_writable; }
+    /**
+     * @brief Appends `count` elements, published at once after the appends claimed before them.
+     *
+     * @throws std::length_error if they do not fit; std::logic_error on a read-only mapping.
+     */
+    void append(const T* items, size_type count) {
+        require_writable("[shm_vector::append()]");
+        detail::shm_header* h = header();
+        std::uint64_t start = h->reserved.load(std::memory_order_relaxed);
+        do {
+            if (count > h->capacity - start) throw std::length_error("[shm_vector::append()]: capacidade esgotada.");
+        } while (not h->reserved.compare_exchange_weak(start, start + count, std::memory_order_relaxed));
+        std::memcpy(static_cast<void*>(elements() + start), items, count * sizeof(T));
+        // Publishes in claim order, so the published elements stay a prefix.
+        while (h->size.load(std::memory_order_acquire) != start) std::this_thread::yield();
+        h->size.store(start + count, std::memory_order_release);
+    }
+    /**
+     * @brief Appends the elements of `items`, as append(pointer, count).
+     */
+    void append(span<const T> items) { append(items.data(), items.size()); }
+    /**
+     * @brief Appends `value`, as append(pointer, count).
+     */
+    void push_back(const T& value) { append(&value, 1); }
+    /**
+     * @brief Runs `f(span<T>)` on the published elements under the sequence lock, to change them in place.
+     *
+     * If `f` throws, the lock is still released and the exception propagates; readers then see
+     * whatever `f` had changed.
+     * @throws std::logic_error on a read-only mapping.
+     */
+    template <typename F>
+    void modify(F f) {
+        require_writable("[shm_vector::modify()]");
+        detail::shm_header* h = header();
+        std::uint64_t s = h->sequence.load(std::memory_order_relaxed);
+        h->sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        try {
+            f(span<T>(elements(), size()));
+        } catch (...) {
+            h->sequence.store(s + 2, std::memory_order_release);
+            throw;
+        }
+        h->sequence.store(s + 2, std::memory_order_release);
+    }
+    /**
+     * @brief Removes all elements, under the sequence lock.
+     * @throws std::logic_error on a read-only mapping.
+     */
+    void clear(void) {
+        require_writable("[shm_vector::clear()]");
+        detail::shm_header* h = header();
+        std::uint64_t s = h->sequence.load(std::memory_order_relaxed);
+        h->sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        h->size.store(0, std::memory_order_relaxed);
+        h->reserved.store(0, std::memory_order_relaxed);
+        h->sequence.store(s + 2, std::memory_order_release);
+    }
+
+    /// Descriptor of the region, to hand it to another process.
+    int fd(void) const { return m_fd; }
+};
+
+}  // namespace sc.
+#endif
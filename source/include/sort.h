@@ -0,0 +1,435 @@
+#ifndef _SORT_H_
+#define _SORT_H_
+
+#include <algorithm>    // std::sort, std::stable_sort, std::upper_bound
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint32_t, std::uint64_t
+#include <cstring>      // std::memcpy (float keys)
+#include <limits>       // std::numeric_limits
+#include <new>          // placement new
+#include <thread>       // std::thread::hardware_concurrency
+#include <type_traits>  // std::is_integral, std::make_unsigned, std::is_trivially_copy_constructible
+#include <utility>      // std::pair, std::declval
+#include <vector>       // std::vector (samples and splitters)
+
+#include "span.h"  // Also vector.h, and detail::run_on_threads() from parallel.h.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Maps a key to an unsigned integer with the same order, for radix sorting; disabled by default.
+template <typename K, typename = void>
+struct radix_traits {
+    static constexpr bool enabled = false;  //!< Whether `K` is radix sortable.
+};
+
+/// Integers (but `bool`): the sign bit is flipped so negative values come first.
+template <typename K>
+struct radix_traits<K, typename std::enable_if<std::is_integral<K>::value and not std::is_same<K, bool>::value>::type> {
+    static constexpr bool enabled = true;                  //!< Whether `K` is radix sortable.
+    using bits_type = typename std::make_unsigned<K>::type;  //!< Unsigned image of the key.
+
+    /// Returns the unsigned image of `k`.
+    static bits_type encode(K k) {
+        return std::is_signed<K>::value
+                   ? static_cast<bits_type>(static_cast<bits_type>(k) ^ (bits_type{1} << (sizeof(K) * 8 - 1)))
+                   : static_cast<bits_type>(k);
+    }
+};
+
+/// IEEE floats: negative values have all their bits flipped, positive ones only the sign bit.
+/*!
+ * The result is a total order: -0.0 comes before +0.0, and NaNs go to the ends by sign.
+ */
+template <typename K>
+struct radix_traits<K, typename std::enable_if<std::is_floating_point<K>::value and
+                                                std::numeric_limits<K>::is_iec559 and
+                                                (sizeof(K) == 4 or sizeof(K) == 8)>::type> {
+    static constexpr bool enabled = true;  //!< Whether `K` is radix sortable.
+    using bits_type = typename std::conditional<sizeof(K) == 4, std::uint32_t, std::uint64_t>::type;  //!< Image.
+
+    /// Returns the unsigned image of `k`.
+    static bits_type encode(K k) {
+        bits_type u;
+        std::memcpy(&u, &k, sizeof u);
+        const bits_type sign = bits_type{1} << (sizeof(K) * 8 - 1);
+        return (u & sign) != 0 ? static_cast<bits_type>(~u) : static_cast<bits_type>(u | sign);
+    }
+};
+
+/// Whether `K` is a scalar radix key, or a pair of them (sorted by `first`, then `second`).
+template <typename K>
+struct is_radix_key : std::integral_constant<bool, radix_traits<K>::enabled> {};
+template <typename A, typename B>
+struct is_radix_key<std::pair<A, B>>
+    : std::integral_constant<bool, radix_traits<A>::enabled and radix_traits<B>::enabled> {};
+
+/// Returns `k` as something ordered by `<` exactly as the radix sort orders it.
+template <typename K>
+typename radix_traits<K>::bits_type key_order(const K& k, std::true_type) {
+    return radix_traits<K>::encode(k);
+}
+template <typename A, typename B>
+std::pair<typename radix_traits<A>::bits_type, typename radix_traits<B>::bits_type> key_order(
+    const std::pair<A, B>& k, std::true_type) {
+    return std::make_pair(radix_traits<A>::encode(k.first), radix_traits<B>::encode(k.second));
+}
+template <typename K>
+const K& key_order(const K& k, std::false_type) {
+    return k;
+}
+
+/// The key extractor of sc::sort(vec): the element itself.
+struct identity_key {
+    /// Returns `v`.
+    template <typename T>
+    const T& operator()(const T& v) const {
+        return v;
+    }
+};
+
+/// Type of the key that `Key` extracts from a `T`.
+template <typename T, typename Key>
+using key_type = typename std::decay<decltype(std::declval<const Key&>()(std::declval<const T&>()))>::type;
+
+/// Compares two elements by their keys, in the order of the radix sort.
+template <typename T, typename Key>
+struct key_less {
+    Key key;  //!< Key extractor.
+
+    /// Whether `a` goes before `b`.
+    bool operator()(const T& a, const T& b) const {
+        using K = key_type<T, Key>;
+        return key_order(key(a), is_radix_key<K>()) < key_order(key(b), is_radix_key<K>());
+    }
+};
+
+/// Extracts the `first` member of a pair key.
+template <typename Key>
+struct first_of_key {
+    Key key;  //!< Extractor of the pair.
+
+    /// Returns `key(v).first`.
+    template <typename T>
+    auto operator()(const T& v) const -> decltype(key(v).first) {
+        return key(v).first;
+    }
+};
+/// Extracts the `second` member of a pair key.
+template <typename Key>
+struct second_of_key {
+    Key key;  //!< Extractor of the pair.
+
+    /// Returns `key(v).second`.
+    template <typename T>
+    auto operator()(const T& v) const -> decltype(key(v).second) {
+        return key(v).second;
+    }
+};
+
+/// Whether elements may be copied into raw memory and overwritten without running any code,
+/// as the radix and sample sorts do: `std::pair` of scalars qualifies, unlike for is_trivially_copyable.
+template <typename T>
+struct is_plain_element
+    : std::integral_constant<bool, std::is_trivially_copy_constructible<T>::value and
+                                       std::is_trivially_destructible<T>::value> {};
+
+/// Copies `n` plain elements from `src` over the slots (raw or not) at `dst`.
+template <typename T>
+void copy_slots(T* dst, const T* src, std::size_t n) {
+    for (std::size_t i{0}; i < n; ++i) ::new (static_cast<void*>(dst + i)) T(src[i]);
+}
+
+/// LSD radix sort of [a, a + n) by the scalar key `key(x)`, with `b` as scratch of the same size.
+/*!
+ * One byte per pass; the histograms of every pass are built in a single read, and passes
+ * whose byte is the same in every key are skipped. Stable.
+ *
+ * @return T* The array holding the result, `a` or `b`.
+ */
+template <typename T, typename Key>
+T* radix_sort_scalar(T* a, T* b, std::size_t n, Key key) {
+    using traits = radix_traits<key_type<T, Key>>;
+    using bits_type = typename traits::bits_type;
+    enum : std::size_t { passes = sizeof(bits_type), buckets = 256 };
+
+    std::size_t counts[passes][buckets] = {};
+    for (std::size_t i{0}; i < n; ++i) {
+        bits_type u = traits::encode(key(a[i]));
+        for (std::size_t d{0}; d < passes; ++d) ++counts[d][(u >> (8 * d)) & 0xFF];
+    }
+
+    for (std::size_t d{0}; d < passes; ++d) {
+        std::size_t* count = counts[d];
+        bool trivial{false};
+        std::size_t sum{0};
+        for (std::size_t k{0}; k < buckets; ++k) {
+            if (count[k] == n) trivial = true;
+            std::size_t c = count[k];
+            count[k] = sum;  // The count becomes the next slot of the bucket.
+            sum += c;
+        }
+        if (trivial) continue;
+
+        for (std::size_t i{0}; i < n; ++i) {
+            bits_type u = traits::encode(key(a[i]));
+            ::new (static_cast<void*>(b + count[(u >> (8 * d)) & 0xFF]++)) T(a[i]);
+        }
+        std::swap(a, b);
+    }
+    return a;
+}
+
+/// Radix sort by a scalar key.
+template <typename T, typename Key>
+T* radix_sort(T* a, T* b, std::size_t n, Key key, std::false_type /* pair key */) {
+    return radix_sort_scalar(a, b, n, key);
+}
+/// Radix sort by a pair key: by `second`, then stably by `first`.
+template <typename T, typename Key>
+T* radix_sort(T* a, T* b, std::size_t n, Key key, std::true_type /* pair key */) {
+    T* r = radix_sort_scalar(a, b, n, second_of_key<Key>{key});
+    return radix_sort_scalar(r, r == a ? b : a, n, first_of_key<Key>{key});
+}
+
+/// Whether `K` is a pair.
+template <typename K>
+struct is_pair : std::false_type {};
+template <typename A, typename B>
+struct is_pair<std::pair<A, B>> : std::true_type {};
+
+/// Raw scratch room for `n` elements, taken from the storage strategy of the vector being sorted.
+template <typename T, typename Storage>
+class sort_buffer {
+    T* m_data;           //!< The room; its slots are never destroyed (the elements are plain).
+    std::size_t m_size;  //!< Number of slots.
+
+   public:
+    explicit sort_buffer(std::size_t n) : m_data{Storage::template allocate<T>(n)}, m_size{n} {}
+    ~sort_buffer(void) { Storage::template deallocate<T>(m_data, m_size); }
+    sort_buffer(const sort_buffer&) = delete;
+    sort_buffer& operator=(const sort_buffer&) = delete;
+
+    /// Returns the first slot.
+    T* get(void) const { return m_data; }
+};
+
+/// Below this many elements, a comparison sort beats the radix passes.
+enum : std::size_t { radix_min_size = 256 };
+
+/// Whether the elements of [data, data + n) can be radix sorted by `Key`.
+template <typename T, typename Key>
+struct radix_sortable
+    : std::integral_constant<bool, is_plain_element<T>::value and is_radix_key<key_type<T, Key>>::value> {};
+
+/// Sequential sort, comparison path: introsort, or a merge sort when it must be stable.
+template <typename Storage, typename T, typename Key>
+void sort_range(T* data, std::size_t n, Key key, bool stable, std::false_type /* radix sortable */) {
+    if (stable)
+        std::stable_sort(data, data + n, key_less<T, Key>{key});
+    else
+        std::sort(data, data + n, key_less<T, Key>{key});
+}
+/// Sequential sort, radix path.
+template <typename Storage, typename T, typename Key>
+void sort_range(T* data, std::size_t n, Key key, bool stable, std::true_type /* radix sortable */) {
+    if (n < radix_min_size) {
+        sort_range<Storage>(data, n, key, stable, std::false_type());
+        return;
+    }
+    sort_buffer<T, Storage> scratch(n);
+    T* r = radix_sort(data, scratch.get(), n, key, is_pair<key_type<T, Key>>());
+    if (r != data) copy_slots(data, r, n);
+}
+
+/// Sorts the `len` plain elements at `src` into `dst`, which serves as scratch meanwhile.
+template <typename T, typename Key>
+void sort_into(T* src, T* dst, std::size_t len, Key key, bool stable, std::false_type /* radix sortable */) {
+    if (stable)
+        std::stable_sort(src, src + len, key_less<T, Key>{key});
+    else
+        std::sort(src, src + len, key_less<T, Key>{key});
+    copy_slots(dst, src, len);
+}
+/// Sorts the `len` plain elements at `src` into `dst` with the radix sort when they are enough.
+template <typename T, typename Key>
+void sort_into(T* src, T* dst, std::size_t len, Key key, bool stable, std::true_type /* radix sortable */) {
+    if (len < radix_min_size) {
+        sort_into(src, dst, len, key, stable, std::false_type());
+        return;
+    }
+    T* r = radix_sort(src, dst, len, key, is_pair<key_type<T, Key>>());
+    if (r != dst) copy_slots(dst, r, len);
+}
+
+/// Parallel sample sort of [data, data + n) of plain elements.
+/*!
+ * Sorted samples give `threads - 1` splitters; each thread then counts and scatters its
+ * slice of the input into the buckets (in `scratch`, keeping the input order), and finally
+ * each thread sorts one bucket, using the matching part of `data` as its scratch, and
+ * leaves it in `data`. Many equal keys make one bucket large, which only costs parallelism.
+ */
+template <typename T, typename Key>
+void sample_sort(T* data, T* scratch, std::size_t n, Key key, bool stable, unsigned threads) {
+    const std::size_t oversampling = 32;
+    key_less<T, Key> less{key};
+
+    std::vector<T> samples;
+    std::size_t count = threads * oversampling;
+    for (std::size_t i{0}; i < count; ++i) samples.push_back(data[i * (n / count) + (i * 7919) % (n / count)]);
+    std::sort(samples.begin(), samples.end(), less);
+    std::vector<T> splitters;
+    for (unsigned k{1}; k < threads; ++k) splitters.push_back(samples[k * oversampling]);
+
+    // counts[t * threads + b]: elements of slice t that go to bucket b; then their first slot.
+    std::vector<std::size_t> counts(threads * threads, 0);
+    auto slice_begin = [n, threads](unsigned t) { return n / threads * t; };
+    auto slice_end = [n, threads](unsigned t) { return t + 1 == threads ? n : n / threads * (t + 1); };
+    auto bucket_of = [&](const T& v) {
+        return static_cast<std::size_t>(std::upper_bound(splitters.begin(), splitters.end(), v, less) -
+                                        splitters.begin());
+    };
+
+    run_on_threads(threads, [&](unsigned t) {
+        for (std::size_t i = slice_begin(t); i < slice_end(t); ++i) ++counts[t * threads + bucket_of(data[i])];
+    });
+    std::vector<std::size_t> bounds(threads + 1, 0);
+    std::size_t sum{0};
+    for (unsigned b{0}; b < threads; ++b) {
+        bounds[b] = sum;
+        for (unsigned t{0}; t < threads; ++t) {
+            std::size_t c = counts[t * threads + b];
+            counts[t * threads + b] = sum;
+            sum += c;
+        }
+    }
+    bounds[threads] = n;
+
+    run_on_threads(threads, [&](unsigned t) {
+        std::size_t* next = &counts[t * threads];
+        for (std::size_t i = slice_begin(t); i < slice_end(t); ++i)
+            ::new (static_cast<void*>(scratch + next[bucket_of(data[i])]++)) T(data[i]);
+    });
+    run_on_threads(threads, [&](unsigned b) {
+        std::size_t first = bounds[b];
+        sort_into(scratch + first, data + first, bounds[b + 1] - first, key, stable, radix_sortable<T, Key>());
+    });
+}
+
+/// Common part of the parallel_sort() overloads.
+template <typename Storage, typename T, typename Key>
+void parallel_sort_range(T* data, std::size_t n, Key key, bool stable, unsigned threads) {
+    const std::size_t min_chunk = 1 << 16;  // Below this, starting a thread costs more than sorting.
+
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads > n / min_chunk) threads = static_cast<unsigned>(n / min_chunk);
+    if (threads > 256) threads = 256;
+    if (threads <= 1 or not is_plain_element<T>::value) {
+        sort_range<Storage>(data, n, key, stable, radix_sortable<T, Key>());
+        return;
+    }
+    sort_buffer<T, Storage> scratch(n);
+    sample_sort(data, scratch.get(), n, key, stable, threads);
+}
+
+/// Enables an overload for key extractors: callables taking a `const T&`.
+template <typename T, typename Key>
+using if_key_extractor = decltype(std::declval<const Key&>()(std::declval<const T&>()), void());
+
+}  // namespace detail.
+
+/**
+ * @brief Sorts the elements of `vec` in ascending order.
+ *
+ * Integers and IEEE floats (and pairs of them, ordered by `first`, then `second`) are sorted
+ * with an LSD radix sort in O(n) whose scratch array comes from the vector's storage
+ * strategy; floats then follow a total order (-0.0 before +0.0, NaNs at the ends). Small
+ * vectors and other element types fall back to introsort (std::sort) with `operator<`.
+ * Not stable.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+void sort(vector<T, SizeType, ShrinkPolicy, Storage>& vec) {
+    detail::sort_range<Storage>(vec.begin().base(), vec.size(), detail::identity_key(), false,
+                                detail::radix_sortable<T, detail::identity_key>());
+}
+
+/**
+ * @brief Sorts the elements of `vec` in ascending order of `key(element)`; stable.
+ *
+ * When the key is radix sortable (see above) and the elements are trivially copyable (or
+ * pairs of such), e.g. records sorted by an integer field, the radix sort is used; otherwise a merge sort
+ * (std::stable_sort) compares the keys with `operator<`.
+ *
+ * @param key Callable taking a `const T&` and returning the key, preferably cheap to call.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage, typename Key,
+          typename = detail::if_key_extractor<T, Key>>
+void sort(vector<T, SizeType, ShrinkPolicy, Storage>& vec, Key key) {
+    detail::sort_range<Storage>(vec.begin().base(), vec.size(), key, true, detail::radix_sortable<T, Key>());
+}
+
+/**
+ * @brief Sorts `vec` as sc::sort(vec), with a sample sort on up to `threads` threads.
+ *
+ * The input is split into one bucket per thread by sampled splitters, and the buckets are
+ * sorted concurrently. Inputs too small to pay for the threads, and elements that are not
+ * trivially copyable (or pairs of such), are sorted sequentially.
+ *
+ * @param threads Maximum number of threads; 0 uses std::thread::hardware_concurrency().
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+void parallel_sort(vector<T, SizeType, ShrinkPolicy, Storage>& vec, unsigned threads = 0) {
+    detail::parallel_sort_range<Storage>(vec.begin().base(), vec.size(), detail::identity_key(), false, threads);
+}
+
+/**
+ * @brief Sorts `vec` as sc::sort(vec, key), with a sample sort on up to `threads` threads; stable.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage, typename Key,
+          typename = detail::if_key_extractor<T, Key>>
+void parallel_sort(vector<T, SizeType, ShrinkPolicy, Storage>& vec, Key key, unsigned threads = 0) {
+    detail::parallel_sort_range<Storage>(vec.begin().base(), vec.size(), key, true, threads);
+}
+
+/**
+ * @brief Sorts the elements viewed by `s` as sc::sort(vec), e.g. one part of a vector.
+ *
+ * The scratch array of the radix sort comes from the default storage strategy of `T`.
+ */
+template <typename T>
+void sort(span<T> s) {
+    detail::sort_range<typename default_vector_storage<T>::type>(s.data(), s.size(), detail::identity_key(), false,
+                                                                 detail::radix_sortable<T, detail::identity_key>());
+}
+
+/**
+ * @brief Sorts the elements viewed by `s` as sc::sort(vec, key); stable.
+ */
+template <typename T, typename Key, typename = detail::if_key_extractor<T, Key>>
+void sort(span<T> s, Key key) {
+    detail::sort_range<typename default_vector_storage<T>::type>(s.data(), s.size(), key, true,
+                                                                 detail::radix_sortable<T, Key>());
+}
+
+/**
+ * @brief Sorts the elements viewed by `s` as sc::parallel_sort(vec, threads).
+ */
+template <typename T>
+void parallel_sort(span<T> s, unsigned threads = 0) {
+    detail::parallel_sort_range<typename default_vector_storage<T>::type>(s.data(), s.size(), detail::identity_key(),
+                                                                          false, threads);
+}
+
+/**
+ * @brief Sorts the elements viewed by `s` as sc::parallel_sort(vec, key, threads); stable.
+ */
+template <typename T, typename Key, typename = detail::if_key_extractor<T, Key>>
+void parallel_sort(span<T> s, Key key, unsigned threads = 0) {
+    detail::parallel_sort_range<typename default_vector_storage<T>::type>(s.data(), s.size(), key, true, threads);
+}
+
+}  // namespace sc.
+#endif
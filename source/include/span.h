@@ -0,0 +1,349 @@
+#ifndef _SPAN_H_
+#define _SPAN_H_
+
+#include <cstddef>      // std::size_t, std::ptrdiff_t
+#include <iterator>     // std::random_access_iterator_tag
+#include <stdexcept>    // std::out_of_range, std::invalid_argument
+#include <type_traits>  // std::enable_if, std::is_convertible, std::remove_cv, std::remove_pointer
+#include <utility>      // std::declval
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+template <typename T>
+class slice;
+
+/// Implementation details.
+namespace detail {
+
+/// Whether a `U*` may be viewed as a `T*`: same type up to added const (no derived-to-base,
+/// whose elements would be read with the wrong size).
+template <typename U, typename T>
+struct is_view_convertible : std::is_convertible<U (*)[], T (*)[]> {};
+
+/// Whether `C` is a contiguous container of elements viewable as `T`: it has `data()`,
+/// returning a pointer, and `size()` (sc::vector, sc::static_vector, std::vector, std::array...).
+template <typename C, typename T, typename = void>
+struct is_contiguous_of : std::false_type {};
+template <typename C, typename T>
+struct is_contiguous_of<C, T, decltype(static_cast<void>(std::declval<C&>().size()), void())>
+    : std::integral_constant<bool, std::is_pointer<decltype(std::declval<C&>().data())>::value and
+                                       is_view_convertible<typename std::remove_pointer<decltype(
+                                                               std::declval<C&>().data())>::type,
+                                                           T>::value> {};
+
+}  // namespace detail.
+
+/// A non-owning view of a contiguous run of elements.
+/*!
+ * Two words (pointer and size), cheap to copy and pass by value. It converts implicitly from
+ * sc::vector, sc::static_vector and any other container with `data()` and `size()`, and from raw
+ * arrays, so a function taking `sc::span<const T>` accepts all of them without copies:
+ *
+ *     double mean(sc::span<const double> xs);
+ *     mean(v);                    // The whole vector.
+ *     mean(sc::span<double>(v).subspan(10, 100));
+ *
+ * A span of a vector is invalidated by the operations that invalidate its iterators.
+ */
+template <typename T>
+class span {
+   public:
+    using element_type = T;                                  //!< Type of the elements, maybe const.
+    using value_type = typename std::remove_cv<T>::type;     //!< Type of the elements.
+    using size_type = std::size_t;                           //!< The size type.
+    using difference_type = std::ptrdiff_t;                  //!< Difference between iterators.
+    using pointer = T*;                                      //!< Pointer to an element.
+    using reference = T&;                                    //!< Reference to an element.
+    using iterator = T*;                                     //!< The iterator.
+    static constexpr size_type npos = static_cast<size_type>(-1);  //!< "Up to the end", for subspan().
+
+   private:
+    T* m_data;          //!< First element.
+    size_type m_size;  //!< Number of elements.
+
+   public:
+    //=== [I] CONSTRUCTORS
+    /// An empty span.
+    constexpr span(void) noexcept : m_data{nullptr}, m_size{0} {}
+    /// A view of the `count` elements from `data`.
+    constexpr span(T* data, size_type count) noexcept : m_data{data}, m_size{count} {}
+    /// A view of [first, last).
+    constexpr span(T* first, T* last) noexcept : m_data{first}, m_size{static_cast<size_type>(last - first)} {}
+    /// A view of a raw array.
+    template <std::size_t N>
+    constexpr span(T (&array)[N]) noexcept : m_data{array}, m_size{N} {}
+    /// A view of a contiguous container; `span<const T>` for a const one.
+    template <typename C, typename = typename std::enable_if<detail::is_contiguous_of<C, T>::value>::type>
+    span(C& container) : m_data{container.data()}, m_size{static_cast<size_type>(container.size())} {}
+    /// A `span<const T>` from a `span<T>`.
+    template <typename U, typename = typename std::enable_if<detail::is_view_convertible<U, T>::value>::type>
+    constexpr span(const span<U>& other) noexcept : m_data{other.data()}, m_size{other.size()} {}
+
+    //=== [II] ITERATORS
+    /// Returns an iterator to the first element.
+    constexpr iterator begin(void) const noexcept { return m_data; }
+    /// Returns an iterator past the last element.
+    constexpr iterator end(void) const noexcept { return m_data + m_size; }
+
+    //=== [III] CAPACITY
+    /// Number of elements.
+    constexpr size_type size(void) const noexcept { return m_size; }
+    /// Number of bytes of the elements.
+    constexpr size_type size_bytes(void) const noexcept { return m_size * sizeof(T); }
+    /// Whether the span has no elements.
+    constexpr bool empty(void) const noexcept { return m_size == 0; }
+
+    //=== [IV] ELEMENT ACCESS
+    /// Returns the first element.
+    constexpr pointer data(void) const noexcept { return m_data; }
+    /// Returns the element at `position`, unchecked.
+    constexpr reference operator[](size_type position) const { return m_data[position]; }
+    /**
+     * @brief Returns the element at `position`.
+     * @throws std::out_of_range if `position` is not less than size().
+     */
+    reference at(size_type position) const {
+        if (position >= m_size) throw std::out_of_range("[span::at()]: índice fora dos limites.");
+        return m_data[position];
+    }
+    /// Returns the first element; the span must not be empty.
+    constexpr reference front(void) const { return m_data[0]; }
+    /// Returns the last element; the span must not be empty.
+    constexpr reference back(void) const { return m_data[m_size - 1]; }
+
+    //=== [V] SUBVIEWS
+    /**
+     * @brief The first `count` elements.
+     * @throws std::out_of_range if `count` exceeds size().
+     */
+    span first(size_type count) const {
+        if (count > m_size) throw std::out_of_range("[span::first()]: a visão tem menos elementos.");
+        return span(m_data, count);
+    }
+    /**
+     * @brief The last `count` elements.
+     * @throws std::out_of_range if `count` exceeds size().
+     */
+    span last(size_type count) const {
+        if (count > m_size) throw std::out_of_range("[span::last()]: a visão tem menos elementos.");
+        return span(m_data + (m_size - count), count);
+    }
+    /**
+     * @brief The `count` elements from `offset`, or all of them up to the end with `npos`.
+     * @throws std::out_of_range if the range does not fit in the span.
+     */
+    span subspan(size_type offset, size_type count = npos) const {
+        if (offset > m_size or (count != npos and count > m_size - offset))
+            throw std::out_of_range("[span::subspan()]: intervalo fora dos limites.");
+        return span(m_data + offset, count == npos ? m_size - offset : count);
+    }
+    /**
+     * @brief Every `step`-th element, starting with the first: `strided(2)` views the even indices.
+     * @throws std::invalid_argument if `step` is zero.
+     */
+    slice<T> strided(size_type step) const;
+};
+
+template <typename T>
+constexpr typename span<T>::size_type span<T>::npos;
+
+/// A non-owning view of elements at a fixed distance apart, e.g. a column of a row-major matrix.
+/*!
+ * Three words (pointer, size and stride). It comes from span::strided() or from a pointer, a
+ * count and a stride, and its iterators are random access, so the standard algorithms work on it:
+ *
+ *     sc::slice<double> column(m.data() + j, rows, cols);
+ *     std::sort(column.begin(), column.end());
+ */
+template <typename T>
+class slice {
+   public:
+    using element_type = T;                               //!< Type of the elements, maybe const.
+    using value_type = typename std::remove_cv<T>::type;  //!< Type of the elements.
+    using size_type = std::size_t;                        //!< The size type.
+    using difference_type = std::ptrdiff_t;               //!< Difference between iterators.
+    using pointer = T*;                                   //!< Pointer to an element.
+    using reference = T&;                                 //!< Reference to an element.
+
+    /// Random access iterator that moves `stride` elements at a time.
+    class iterator {
+       public:
+        using iterator_category = std::random_access_iterator_tag;  //!< Iterator category.
+        using value_type = typename std::remove_cv<T>::type;        //!< Value type the iterator points to.
+        using difference_type = std::ptrdiff_t;                      //!< Distance between iterators.
+        using pointer = T*;                                          //!< Pointer to the value type.
+        using reference = T&;                                        //!< Reference to the value type.
+
+       private:
+        // A base pointer and an index, not a moving pointer: past the last element a pointer
+        // stepped by the stride would leave the array, which is undefined.
+        T* m_data;                 //!< First element of the slice.
+        difference_type m_index;   //!< Position in the slice.
+        difference_type m_stride;  //!< Elements per step.
+
+       public:
+        iterator(T* data = nullptr, difference_type index = 0, difference_type stride = 1)
+            : m_data{data}, m_index{index}, m_stride{stride} {}
+
+        reference operator*() const { return m_data[m_index * m_stride]; }
+        pointer operator->() const { return m_data + m_index * m_stride; }
+        reference operator[](difference_type n) const { return m_data[(m_index + n) * m_stride]; }
+
+        iterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old{*this};
+            ++m_index;
+            return old;
+        }
+        iterator& operator--() {
+            --m_index;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator old{*this};
+            --m_index;
+            return old;
+        }
+        iterator& operator+=(difference_type n) {
+            m_index += n;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) {
+            m_index -= n;
+            return *this;
+        }
+        friend iterator operator+(iterator it, difference_type n) { return it += n; }
+        friend iterator operator+(difference_type n, iterator it) { return it += n; }
+        friend iterator operator-(iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const iterator& a, const iterator& b) { return a.m_index - b.m_index; }
+
+        // Iterators of the same slice only.
+        friend bool operator==(const iterator& a, const iterator& b) { return a.m_index == b.m_index; }
+        friend bool operator!=(const iterator& a, const iterator& b) { return a.m_index != b.m_index; }
+        friend bool operator<(const iterator& a, const iterator& b) { return a.m_index < b.m_index; }
+        friend bool operator>(const iterator& a, const iterator& b) { return a.m_index > b.m_index; }
+        friend bool operator<=(const iterator& a, const iterator& b) { return a.m_index <= b.m_index; }
+        friend bool operator>=(const iterator& a, const iterator& b) { return a.m_index >= b.m_index; }
+    };
+
+   private:
+    T* m_data;          //!< First element.
+    size_type m_size;  //!< Number of elements.
+    size_type m_stride;  //!< Distance between consecutive elements, in elements.
+
+   public:
+    //=== [I] CONSTRUCTORS
+    /// An empty slice.
+    slice(void) noexcept : m_data{nullptr}, m_size{0}, m_stride{1} {}
+    /**
+     * @brief A view of `count` elements, `stride` elements apart, from `data`.
+     * @throws std::invalid_argument if `stride` is zero.
+     */
+    slice(T* data, size_type count, size_type stride) : m_data{data}, m_size{count}, m_stride{stride} {
+        if (stride == 0) throw std::invalid_argument("[slice]: passo nulo.");
+    }
+    /// A view of every element of a span.
+    slice(const span<T>& s) noexcept : m_data{s.data()}, m_size{s.size()}, m_stride{1} {}
+    /// A `slice<const T>` from a `slice<T>`.
+    template <typename U, typename = typename std::enable_if<detail::is_view_convertible<U, T>::value>::type>
+    slice(const slice<U>& other) noexcept : m_data{other.data()}, m_size{other.size()}, m_stride{other.stride()} {}
+
+    //=== [II] ITERATORS
+    /// Returns an iterator to the first element.
+    iterator begin(void) const { return iterator(m_data, 0, static_cast<difference_type>(m_stride)); }
+    /// Returns an iterator past the last element.
+    iterator end(void) const {
+        return iterator(m_data, static_cast<difference_type>(m_size), static_cast<difference_type>(m_stride));
+    }
+
+    //=== [III] CAPACITY
+    /// Number of elements.
+    size_type size(void) const noexcept { return m_size; }
+    /// Distance between consecutive elements, in elements.
+    size_type stride(void) const noexcept { return m_stride; }
+    /// Whether the slice has no elements.
+    bool empty(void) const noexcept { return m_size == 0; }
+    /// Whether the elements are adjacent, so the slice can be viewed as a span.
+    bool contiguous(void) const noexcept { return m_stride == 1 or m_size < 2; }
+
+    //=== [IV] ELEMENT ACCESS
+    /// Returns the first element.
+    pointer data(void) const noexcept { return m_data; }
+    /// Returns the element at `position`, unchecked.
+    reference operator[](size_type position) const { return m_data[position * m_stride]; }
+    /**
+     * @brief Returns the element at `position`.
+     * @throws std::out_of_range if `position` is not less than size().
+     */
+    reference at(size_type position) const {
+        if (position >= m_size) throw std::out_of_range("[slice::at()]: índice fora dos limites.");
+        return m_data[position * m_stride];
+    }
+    /// Returns the first element; the slice must not be empty.
+    reference front(void) const { return m_data[0]; }
+    /// Returns the last element; the slice must not be empty.
+    reference back(void) const { return m_data[(m_size - 1) * m_stride]; }
+
+    //=== [V] SUBVIEWS
+    /**
+     * @brief The first `count` elements.
+     * @throws std::out_of_range if `count` exceeds size().
+     */
+    slice first(size_type count) const {
+        if (count > m_size) throw std::out_of_range("[slice::first()]: a visão tem menos elementos.");
+        return slice(m_data, count, m_stride);
+    }
+    /**
+     * @brief The last `count` elements.
+     * @throws std::out_of_range if `count` exceeds size().
+     */
+    slice last(size_type count) const {
+        if (count > m_size) throw std::out_of_range("[slice::last()]: a visão tem menos elementos.");
+        return subslice(m_size - count, count);
+    }
+    /**
+     * @brief The `count` elements from `offset`, or all of them up to the end with `span<T>::npos`.
+     * @throws std::out_of_range if the range does not fit in the slice.
+     */
+    slice subslice(size_type offset, size_type count = span<T>::npos) const {
+        if (offset > m_size or (count != span<T>::npos and count > m_size - offset))
+            throw std::out_of_range("[slice::subslice()]: intervalo fora dos limites.");
+        // An empty tail keeps `m_data`: stepping `offset` strides would leave the array.
+        T* start = offset < m_size ? m_data + offset * m_stride : m_data;
+        return slice(start, count == span<T>::npos ? m_size - offset : count, m_stride);
+    }
+    /**
+     * @brief Every `step`-th element of this slice, starting with the first.
+     * @throws std::invalid_argument if `step` is zero.
+     */
+    slice strided(size_type step) const {
+        if (step == 0) throw std::invalid_argument("[slice::strided()]: passo nulo.");
+        return slice(m_data, (m_size + step - 1) / step, m_stride * step);
+    }
+};
+
+template <typename T>
+slice<T> span<T>::strided(size_type step) const {
+    return slice<T>(*this).strided(step);
+}
+
+/// Views the bytes of the elements of `s`, e.g. to write them to a file without a copy.
+template <typename T>
+span<const unsigned char> as_bytes(span<T> s) noexcept {
+    return span<const unsigned char>(reinterpret_cast<const unsigned char*>(s.data()), s.size_bytes());
+}
+
+/// Views the bytes of the elements of `s` for writing, e.g. to read a file into them without a copy.
+template <typename T, typename = typename std::enable_if<not std::is_const<T>::value>::type>
+span<unsigned char> as_writable_bytes(span<T> s) noexcept {
+    return span<unsigned char>(reinterpret_cast<unsigned char*>(s.data()), s.size_bytes());
+}
+
+}  // namespace sc.
+#endif
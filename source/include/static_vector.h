@@ -0,0 +1,506 @@
+#ifndef _STATIC_VECTOR_H_
+#define _STATIC_VECTOR_H_
+
+#include <algorithm>         // std::rotate, std::move
+#include <cstddef>           // std::size_t
+#include <cstdint>           // std::uint8_t, std::uint16_t, std::uint32_t
+#include <initializer_list>  // std::initializer_list
+#include <memory>            // std::allocator, std::allocator_traits
+#include <new>               // placement new
+#include <stdexcept>         // std::out_of_range, std::length_error
+#include <type_traits>       // std::is_trivial, std::is_trivially_copyable, std::is_constant_evaluated, std::enable_if
+#include <utility>           // std::move, std::forward
+
+#include "vector.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Smallest unsigned type that holds every size from 0 to `N`.
+template <std::size_t N>
+struct static_size_type {
+    using type = typename std::conditional<
+        N <= 0xFFu, std::uint8_t,
+        typename std::conditional<N <= 0xFFFFu, std::uint16_t,
+                                  typename std::conditional<N <= 0xFFFFFFFFu, std::uint32_t,
+                                                            unsigned long>::type>::type>::type;
+};
+
+/// Removes the range overloads when two integers are passed, so `assign(3, 7)` means count and value.
+template <typename InputItr>
+using if_iterator = typename std::enable_if<not std::is_integral<InputItr>::value>::type;
+
+/// Inline storage of `N` elements. Trivial types are kept in a plain array, so the
+/// container can be used in constant expressions (C++20).
+template <typename T, std::size_t N, bool = std::is_trivial<T>::value>
+struct static_storage {
+    T m_data[N];  //!< The elements; only [0, size) are meaningful.
+
+    SC_CONSTEXPR static_storage(void) {
+#if defined(__cpp_lib_is_constant_evaluated)
+        // A constant expression may not leave the unused slots uninitialized.
+        if (std::is_constant_evaluated())
+            for (std::size_t i{0}; i < N; ++i) m_data[i] = T();
+#endif
+    }
+
+    SC_CONSTEXPR T* slots(void) { return m_data; }
+    SC_CONSTEXPR const T* slots(void) const { return m_data; }
+};
+
+/// Inline storage of `N` elements as raw bytes, for types that cannot be default-constructed for free.
+template <typename T, std::size_t N>
+struct static_storage<T, N, false> {
+    alignas(T) unsigned char m_bytes[N * sizeof(T)];  //!< Room for the elements.
+
+    T* slots(void) { return reinterpret_cast<T*>(m_bytes); }
+    const T* slots(void) const { return reinterpret_cast<const T*>(m_bytes); }
+};
+
+/// Storage plus size. With trivially copyable `T` it declares no special member, so the
+/// whole container is trivially copyable and may be copied with memcpy (or live in shared memory).
+template <typename T, std::size_t N, bool = std::is_trivially_copyable<T>::value>
+struct static_vector_base : static_storage<T, N> {
+    typename static_size_type<N>::type m_size;  //!< Number of elements.
+
+    SC_CONSTEXPR static_vector_base(void) : m_size{0} {}
+};
+
+/// Storage plus size, copying and destroying the elements one by one.
+template <typename T, std::size_t N>
+struct static_vector_base<T, N, false> : static_storage<T, N> {
+    typename static_size_type<N>::type m_size;  //!< Number of elements.
+
+    static_vector_base(void) : m_size{0} {}
+    static_vector_base(const static_vector_base& other) : m_size{0} {
+        for (; m_size < other.m_size; ++m_size) ::new (static_cast<void*>(this->slots() + m_size)) T(other.slots()[m_size]);
+    }
+    static_vector_base& operator=(const static_vector_base& other) {
+        if (this != &other) {
+            destroy_all();
+            for (; m_size < other.m_size; ++m_size)
+                ::new (static_cast<void*>(this->slots() + m_size)) T(other.slots()[m_size]);
+        }
+        return *this;
+    }
+    ~static_vector_base(void) { destroy_all(); }
+
+    void destroy_all(void) {
+        for (; m_size > 0; --m_size) this->slots()[m_size - 1].~T();
+    }
+};
+
+}  // namespace detail.
+
+/// This class implements the ADT list with a fixed-capacity array stored inline.
+/*!
+ * sc::static_vector has the interface of sc::vector, but its capacity is the compile-time
+ * constant `N` and its elements live inside the object: nothing is ever allocated, and
+ * adding an element to a full container throws std::length_error instead of growing.
+ * The size is kept in the smallest unsigned type that can hold `N`.
+ *
+ * It is trivially copyable when `T` is, and usable in constant expressions (C++20) when
+ * `T` is trivial.
+ *
+ * \tparam T The type of the elements.
+ * \tparam N The capacity.
+ */
+template <typename T, std::size_t N>
+class static_vector : private detail::static_vector_base<T, N> {
+    static_assert(N > 0, "static_vector needs room for at least one element");
+
+    using base_type = detail::static_vector_base<T, N>;  //!< Storage and size.
+    using base_type::m_size;
+    using base_type::slots;
+
+   public:
+    using size_type = unsigned long;                    //!< The size type.
+    using value_type = T;                               //!< The value type.
+    using pointer = T*;                                 //!< Pointer to a value stored in the container.
+    using const_pointer = const T*;                     //!< Pointer to a constant value stored in the container.
+    using reference = T&;                               //!< Reference to a value stored in the container.
+    using const_reference = const T&;                   //!< Const reference to a value stored in the container.
+    using iterator = MyForwardIterator<T>;              //!< The iterator.
+    using const_iterator = MyForwardIterator<const T>;  //!< The const_iterator.
+
+   private:
+    //=== Storage helpers.
+    /// Throws the error of a container that would exceed its capacity.
+    static void overflow(const char* what) { throw std::length_error(what); }
+    /// Constructs an element in the raw slot `p`.
+    template <typename... Args>
+    static SC_CONSTEXPR void construct_at(pointer p, Args&&... args) {
+        std::allocator<T> alloc;
+        std::allocator_traits<std::allocator<T>>::construct(alloc, p, std::forward<Args>(args)...);
+    }
+    /// Appends an element built from `value`, throwing when full.
+    template <typename U>
+    SC_CONSTEXPR void append(U&& value, const char* what) {
+        if (m_size == N) overflow(what);
+        construct_at(slots() + m_size, std::forward<U>(value));
+        ++m_size;
+    }
+    /// Destroys the elements in [new_size, size()).
+    SC_CONSTEXPR void truncate(size_type new_size) {
+        for (; m_size > new_size; --m_size) slots()[m_size - 1].~T();
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty static vector; no element is constructed.
+     */
+    SC_CONSTEXPR static_vector(void) : base_type() {}
+    /**
+     * @brief Construct a static vector with `count` value-initialized elements.
+     *
+     * @param count Number of elements, at most N.
+     */
+    SC_CONSTEXPR explicit static_vector(size_type count) : base_type() {
+        if (count > N) overflow("[static_vector()]: tamanho maior que a capacidade.");
+        for (; m_size < count; ++m_size) construct_at(slots() + m_size);
+    }
+    /**
+     * @brief Construct a static vector from an initializer list.
+     *
+     * @param il Initializer list to copy, with at most N elements.
+     */
+    SC_CONSTEXPR static_vector(std::initializer_list<value_type> il) : static_vector() {
+        for (const auto& e : il) append(e, "[static_vector()]: tamanho maior que a capacidade.");
+    }
+    /**
+     * @brief Constructs the container with the contents of the range [first, last).
+     *
+     * @param first Iterator to the beginning of range.
+     * @param last Iterator to the location just past the last valid value of the range.
+     */
+    template <typename InputItr, typename = detail::if_iterator<InputItr>>
+    SC_CONSTEXPR static_vector(InputItr first, InputItr last) : static_vector() {
+        for (; first != last; ++first) append(*first, "[static_vector()]: tamanho maior que a capacidade.");
+    }
+    /**
+     * @brief Implements the operator = that replaces the container's contents.
+     *
+     * @param ilist List Initializer to use as data source.
+     * @return The static vector with its updated content.
+     */
+    SC_CONSTEXPR static_vector& operator=(std::initializer_list<value_type> ilist) {
+        assign(ilist.begin(), ilist.end());
+        return *this;
+    }
+
+    //=== [II] ITERATORS
+    /**
+     * @brief Return iterator to the first element.
+     */
+    SC_CONSTEXPR iterator begin(void) { return iterator(slots()); }
+    /**
+     * @brief Return iterator to the element following the last element.
+     */
+    SC_CONSTEXPR iterator end(void) { return iterator(slots() + m_size); }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    SC_CONSTEXPR const_iterator cbegin(void) const { return const_iterator(slots()); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    SC_CONSTEXPR const_iterator cend(void) const { return const_iterator(slots() + m_size); }
+
+    //=== [III] Capacity
+    /**
+     * @brief Return size of the static vector.
+     */
+    SC_CONSTEXPR size_type size(void) const { return m_size; }
+    /**
+     * @brief Return capacity of the static vector, which is always N.
+     */
+    static constexpr size_type capacity(void) { return N; }
+    /**
+     * @brief Checks if the static vector is empty.
+     */
+    SC_CONSTEXPR bool empty(void) const { return m_size == 0; }
+    /**
+     * @brief Verify whether the static vector is full.
+     */
+    SC_CONSTEXPR bool full(void) const { return m_size == N; }
+
+    //=== [IV] Modifiers
+    /**
+     * @brief Erases all elements from the list.
+     */
+    SC_CONSTEXPR void clear(void) { truncate(0); }
+    /**
+     * @brief Appends the given element value to the end of the container.
+     * @param value the value of the element to append.
+     * @throw std::length_error When the container is full.
+     */
+    SC_CONSTEXPR void push_back(const_reference value) {
+        append(value, "[static_vector::push_back()]: capacidade esgotada.");
+    }
+    /**
+     * @brief Removes the last element of the container, if it exists.
+     */
+    SC_CONSTEXPR void pop_back(void) {
+        if (empty())
+            throw std::length_error(
+                "[static_vector::pop_back()]: não é possível remover um elemento de um vetor vazio.");
+
+        truncate(m_size - 1u);
+    }
+    /**
+     * @brief Inserts element before pos.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param value_ Element to be insert.
+     * @return iterator Iterator pointing to the element inserted.
+     */
+    SC_CONSTEXPR iterator insert(iterator pos_, const_reference value_) {
+        return insert(const_iterator(pos_.base()), value_);
+    }
+    /**
+     * @brief Inserts element before pos.
+     *
+     * @param pos_ Constant iterator before which the content will be inserted.
+     * @param value_ Element to be insert (it may be one of ours).
+     * @return iterator Iterator pointing to the element inserted.
+     * @throw std::length_error When the container is full.
+     */
+    SC_CONSTEXPR iterator insert(const_iterator pos_, const_reference value_) {
+        return insert(pos_, &value_, &value_ + 1);
+    }
+    /**
+     * @brief Inserts elements of range [first, last) before pos.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param first_ Iterator to first element to be insert.
+     * @param last_ Iterator to one position after the last element to be insert.
+     * @return iterator Iterator pointing to the first element inserted.
+     */
+    template <typename InputItr, typename = detail::if_iterator<InputItr>>
+    SC_CONSTEXPR iterator insert(iterator pos_, InputItr first_, InputItr last_) {
+        return insert(const_iterator(pos_.base()), first_, last_);
+    }
+    /**
+     * @brief Inserts elements of range [first, last) before pos.
+     *
+     * The elements are appended (reading the range once, so it may be part of this
+     * container) and then rotated into place.
+     *
+     * @param pos_ Constant iterator before which the content will be inserted.
+     * @param first_ Iterator to first element to be insert.
+     * @param last_ Iterator to one position after the last element to be insert.
+     * @return iterator Iterator pointing to the first element inserted.
+     * @throw std::length_error When the elements do not fit; the container is left unchanged.
+     */
+    template <typename InputItr, typename = detail::if_iterator<InputItr>>
+    SC_CONSTEXPR iterator insert(const_iterator pos_, InputItr first_, InputItr last_) {
+        size_type diff = static_cast<size_type>(pos_.base() - slots());
+        size_type old_size = m_size;
+        for (; first_ != last_; ++first_) {
+            if (m_size == N) {
+                truncate(old_size);
+                overflow("[static_vector::insert()]: capacidade esgotada.");
+            }
+            construct_at(slots() + m_size, *first_);
+            ++m_size;
+        }
+        std::rotate(slots() + diff, slots() + old_size, slots() + m_size);
+        return iterator(slots() + diff);
+    }
+    /**
+     * @brief Inserts elements from initializer list ilist before pos.
+     *
+     * @param pos_ Iterator before which the content will be inserted.
+     * @param ilist_ Initializer list to insert the values from.
+     * @return Iterator pointing to the first element inserted.
+     */
+    SC_CONSTEXPR iterator insert(iterator pos_, std::initializer_list<value_type> ilist_) {
+        return insert(pos_, ilist_.begin(), ilist_.end());
+    }
+    /**
+     * @brief Inserts elements from initializer list ilist before pos.
+     *
+     * @param pos_ Constant iterator before which the content will be inserted.
+     * @param ilist_ Initializer list to insert the values from.
+     * @return Iterator pointing to the first element inserted.
+     */
+    SC_CONSTEXPR iterator insert(const_iterator pos_, std::initializer_list<value_type> ilist_) {
+        return insert(pos_, ilist_.begin(), ilist_.end());
+    }
+    /**
+     * @brief Replaces the contents with count copies of value value.
+     * @param count_ the new size of the container.
+     * @param value_ the value to initialize elements of the container with.
+     */
+    SC_CONSTEXPR void assign(size_type count_, const_reference value_) {
+        if (count_ > N) overflow("[static_vector::assign()]: tamanho maior que a capacidade.");
+
+        value_type copy(value_);  // `value_` may be one of our own elements.
+        clear();
+        for (; m_size < count_; ++m_size) construct_at(slots() + m_size, copy);
+    }
+    /**
+     * @brief Replaces the contents with copies of those in the range [first, last).
+     *
+     * The range may be part of this container: each element is read before its slot is written.
+     *
+     * @param first Iterator to the beginning of range.
+     * @param last Iterator to the location just past the last valid value of the range.
+     */
+    template <typename InputItr, typename = detail::if_iterator<InputItr>>
+    SC_CONSTEXPR void assign(InputItr first, InputItr last) {
+        size_type i{0};
+        for (; first != last; ++first, ++i) {
+            if (i == N) {
+                truncate(i);
+                overflow("[static_vector::assign()]: tamanho maior que a capacidade.");
+            }
+            if (i < m_size) {
+                slots()[i] = *first;
+            } else {
+                construct_at(slots() + i, *first);
+                ++m_size;
+            }
+        }
+        truncate(i);
+    }
+    /**
+     * @brief Replaces the contents with the elements from the initializer list ilist.
+     * @param il initializer list to copy the values from.
+     */
+    SC_CONSTEXPR void assign(std::initializer_list<value_type> il) { assign(il.begin(), il.end()); }
+    /**
+     * @brief Erase an element.
+     *
+     * @param pos Iterator to element to be erased.
+     * @return iterator Iterator to the element that followed the one erased.
+     */
+    SC_CONSTEXPR iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    /**
+     * @brief Erase an element.
+     *
+     * @param pos Iterator to element to be erased.
+     * @return iterator Iterator to the element that followed the one erased.
+     */
+    SC_CONSTEXPR iterator erase(iterator pos) { return erase(const_iterator(pos.base())); }
+    /**
+     * @brief Erase elements in range [first, last).
+     *
+     * @param first Iterator to first element to be erased.
+     * @param last Iterator to one position after the last element to be erased.
+     * @return iterator Iterator to the element that followed the last one erased.
+     */
+    SC_CONSTEXPR iterator erase(iterator first, iterator last) {
+        return erase(const_iterator(first.base()), const_iterator(last.base()));
+    }
+    /**
+     * @brief Erase elements in range [first, last).
+     *
+     * @param first Iterator to first element to be erased.
+     * @param last Iterator to one position after the last element to be erased.
+     * @return iterator Iterator to the element that followed the last one erased.
+     */
+    SC_CONSTEXPR iterator erase(const_iterator first, const_iterator last) {
+        pointer p = slots() + (first.base() - slots());
+        pointer q = slots() + (last.base() - slots());
+        if (p == q) return iterator(p);  // Shifting by zero would self-move-assign.
+        pointer new_end = std::move(q, slots() + m_size, p);
+        truncate(static_cast<size_type>(new_end - slots()));
+        return iterator(p);
+    }
+
+    //=== [V] Element access
+    /**
+     * @brief Return the constant last element of the list.
+     */
+    SC_CONSTEXPR const_reference back(void) const {
+        if (empty()) throw std::length_error("[static_vector::back()]: vetor vazio.");
+
+        return slots()[m_size - 1];
+    }
+    /**
+     * @brief Return the constant first element of the list.
+     */
+    SC_CONSTEXPR const_reference front(void) const {
+        if (empty()) throw std::length_error("[static_vector::front()]: vetor vazio.");
+
+        return slots()[0];
+    }
+    /**
+     * @brief Returns the element at the end of the list.
+     */
+    SC_CONSTEXPR reference back(void) { return slots()[m_size - 1]; }
+    /**
+     * @brief Returns the element at the beginning of the list.
+     */
+    SC_CONSTEXPR reference front(void) { return slots()[0]; }
+    /**
+     * @brief Returns a pointer to the inline array of elements.
+     */
+    SC_CONSTEXPR pointer data(void) { return slots(); }
+    /**
+     * @brief Returns a constant pointer to the inline array of elements.
+     */
+    SC_CONSTEXPR const_pointer data(void) const { return slots(); }
+    /**
+     * @brief Implements the operator [].
+     */
+    SC_CONSTEXPR const_reference operator[](size_type position) const { return slots()[position]; }
+    /**
+     * @brief Implements the operator [].
+     */
+    SC_CONSTEXPR reference operator[](size_type position) { return slots()[position]; }
+    /**
+     * @brief Returns element at index `position`.
+     */
+    SC_CONSTEXPR const_reference at(size_type position) const {
+        if (position >= m_size) throw std::out_of_range("[static_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return slots()[position];
+    }
+    /**
+     * @brief Returns element at index `position`, for eventual content alteration.
+     */
+    SC_CONSTEXPR reference at(size_type position) {
+        if (position >= m_size) throw std::out_of_range("[static_vector::at()]: tentativa de leitura fora do vetor.");
+
+        return slots()[position];
+    }
+};  // class static_vector.
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal.
+ * @param lhs static vector whose content is compared with `rhs`.
+ * @param rhs static vector whose content is compared with `lhs`.
+ * @return true if the contents of the static vectors are equal, false otherwise.
+ */
+template <typename T, std::size_t N>
+SC_CONSTEXPR bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+
+    for (typename static_vector<T, N>::size_type i = 0; i < lhs.size(); i++)
+        if (lhs[i] != rhs[i]) return false;
+
+    return true;
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ * @param lhs static vector whose content is compared with `rhs`.
+ * @param rhs static vector whose content is compared with `lhs`.
+ * @return true if the contents of the static vectors are not equal, false otherwise.
+ */
+template <typename T, std::size_t N>
+SC_CONSTEXPR bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) {
+    return not(lhs == rhs);
+}
+
+/// A static vector can be relocated with memcpy when its elements can.
+template <typename T, std::size_t N>
+struct is_trivially_relocatable<static_vector<T, N>> : is_trivially_relocatable<T> {};
+
+}  // namespace sc.
+#endif
@@ -1,22 +1,53 @@
 #ifndef _VECTOR_H_
 #define _VECTOR_H_
 
-#include <algorithm>         // std::copy, std::equal, std::fill
+#include <algorithm>         // std::move_backward
 #include <cassert>           // assert()
-#include <cstddef>           // std::size_t
-#include <exception>         // std::out_of_range
+#include <cstddef>           // std::size_t, std::max_align_t
+#include <cstdint>           // std::uint32_t
+#include <cstring>           // std::memcpy, std::memmove
+#include <functional>        // std::less
 #include <initializer_list>  // std::initializer_list
-#include <iostream>          // std::cout, std::endl
-#include <iterator>          // std::advance, std::begin(), std::end(), std::ostream_iterator
+#include <iosfwd>            // std::basic_ostream
+#include <iterator>          // std::advance, std::distance, std::iterator_traits, std::make_move_iterator
 #include <limits>            // std::numeric_limits<T>
-#include <memory>            // std::unique_ptr
+#include <memory>            // std::addressof, std::allocator, std::allocator_traits
+#include <new>               // ::operator new, ::operator delete
+#include <stdexcept>         // std::out_of_range, std::length_error
+#include <string>            // std::basic_string (is_trivially_relocatable)
+#include <type_traits>       // std::is_constant_evaluated, std::is_polymorphic, std::is_trivially_copyable
+#include <utility>           // std::move, std::move_if_noexcept, std::pair
+#include <vector>            // std::vector (is_trivially_relocatable)
+
+/// Marks the members that may be evaluated at compile time.
+/*!
+ * In C++20 mode (with constexpr dynamic allocation) every member of sc::vector and
+ * MyForwardIterator becomes `constexpr`, so a vector may be created, filled and destroyed
+ * inside a constant expression. In older modes the macro expands to nothing.
+ */
+#if __cplusplus >= 202002L && defined(__cpp_constexpr_dynamic_alloc)
+#define SC_CONSTEXPR constexpr
+#else
+#define SC_CONSTEXPR
+#endif
+
+/// Storage strategies: std::allocator, a per-thread buffer cache or an arena (see vector_storage.h).
+#include "vector_storage.h"
+
+/// Multi-threaded construction, copy and assignment (see parallel.h).
+#include "parallel.h"
+
+/// Opt-in registry of live vectors (see vector_tracking.h): define SC_VECTOR_TRACKING to build with it.
+#if defined(SC_VECTOR_TRACKING)
+#include "vector_tracking.h"
+#endif
 
 /// Sequence container namespace.
 namespace sc {
 
 /// Implements tha infrastrcture to support a bidirectional iterator.
 template <class T>
-class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag, T> {
+class MyForwardIterator {
    public:
     typedef MyForwardIterator self_type;     //!< Alias to iterator.
     typedef std::ptrdiff_t difference_type;  //!< Difference type used to calculated distance between iterators.
@@ -34,11 +65,11 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
     /**
      * @brief Construct a new My Forward Iterator object.
      */
-    MyForwardIterator(pointer pt_ = nullptr) : m_ptr{pt_} {}
+    SC_CONSTEXPR MyForwardIterator(pointer pt_ = nullptr) : m_ptr{pt_} {}
     /**
      * @brief Construct a new My Forward Iterator object.
      */
-    MyForwardIterator(const MyForwardIterator&) = default;
+    SC_CONSTEXPR MyForwardIterator(const MyForwardIterator&) = default;
     /**
      * @brief Destroy the My Forward Iterator object.
      */
@@ -50,19 +81,19 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      *
      * @return MyForwardIterator& The result of the expression.
      */
-    MyForwardIterator& operator=(const MyForwardIterator&) = default;
+    SC_CONSTEXPR MyForwardIterator& operator=(const MyForwardIterator&) = default;
     /**
      * @brief The unary indirection operator dereferences a pointer
      *
      * @return a value of the type from which the pointer's type is derived
      */
-    reference operator*() const { return *m_ptr; }
+    SC_CONSTEXPR reference operator*() const { return *m_ptr; }
     /**
      * @brief The operator postfix increment.
      *
      * @return MyForwardIterator& The result of the expression.
      */
-    MyForwardIterator& operator++() {
+    SC_CONSTEXPR MyForwardIterator& operator++() {
         m_ptr++;
         return *this;
     }
@@ -71,7 +102,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      *
      * @return MyForwardIterator The result of the expression.
      */
-    MyForwardIterator operator++(int) {
+    SC_CONSTEXPR MyForwardIterator operator++(int) {
         MyForwardIterator iterator = *this;
         ++(*this);
         return iterator;
@@ -81,7 +112,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      *
      * @return MyForwardIterator& The result of the expression.
      */
-    MyForwardIterator& operator--() {
+    SC_CONSTEXPR MyForwardIterator& operator--() {
         m_ptr--;
         return *this;
     }
@@ -90,21 +121,18 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      *
      * @return MyForwardIterator The result of the expression.
      */
-    MyForwardIterator operator--(int) {
+    SC_CONSTEXPR MyForwardIterator operator--(int) {
         MyForwardIterator iterator = *this;
         --(*this);
         return iterator;
     }
     /**
-     * @brief The operator minus.
+     * @brief The operator minus: the signed distance from `obj` to this iterator.
      *
      * @param obj Variable on the right side of the operation.
-     * @return MyForwardIterator The result of the expression minus.
+     * @return difference_type Negative when `obj` comes after this iterator.
      */
-    difference_type operator-(MyForwardIterator& obj) {
-        if (m_ptr > obj.m_ptr) return std::distance(obj.m_ptr, m_ptr);
-        return std::distance(m_ptr, obj.m_ptr);
-    }
+    SC_CONSTEXPR difference_type operator-(const MyForwardIterator& obj) const { return m_ptr - obj.m_ptr; }
     /**
      * @brief The equality operator.
      *
@@ -112,7 +140,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @return true true Case the equality is true.
      * @return false false Case otherwise.
      */
-    bool operator==(const MyForwardIterator& other) const { return m_ptr == other.m_ptr; }
+    SC_CONSTEXPR bool operator==(const MyForwardIterator& other) const { return m_ptr == other.m_ptr; }
     /**
      * @brief The inequality operator.
      *
@@ -120,7 +148,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @return true Case the inequality is true.
      * @return false Case otherwise.
      */
-    bool operator!=(const MyForwardIterator& other) const { return !(*this == other); }
+    SC_CONSTEXPR bool operator!=(const MyForwardIterator& other) const { return !(*this == other); }
     /**
      * @brief The operator less than.
      *
@@ -128,7 +156,13 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @return true Case the MyForwardIterator on the left is less than the integer on the right.
      * @return false Case otherwise.
      */
-    bool operator<(MyForwardIterator const& other) { return m_ptr < other.m_ptr; }
+    SC_CONSTEXPR bool operator<(MyForwardIterator const& other) { return m_ptr < other.m_ptr; }
+    /**
+     * @brief Returns the raw pointer wrapped by the iterator.
+     *
+     * @return pointer The raw pointer, which may be one past the last element.
+     */
+    SC_CONSTEXPR pointer base(void) const { return m_ptr; }
 
     //=== [III] Friend functions.
     /**
@@ -138,7 +172,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @param rhs Variable on the right side of the operation.
      * @return MyForwardIterator The result of the expression sum
      */
-    friend MyForwardIterator operator+(difference_type lhs, MyForwardIterator rhs) {
+    friend SC_CONSTEXPR MyForwardIterator operator+(difference_type lhs, MyForwardIterator rhs) {
         return MyForwardIterator(lhs + rhs.m_ptr);
     }
     /**
@@ -148,7 +182,7 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @param rhs Variable on the right side of the operation.
      * @return MyForwardIterator The result of the expression minus
      */
-    friend MyForwardIterator operator+(MyForwardIterator lhs, difference_type rhs) {
+    friend SC_CONSTEXPR MyForwardIterator operator+(MyForwardIterator lhs, difference_type rhs) {
         return MyForwardIterator(lhs.m_ptr + rhs);
     }
     /**
@@ -158,11 +192,222 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
      * @param rhs Variable on the right side of the operation.
      * @return MyForwardIterator The result of the expression minus
      */
-    friend MyForwardIterator operator-(MyForwardIterator lhs, difference_type rhs) {
+    friend SC_CONSTEXPR MyForwardIterator operator-(MyForwardIterator lhs, difference_type rhs) {
         return MyForwardIterator(lhs.m_ptr - rhs);
     }
 };
 
+/// Selects the compact layout of sc::vector, with `SizeType` as its size type.
+/*!
+ * `sc::vector<T, sc::compact<std::uint32_t>>` keeps only the pointer in the vector object;
+ * size and capacity are stored in a header at the start of the heap block, so an empty
+ * vector costs 8 bytes and allocates nothing. Reading the size touches the heap block,
+ * and this layout is not usable in constant expressions.
+ */
+template <typename SizeType>
+struct compact {
+    using size_type = SizeType;  //!< The size type of the vector.
+};
+
+/// Tells whether a `T` can be moved to another address by copying its bytes.
+/*!
+ * Relocating such an object with memcpy and simply forgetting the source is equivalent to
+ * move-constructing the copy and destroying the source. This holds for every trivially
+ * copyable type and for most handle types that are not, like `std::unique_ptr` or sc::vector
+ * itself; it does not hold for types that point into themselves, like the small-string
+ * buffer of libstdc++'s `std::string`. sc::vector uses memcpy/memmove when it moves such
+ * elements, skipping the move-construct and destroy loops.
+ *
+ * Opt a type in with SC_TRIVIALLY_RELOCATABLE(Type) at global scope, or with a
+ * specialization for class templates.
+ */
+template <typename T>
+struct is_trivially_relocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+/// `std::unique_ptr` holds a pointer and its deleter.
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {};
+/// `std::shared_ptr` holds two pointers; the control block does not know their address.
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+/// `std::weak_ptr` holds two pointers.
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+/// A pair is relocatable when both members are.
+template <typename A, typename B>
+struct is_trivially_relocatable<std::pair<A, B>>
+    : std::integral_constant<bool, is_trivially_relocatable<A>::value and is_trivially_relocatable<B>::value> {};
+#if (defined(__GLIBCXX__) and not defined(_GLIBCXX_DEBUG)) or defined(_LIBCPP_VERSION)
+/// `std::vector` is three pointers in libstdc++ and libc++ (but not in their debug modes).
+template <typename T>
+struct is_trivially_relocatable<std::vector<T, std::allocator<T>>> : std::true_type {};
+#endif
+#if defined(_LIBCPP_VERSION)
+/// libc++'s `std::string` keeps short strings inline without pointing to them.
+template <typename C, typename Tr>
+struct is_trivially_relocatable<std::basic_string<C, Tr, std::allocator<C>>> : std::true_type {};
+#endif
+
+/// Declares that `Type` can be relocated with memcpy (see sc::is_trivially_relocatable); use at global scope.
+#define SC_TRIVIALLY_RELOCATABLE(...)                                                     \
+    namespace sc {                                                                        \
+    template <>                                                                           \
+    struct is_trivially_relocatable<__VA_ARGS__> : std::true_type {};                     \
+    }
+
+/// Shrink policy of sc::vector that never gives memory back on its own (the default).
+/*!
+ * A shrink policy tells the vector which capacity to keep after pop_back(), erase() and
+ * clear(); with this one the capacity only changes through shrink_to_fit() and shrink_to().
+ */
+struct never_shrink {
+    static constexpr bool enabled = false;  //!< Lets the vector skip the check entirely.
+
+    /// Returns the capacity to keep for `size` elements: always the current one.
+    template <typename S>
+    static constexpr S shrunk_capacity(S /* size */, S capacity) {
+        return capacity;
+    }
+};
+
+/// Shrink policy of sc::vector that gives memory back when it becomes sparse.
+/*!
+ * When a removal leaves fewer than `capacity / Denominator` elements, the storage area is
+ * reallocated to twice the size (but not below `MinCapacity`). Right after shrinking the
+ * vector is half full, so it has to double or lose half its elements before reallocating
+ * again: push/pop oscillation cannot thrash.
+ *
+ * \tparam Denominator Shrink below this fraction of the capacity; at least 3, for the hysteresis.
+ * \tparam MinCapacity Capacities up to this one are never shrunk.
+ */
+template <unsigned Denominator = 4, std::size_t MinCapacity = 16>
+struct shrink_below {
+    static_assert(Denominator > 2, "shrinking to twice the size needs a threshold below 1/2");
+
+    static constexpr bool enabled = true;  //!< The vector checks the policy after each removal.
+
+    /// Returns the capacity to keep for `size` elements.
+    template <typename S>
+    static constexpr S shrunk_capacity(S size, S capacity) {
+        return capacity > MinCapacity and size < capacity / Denominator
+                   ? (2 * static_cast<std::size_t>(size) > MinCapacity ? static_cast<S>(2 * size)
+                                                                        : static_cast<S>(MinCapacity))
+                   : capacity;
+    }
+};
+
+/// Implementation details.
+namespace detail {
+
+/// Default layout of sc::vector: pointer, size and capacity live in the vector object.
+template <typename T, typename SizeType, typename Storage>
+class vector_layout {
+   public:
+    using size_type = SizeType;  //!< The size type.
+
+   protected:
+    using allocator_type = std::allocator<T>;                    //!< Constructs and destroys elements.
+    using alloc_traits = std::allocator_traits<allocator_type>;  //!< Allocator interface (construct_at in C++20).
+
+    size_type m_end;       //!< The list's current size (or index past-last valid element).
+    size_type m_capacity;  //!< The list's storage capacity.
+    T* m_storage;          //!< The list's data storage area.
+
+    SC_CONSTEXPR vector_layout(void) : m_end{0}, m_capacity{0}, m_storage{nullptr} {}
+
+    /// Returns the size.
+    SC_CONSTEXPR size_type get_end(void) const { return m_end; }
+    /// Updates the size.
+    SC_CONSTEXPR void set_end(size_type n) { m_end = n; }
+    /// Returns the capacity.
+    SC_CONSTEXPR size_type get_capacity(void) const { return m_capacity; }
+    /// Updates the capacity after `m_storage` changed.
+    SC_CONSTEXPR void set_capacity(size_type n) { m_capacity = n; }
+    /// Swaps the metadata with `other`.
+    SC_CONSTEXPR void swap_layout(vector_layout& other) {
+        std::swap(m_end, other.m_end);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_storage, other.m_storage);
+    }
+    /// Allocates raw (unconstructed) room for `n` elements, or returns `nullptr` when `n` is zero.
+    static SC_CONSTEXPR T* allocate_storage(size_type n) {
+        return n == 0 ? nullptr : Storage::template allocate<T>(n);
+    }
+    /// Gives back a storage area of `n` elements obtained from allocate_storage().
+    static SC_CONSTEXPR void deallocate_storage(T* p, size_type n) {
+        if (p != nullptr) Storage::template deallocate<T>(p, n);
+    }
+};
+
+/// Compact layout of sc::vector: size and capacity live in a header in front of the elements.
+template <typename T, typename SizeType, typename Storage>
+class vector_layout<T, compact<SizeType>, Storage> {
+   public:
+    using size_type = SizeType;  //!< The size type.
+
+   protected:
+    using allocator_type = std::allocator<T>;                    //!< Used to construct and destroy elements.
+    using alloc_traits = std::allocator_traits<allocator_type>;  //!< Allocator interface.
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "compact layout requires the default new alignment");
+
+    /// Metadata stored at the start of the heap block.
+    struct header {
+        size_type count;       //!< Size.
+        size_type capacity;  //!< Capacity.
+    };
+    /// Bytes from the start of the block to the first element.
+    static constexpr std::size_t header_bytes(void) { return (sizeof(header) + alignof(T) - 1) / alignof(T) * alignof(T); }
+
+    T* m_storage;  //!< The list's data storage area; `nullptr` when the capacity is zero.
+
+    vector_layout(void) : m_storage{nullptr} {}
+
+    /// Returns the header of the current block, which must exist.
+    header* get_header(void) const {
+        return reinterpret_cast<header*>(reinterpret_cast<char*>(m_storage) - header_bytes());
+    }
+    /// Returns the size.
+    size_type get_end(void) const { return m_storage == nullptr ? 0 : get_header()->count; }
+    /// Updates the size.
+    void set_end(size_type n) {
+        assert(m_storage != nullptr or n == 0);
+        if (m_storage != nullptr) get_header()->count = n;
+    }
+    /// Returns the capacity.
+    size_type get_capacity(void) const { return m_storage == nullptr ? 0 : get_header()->capacity; }
+    /// Updates the capacity after `m_storage` changed; allocate_storage() already recorded it.
+    void set_capacity(size_type n) {
+        assert(m_storage != nullptr or n == 0);
+        if (m_storage != nullptr) get_header()->capacity = n;
+    }
+    /// Swaps the metadata with `other`.
+    void swap_layout(vector_layout& other) { std::swap(m_storage, other.m_storage); }
+    /// Allocates a block with a header and raw room for `n` elements, or returns `nullptr` when `n` is zero.
+    static T* allocate_storage(size_type n) {
+        if (n == 0) return nullptr;
+
+        char* block = Storage::template allocate<char>(block_bytes(n));
+        ::new (static_cast<void*>(block)) header{0, n};
+        return reinterpret_cast<T*>(block + header_bytes());
+    }
+    /// Gives back a block obtained from allocate_storage().
+    static void deallocate_storage(T* p, size_type) {
+        if (p == nullptr) return;
+
+        char* block = reinterpret_cast<char*>(p) - header_bytes();
+        Storage::template deallocate<char>(block, block_bytes(reinterpret_cast<header*>(block)->capacity));
+    }
+    /// Bytes of a block with room for `n` elements.
+    static std::size_t block_bytes(size_type n) { return header_bytes() + n * sizeof(T); }
+};
+
+}  // namespace detail.
+
+/// Base of the lazy element-wise expressions over vectors, defined in expr.h.
+template <typename E>
+struct expression;
+
 /// This class implements the ADT list with dynamic array.
 /*!
  * sc::vector is a sequence container that encapsulates dynamic size arrays.
@@ -173,23 +418,406 @@ class MyForwardIterator : public std::iterator<std::bidirectional_iterator_tag,
  * This means that a pointer to an element of a vector may be passed to
  * any function that expects a pointer to an element of an array.
  *
+ * The storage area is obtained from the `Storage` strategy and only the slots in
+ * [0, size()) hold constructed objects; the remaining capacity is raw memory.
+ *
+ * The class is not polymorphic and holds only its metadata: a pointer plus size and
+ * capacity of type `SizeType`. A narrower `SizeType` (e.g. `std::uint32_t`) makes each
+ * vector smaller, and `sc::compact<SizeType>` moves size and capacity into the heap
+ * block, leaving a single pointer (see the static_asserts after the class).
+ *
+ * With SC_VECTOR_TRACKING defined, each vector also registers itself in a global registry
+ * with its size, capacity and allocation site, for sc::memory_report() and sc::trim_all().
+ * The class then lives in the inline namespace `sc::tracked`, so code built with and without
+ * tracking cannot silently mix vectors.
+ *
+ * Removals keep the capacity unless `ShrinkPolicy` says otherwise: with
+ * `sc::shrink_below<4>` a vector that drops below a quarter of its capacity gives memory
+ * back, and then pop_back(), erase() and clear() may invalidate every iterator.
+ *
  * \tparam T The type of the elements.
+ * \tparam SizeType The size type, or `sc::compact<SizeType>` for the compact layout.
+ * \tparam ShrinkPolicy `sc::never_shrink` or `sc::shrink_below<Denominator, MinCapacity>`.
+ * \tparam Storage Where the storage areas come from: `sc::heap_storage`, `sc::cached_storage`
+ *         or `sc::arena_storage` (see vector_storage.h); by default sc::default_vector_storage<T>.
  */
-template <typename T>
-class vector {
+#if defined(SC_VECTOR_TRACKING)
+inline namespace tracked {
+#endif
+
+template <typename T, typename SizeType = unsigned long, typename ShrinkPolicy = never_shrink,
+          typename Storage = typename default_vector_storage<T>::type>
+class vector : private detail::vector_layout<T, SizeType, Storage> {
+    using layout_type = detail::vector_layout<T, SizeType, Storage>;  //!< Where the metadata lives.
+
    public:
-    using size_type = unsigned long;                    //!< The size type.
+    using size_type = typename layout_type::size_type;  //!< The size type.
     using value_type = T;                               //!< The value type.
     using pointer = T*;                                 //!< Pointer to a value stored in the container.
+    using const_pointer = const T*;                     //!< Pointer to a constant value stored in the container.
     using reference = T&;                               //!< Reference to a value stored in the container.
     using const_reference = const T&;                   //!< Const reference to a value stored in the container.
     using iterator = MyForwardIterator<T>;              //!< The iterator.
     using const_iterator = MyForwardIterator<const T>;  //!< The const_iterator.
+    using allocator_type = std::allocator<T>;           //!< The allocator used to construct the elements.
 
    private:
-    size_type m_end;       //!< The list's current size (or index past-last valid element).
-    size_type m_capacity;  //!< The list's storage capacity.
-    pointer m_storage;     //!< The list's data storage area.
+    using typename layout_type::alloc_traits;
+    using layout_type::m_storage;
+    using layout_type::get_end;
+    using layout_type::get_capacity;
+#if defined(SC_VECTOR_TRACKING)
+    /// Registration in the tracking registry.
+    detail::tracking_node m_tracking{this, &vector::trim_tracked, sizeof(T)};
+
+    /// Lets sc::trim_all() shrink this vector.
+    static void trim_tracked(void* self) { static_cast<vector*>(self)->shrink_to_fit(); }
+    /// Updates the size, and its copy in the registry.
+    SC_CONSTEXPR void set_end(size_type n) {
+        layout_type::set_end(n);
+        m_tracking.note_count(n);
+    }
+    /// Updates the capacity, and its copy in the registry.
+    SC_CONSTEXPR void set_capacity(size_type n) {
+        layout_type::set_capacity(n);
+        m_tracking.note_capacity(n);
+    }
+    /// Swaps the metadata with `other`, keeping both registrations up to date.
+    SC_CONSTEXPR void swap_layout(vector& other) {
+        layout_type::swap_layout(other);
+        m_tracking.note_count(get_end());
+        m_tracking.note_capacity(get_capacity());
+        other.m_tracking.note_count(other.get_end());
+        other.m_tracking.note_capacity(other.get_capacity());
+    }
+#else
+    using layout_type::set_end;
+    using layout_type::set_capacity;
+    using layout_type::swap_layout;
+#endif
+    using layout_type::allocate_storage;
+    using layout_type::deallocate_storage;
+
+    //=== Storage helpers.
+    /**
+     * @brief Returns `base + extra`, throwing when it does not fit in size_type.
+     */
+    static SC_CONSTEXPR size_type checked_capacity(size_type base, size_type extra) {
+        if (extra > std::numeric_limits<size_type>::max() - base)
+            throw std::length_error("[vector]: capacidade máxima do tipo de tamanho excedida.");
+        return base + extra;
+    }
+    /**
+     * @brief Constructs an element in place, forwarding the arguments to its constructor.
+     *
+     * @param p Raw slot where the element is created.
+     * @param args Constructor arguments.
+     */
+    template <typename... Args>
+    static SC_CONSTEXPR void construct_at(pointer p, Args&&... args) {
+        allocator_type alloc;
+        alloc_traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+    /**
+     * @brief Destroys the elements in [first, last).
+     */
+    static SC_CONSTEXPR void destroy_range(pointer first, pointer last) {
+        allocator_type alloc;
+        for (; first != last; ++first) alloc_traits::destroy(alloc, first);
+    }
+    /**
+     * @brief Whether elements may be moved by copying their bytes: trivially relocatable ones,
+     *        except inside a constant expression, where memcpy is not allowed.
+     */
+    static SC_CONSTEXPR bool relocate_by_bytes(void) {
+#if defined(__cpp_lib_is_constant_evaluated)
+        if (std::is_constant_evaluated()) return false;
+#endif
+        return is_trivially_relocatable<T>::value;
+    }
+    /**
+     * @brief Relocates `n` elements from `from` to the raw slots at `to`; the ranges may overlap.
+     *
+     * Afterwards the slots at `from` are raw memory: nothing is destroyed.
+     */
+    static void relocate_bytes(pointer to, const value_type* from, size_type n) {
+        if (n != 0) std::memmove(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+    }
+    /**
+     * @brief Constructs copies of [first_, last_) at the raw slots starting at index `diff`,
+     *        after the tail was relocated `len` slots to the right.
+     *
+     * If a copy throws, the copies made so far are destroyed and the tail is moved back.
+     */
+    template <typename ForwardItr>
+    void fill_relocated_gap(size_type diff, size_type len, ForwardItr first_, ForwardItr last_) {
+        size_type i{diff};
+        try {
+            for (; first_ != last_; ++first_, ++i) construct_at(m_storage + i, *first_);
+        } catch (...) {
+            destroy_range(m_storage + diff, m_storage + i);
+            relocate_bytes(m_storage + diff, m_storage + diff + len, get_end() - diff);
+            throw;
+        }
+    }
+    /**
+     * @brief Constructs copies of [first_, last_) in `temp`, a new storage area of `new_cap`
+     *        slots, from index `diff`.
+     *
+     * If a copy throws, the copies made so far are destroyed and `temp` is freed.
+     */
+    template <typename ForwardItr>
+    SC_CONSTEXPR void fill_new_storage(pointer temp, size_type new_cap, size_type diff, ForwardItr first_,
+                                       ForwardItr last_) {
+        size_type i{diff};
+        try {
+            for (; first_ != last_; ++first_, ++i) construct_at(temp + i, *first_);
+        } catch (...) {
+            destroy_range(temp + diff, temp + i);
+            deallocate_storage(temp, new_cap);
+            throw;
+        }
+    }
+    /**
+     * @brief Destroys every element and frees the storage area, leaving the vector empty.
+     */
+    SC_CONSTEXPR void release_storage(void) {
+        destroy_range(m_storage, m_storage + get_end());
+        deallocate_storage(m_storage, get_capacity());
+        m_storage = nullptr;
+    }
+    /**
+     * @brief Moves the elements to `temp`, a new storage area of `new_cap` slots, leaving a hole
+     *        of `len` slots at index `diff` that the caller has already filled.
+     *
+     * Each element is moved exactly once, straight to its final slot. If a move (a copy, for
+     * types whose move may throw) throws, `temp` is emptied and freed, hole included, and the
+     * vector is left as it was.
+     *
+     * @param temp The new storage area.
+     * @param new_cap Capacity of `temp`.
+     * @param count The size, as read before allocating `temp`: re-reading it after the
+     *        allocation would leave the compiler unsure that `diff <= count`.
+     * @param diff Index of the hole.
+     * @param len Size of the hole.
+     */
+    SC_CONSTEXPR void adopt_storage(pointer temp, size_type new_cap, size_type count, size_type diff,
+                                    size_type len) {
+        if (relocate_by_bytes()) {
+            // Two block copies; the old slots become raw memory, so only the storage is freed.
+            relocate_bytes(temp, m_storage, diff);
+            relocate_bytes(temp + diff + len, m_storage + diff, count - diff);
+            deallocate_storage(m_storage, get_capacity());
+            m_storage = temp;
+            set_capacity(new_cap);
+            set_end(count + len);
+            return;
+        }
+        size_type i{0};
+        try {
+            for (; i < diff; i++) construct_at(temp + i, std::move_if_noexcept(m_storage[i]));
+            for (; i < count; i++) construct_at(temp + i + len, std::move_if_noexcept(m_storage[i]));
+        } catch (...) {
+            if (i <= diff) {
+                destroy_range(temp, temp + i);
+                destroy_range(temp + diff, temp + diff + len);
+            } else {
+                destroy_range(temp, temp + i + len);
+            }
+            deallocate_storage(temp, new_cap);
+            throw;
+        }
+
+        release_storage();
+        m_storage = temp;
+        set_capacity(new_cap);
+        set_end(count + len);
+    }
+    /**
+     * @brief Moves the elements to a new storage area with room for `new_cap` elements.
+     *
+     * @param new_cap New capacity, which must be at least size().
+     */
+    SC_CONSTEXPR void reallocate(size_type new_cap) {
+        size_type count = get_end();
+        adopt_storage(allocate_storage(new_cap), new_cap, count, count, 0);
+    }
+    /**
+     * @brief Gives memory back after a removal, if the shrink policy asks for it.
+     */
+    SC_CONSTEXPR void apply_shrink_policy(void) {
+        if (not ShrinkPolicy::enabled) return;
+
+        size_type new_cap = ShrinkPolicy::shrunk_capacity(get_end(), get_capacity());
+        if (new_cap < get_capacity()) reallocate(new_cap);
+    }
+    /**
+     * @brief Gives an empty vector room for `count` elements; new storage is left untouched.
+     */
+    void make_untouched_room(size_type count) {
+        if (count <= get_capacity()) return;
+
+        pointer temp = allocate_storage(count);
+        deallocate_storage(m_storage, get_capacity());
+        m_storage = temp;
+        set_capacity(count);
+    }
+    /**
+     * @brief Replaces the contents with `count` copies of `value_`, written by several threads.
+     *
+     * Fresh storage is allocated but not touched before the threads write their slices, so
+     * each page lands on the NUMA node of the thread that fills it.
+     */
+    void fill_parallel(size_type count, const value_type& value_, parallel_t policy) {
+        static_assert(std::is_trivially_copyable<T>::value, "the parallel paths need trivially copyable elements");
+        value_type copy(value_);  // `value_` may be one of our own elements.
+
+        clear();
+        make_untouched_room(count);
+        pointer p = m_storage;
+        detail::for_each_slice(p, count, policy, [p, &copy](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; ++i) ::new (static_cast<void*>(p + i)) value_type(copy);
+        });
+        set_end(count);
+    }
+    /**
+     * @brief Replaces the contents with a copy of `other`, written by several threads.
+     */
+    void copy_parallel(const vector& other, parallel_t policy) {
+        static_assert(std::is_trivially_copyable<T>::value, "the parallel paths need trivially copyable elements");
+        if (this == &other) return;
+
+        size_type count = other.get_end();
+        clear();
+        make_untouched_room(count);
+        pointer p = m_storage;
+        const value_type* from = other.m_storage;
+        detail::for_each_slice(p, count, policy, [p, from](std::size_t first, std::size_t last) {
+            if (last > first) std::memcpy(static_cast<void*>(p + first), from + first, (last - first) * sizeof(T));
+        });
+        set_end(count);
+    }
+    /**
+     * @brief Replaces the contents with the values of an element-wise expression (see expr.h).
+     *
+     * The whole expression runs in one loop per thread. It may read this vector: element i
+     * is read before it is written, and a vector read by the expression has its size, so the
+     * storage is not reallocated then.
+     */
+    template <typename E>
+    void evaluate_expression(const E& e, parallel_t policy) {
+        static_assert(std::is_trivially_copyable<T>::value, "expressions need trivially copyable elements");
+        size_type count = static_cast<size_type>(e.size());
+        if (count > get_capacity()) {
+            clear();
+            make_untouched_room(count);
+        }
+        pointer p = m_storage;
+        detail::for_each_slice(p, count, policy, [p, &e](std::size_t first, std::size_t last) {
+            e.evaluate(p, first, last);
+        });
+        set_end(count);
+    }
+    /**
+     * @brief Checks whether `p` points to one of the elements of this vector.
+     */
+    SC_CONSTEXPR bool points_inside(const value_type* p) const {
+#if defined(__cpp_lib_is_constant_evaluated)
+        // Ordering unrelated pointers is not allowed in constant expressions, but equality is.
+        if (std::is_constant_evaluated()) {
+            for (const value_type* q = m_storage; q != m_storage + get_end(); ++q)
+                if (q == p) return true;
+            return false;
+        }
+#endif
+        std::less<const value_type*> less;
+        return not less(p, m_storage) and less(p, m_storage + get_end());
+    }
+    /**
+     * @brief Overload for sources whose elements are of another type, which cannot alias ours.
+     */
+    template <typename U>
+    SC_CONSTEXPR bool points_inside(const U*) const {
+        return false;
+    }
+    /**
+     * @brief Checks whether the range starting at `first` is made of elements of this vector.
+     */
+    template <typename ForwardItr>
+    SC_CONSTEXPR bool range_inside(ForwardItr first, std::true_type) const {
+        return points_inside(std::addressof(*first));
+    }
+    /**
+     * @brief Overload for iterators that yield values instead of references, which cannot alias ours.
+     */
+    template <typename ForwardItr>
+    SC_CONSTEXPR bool range_inside(ForwardItr, std::false_type) const {
+        return false;
+    }
+    /**
+     * @brief Inserts the range [first_, last_) at index `diff`, reading a single-pass range once.
+     *
+     * The elements are gathered in a temporary vector and then moved into place.
+     */
+    template <typename InputItr>
+    SC_CONSTEXPR iterator insert_range(size_type diff, InputItr first_, InputItr last_, std::input_iterator_tag) {
+        vector temp;
+        for (; first_ != last_; ++first_) temp.push_back(*first_);
+
+        return insert_range(diff, std::make_move_iterator(temp.m_storage),
+                            std::make_move_iterator(temp.m_storage + temp.get_end()), std::forward_iterator_tag());
+    }
+    /**
+     * @brief Inserts the multi-pass range [first_, last_) at index `diff`.
+     *
+     * When the vector has to grow, the prefix, the new elements and the suffix are written
+     * straight into the new storage area. Otherwise the tail is shifted once, by `len` slots.
+     */
+    template <typename ForwardItr>
+    SC_CONSTEXPR iterator insert_range(size_type diff, ForwardItr first_, ForwardItr last_,
+                                       std::forward_iterator_tag) {
+        size_type len = static_cast<size_type>(std::distance(first_, last_));
+        if (len == 0) return iterator(m_storage + diff);
+
+        size_type count = get_end();
+        if (checked_capacity(count, len) > get_capacity()) {
+            size_type new_cap = checked_capacity(count + len, (get_capacity() / 2) + 1);
+            pointer temp = allocate_storage(new_cap);
+
+            // Copy the new elements first: the range may refer to our own (still intact) elements.
+            fill_new_storage(temp, new_cap, diff, first_, last_);
+            adopt_storage(temp, new_cap, count, diff, len);
+        } else if (range_inside(first_, std::is_lvalue_reference<
+                                            typename std::iterator_traits<ForwardItr>::reference>())) {
+            // A sub-range of this vector would be overwritten by the shift: copy it out first.
+            vector temp(first_, last_);
+            return insert_range(diff, std::make_move_iterator(temp.m_storage),
+                                std::make_move_iterator(temp.m_storage + temp.get_end()), std::forward_iterator_tag());
+        } else if (relocate_by_bytes()) {
+            // One memmove opens the gap; the new elements are constructed in the raw slots.
+            relocate_bytes(m_storage + diff + len, m_storage + diff, count - diff);
+            fill_relocated_gap(diff, len, first_, last_);
+            set_end(count + len);
+        } else {
+            size_type elems_after = count - diff;
+            if (elems_after > len) {
+                // The last `len` elements go to raw memory; the others are shifted by assignment.
+                for (size_type i = count - len; i < count; i++) construct_at(m_storage + i + len, std::move(m_storage[i]));
+                std::move_backward(m_storage + diff, m_storage + count - len, m_storage + count);
+                for (size_type i{diff}; first_ != last_; ++first_, ++i) m_storage[i] = *first_;
+            } else {
+                // The whole tail goes to raw memory, and so does part of the new elements.
+                ForwardItr mid = first_;
+                std::advance(mid, elems_after);
+                for (size_type i{count}; mid != last_; ++mid, ++i) construct_at(m_storage + i, *mid);
+                for (size_type i{diff}; i < count; i++) construct_at(m_storage + i + len, std::move(m_storage[i]));
+                for (size_type i{diff}; i < diff + elems_after; ++first_, ++i) m_storage[i] = *first_;
+            }
+            set_end(count + len);
+        }
+
+        return iterator(m_storage + diff);
+    }
 
    public:
     //=== [I] SPECIAL MEMBERS (7 OF THEM)
@@ -198,34 +826,81 @@ class vector {
      *
      * @param new_cap Capacity of my new vector.
      */
-    explicit vector(size_type new_cap = 0)
-        : m_capacity{new_cap}, m_end{new_cap}, m_storage{new value_type[m_capacity]} {
-        std::fill(m_storage, m_storage + m_capacity, value_type{});
+    SC_CONSTEXPR explicit vector(size_type new_cap = 0) {
+        m_storage = allocate_storage(new_cap);
+        set_capacity(new_cap);
+        for (size_type i{0}; i < new_cap; i++) construct_at(m_storage + i);
+        set_end(new_cap);
     }
     /**
      * @brief Destroy the vector object.
      */
-    virtual ~vector(void) {
-        for (auto i = 0; i < static_cast<int>(m_end); i++) m_storage[i].~value_type();
-        delete[] m_storage;
-    }
+    SC_CONSTEXPR ~vector(void) { release_storage(); }
     /**
      * @brief Construct a new vector object.
      *
      * @param other Another vector to construct a new vector identical to this one.
      */
-    vector(const vector& other)
-        : m_capacity{other.m_capacity}, m_end{other.m_end}, m_storage{new value_type[m_capacity]} {
-        std::copy(other.cbegin(), other.cend(), this->begin());
+    SC_CONSTEXPR vector(const vector& other)
+#if defined(SC_VECTOR_TRACKING)
+        // The copy keeps the site of `other`; it is chosen before the node is published.
+        : m_tracking{this, &vector::trim_tracked, sizeof(T), other.m_tracking.site}
+#endif
+    {
+        m_storage = allocate_storage(other.get_capacity());
+        set_capacity(other.get_capacity());
+        size_type count = other.get_end();
+        for (size_type i{0}; i < count; i++) construct_at(m_storage + i, other.m_storage[i]);
+        set_end(count);
+    }
+    /**
+     * @brief Construct a vector of `count` copies of `value_` (value-initialized elements by
+     *        default), each thread writing its own slice.
+     *
+     * With a first-touch NUMA policy the pages end up spread over the nodes of the threads.
+     * Only for trivially copyable elements; small vectors are filled by the calling thread.
+     *
+     * @param count Number of elements.
+     * @param policy `sc::parallel`, or `sc::parallel_t{n}` for at most `n` threads.
+     */
+    vector(size_type count, parallel_t policy, const_reference value_ = value_type()) : vector() {
+        fill_parallel(count, value_, policy);
+    }
+    /**
+     * @brief Construct a copy of `other`, each thread copying its own slice.
+     *
+     * @param policy `sc::parallel`, or `sc::parallel_t{n}` for at most `n` threads.
+     */
+    vector(const vector& other, parallel_t policy)
+#if defined(SC_VECTOR_TRACKING)
+        : m_tracking{this, &vector::trim_tracked, sizeof(T), other.m_tracking.site}
+#endif
+    {
+        m_storage = allocate_storage(0);
+        set_capacity(0);
+        set_end(0);
+        copy_parallel(other, policy);
+    }
+    /**
+     * @brief Construct a vector with the values of an element-wise expression, e.g. `a * b + c`.
+     *
+     * Needs expr.h; the expression is evaluated in a single loop, without temporary vectors.
+     */
+    template <typename E>
+    vector(const expression<E>& e) : vector() {
+        evaluate_expression(e.self(), parallel_t{1});
     }
     /**
      * @brief Construct a new vector object.
      *
      * @param il Iinitializer List to construct a new vector.
      */
-    vector(std::initializer_list<value_type> il)
-        : m_capacity{il.size()}, m_end{il.size()}, m_storage{new value_type[m_capacity]} {
-        std::copy(il.begin(), il.end(), m_storage);
+    SC_CONSTEXPR vector(std::initializer_list<value_type> il) {
+        m_storage = allocate_storage(static_cast<size_type>(il.size()));
+        set_capacity(static_cast<size_type>(il.size()));
+        size_type count{0};
+        for (const auto& e : il) construct_at(m_storage + count++, e);
+        set_end(count);
     }
     /**
      * @brief Constructs the container with the contents of the range [first, last).
@@ -234,21 +909,18 @@ class vector {
      * @param last Pointer/iterator to the location just past the last valid value of the range.
      */
     template <typename InputItr>
-    vector(InputItr first, InputItr last) {
-        m_capacity = 0;
-        for (auto i = first; i < last; i++) {
-            m_capacity++;
-        }
-
-        m_end = m_capacity;
-        m_storage = new value_type[m_capacity];
+    SC_CONSTEXPR vector(InputItr first, InputItr last) {
+        size_type count = static_cast<size_type>(std::distance(first, last));
+        m_storage = allocate_storage(count);
+        set_capacity(count);
 
-        auto i = 0;
+        size_type n{0};
         while (first != last) {
-            m_storage[i] = *first;
+            construct_at(m_storage + n, *first);
             first++;
-            i++;
+            n++;
         }
+        set_end(n);
     }
     /**
      * @brief Implements the operator = that replaces the container's contents.
@@ -256,15 +928,21 @@ class vector {
      *
      * @return The vector with its updated content.
      */
-    vector& operator=(const vector& other) {
+    SC_CONSTEXPR vector& operator=(const vector& other) {
         if (this != &other) {
-            if (m_capacity != other.m_end) {
-                this->~vector();
-                m_storage = new value_type[other.m_end];
+            size_type count = other.get_end();
+            if (get_capacity() != count) {
+                release_storage();
+                m_storage = allocate_storage(count);
+                set_capacity(count);
+            } else {
+                // Not clear(): its shrink policy could take away the room we are about to fill.
+                destroy_range(m_storage, m_storage + get_end());
+                set_end(0);
             }
-            std::copy(other.m_storage, other.m_storage + other.m_end, m_storage);
+            for (size_type i{0}; i < count; i++) construct_at(m_storage + i, other.m_storage[i]);
+            set_end(count);
         }
-        m_capacity = m_end = other.m_end;
         return (*this);
     }
     /**
@@ -273,14 +951,27 @@ class vector {
      * @param ilist List Initializer to use as data source.
      * @return The vector with its updated content.
      */
-    vector& operator=(std::initializer_list<value_type> ilist) {
-        this->~vector();
+    SC_CONSTEXPR vector& operator=(std::initializer_list<value_type> ilist) {
+        release_storage();
 
-        m_capacity = m_end = ilist.size();
-        m_storage = new value_type[m_capacity];
+        m_storage = allocate_storage(static_cast<size_type>(ilist.size()));
+        set_capacity(static_cast<size_type>(ilist.size()));
 
-        std::copy(ilist.begin(), ilist.end(), m_storage);
+        size_type count{0};
+        for (const auto& e : ilist) construct_at(m_storage + count++, e);
+        set_end(count);
+
+        return *this;
+    }
 
+    /**
+     * @brief Replaces the contents with the values of an element-wise expression (see expr.h).
+     *
+     * @return The vector with its updated content.
+     */
+    template <typename E>
+    vector& operator=(const expression<E>& e) {
+        evaluate_expression(e.self(), parallel_t{1});
         return *this;
     }
 
@@ -290,25 +981,25 @@ class vector {
      *
      * @return iterator Iterator to the first element.
      */
-    iterator begin(void) { return iterator(&m_storage[0]); }
+    SC_CONSTEXPR iterator begin(void) { return iterator(m_storage); }
     /**
      * @brief Return iterator to the element following the last element.
      *
      * @return iterator Iterator to the element following the last element.
      */
-    iterator end(void) { return iterator(&m_storage[m_end]); }
+    SC_CONSTEXPR iterator end(void) { return iterator(m_storage + get_end()); }
     /**
      * @brief Return constant iterator to the first element.
      *
      * @return const_iterator Constant iterator to the first element.
      */
-    const_iterator cbegin(void) const { return const_iterator(&m_storage[0]); }
+    SC_CONSTEXPR const_iterator cbegin(void) const { return const_iterator(m_storage); }
     /**
      * @brief Return constant iterator to the element following the last element.
      *
      * @return const_iterator Constant iterator to the element following the last element.
      */
-    const_iterator cend(void) const { return const_iterator(&m_storage[m_end]); }
+    SC_CONSTEXPR const_iterator cend(void) const { return const_iterator(m_storage + get_end()); }
 
     //=== [III] Capacity (3)
     /**
@@ -316,54 +1007,65 @@ class vector {
      *
      * @return size_type Size of the vector.
      */
-    size_type size(void) const { return m_end; }
+    SC_CONSTEXPR size_type size(void) const { return get_end(); }
     /**
      * @brief Return capacity of the vector.
      *
      * @return size_type Capacity of the vector.
      */
-    size_type capacity(void) const { return m_capacity; }
+    SC_CONSTEXPR size_type capacity(void) const { return get_capacity(); }
     /**
      * @brief Checks if the vector is empty.
      *
      * @return true Case the vector is empty.
      * @return false Case otherwise.
      */
-    bool empty(void) const { return m_end == 0; }
+    SC_CONSTEXPR bool empty(void) const { return get_end() == 0; }
     /**
      * @brief Verify whether the container vector is full.
      *
      * @return true Case the container vector is full.
      * @return false Case otherwise.
      */
-    bool full(void) const { return m_end == m_capacity; }
+    SC_CONSTEXPR bool full(void) const { return get_end() == get_capacity(); }
 
     //=== [IV] Modifiers
     /**
      * @brief Erases all elements from the list.
      */
-    void clear(void) {
-        for (auto i{0}; i < static_cast<int>(m_end); i++) m_storage[i].~value_type();
-        m_end = 0;
+    SC_CONSTEXPR void clear(void) {
+        destroy_range(m_storage, m_storage + get_end());
+        set_end(0);
+        apply_shrink_policy();
     }
     /**
      * @brief Appends the given element value to the end of the container.
      * @param value the value of the element to append.
      */
-    void push_back(const_reference value) {
-        if (m_end == m_capacity) {
-            reserve(m_capacity + (m_capacity / 2) + 1);
+    SC_CONSTEXPR void push_back(const_reference value) {
+        size_type count = get_end();
+        if (count == get_capacity()) {
+            // Build the new element before moving the others: `value` may be one of them.
+            size_type new_cap = checked_capacity(count, (count / 2) + 1);
+            pointer temp = allocate_storage(new_cap);
+            fill_new_storage(temp, new_cap, count, &value, &value + 1);
+            adopt_storage(temp, new_cap, count, count, 1);
+        } else {
+            construct_at(m_storage + count, value);
+            set_end(count + 1);
         }
-        m_storage[m_end++] = value;
     }
     /**
      * @brief Removes the last element of the container, if it exists.
      */
-    void pop_back(void) {
+    SC_CONSTEXPR void pop_back(void) {
         if (empty())
             throw std::length_error("[vector::pop_back()]: não é possível remover um elemento de um vetor vazio.");
 
-        m_storage[--m_end].~value_type();
+        size_type count = get_end();
+        destroy_range(m_storage + count - 1, m_storage + count);
+        set_end(count - 1);
+        apply_shrink_policy();
     }
     /**
      * @brief Inserts element before pos.
@@ -372,16 +1074,8 @@ class vector {
      * @param value_ Element to be insert.
      * @return iterator Iterator pointing to the first element inserted.
      */
-    iterator insert(iterator pos_, const_reference value_) {
-        long int diff = std::distance(m_storage, &*pos_);
-        long int i = m_end++ - 1;
-
-        if (m_end > m_capacity) reserve(m_capacity + (m_capacity / 2) + 1);
-
-        for (; i >= diff; i--) m_storage[i + 1] = m_storage[i];
-        m_storage[diff] = value_;
-
-        return &m_storage[diff];
+    SC_CONSTEXPR iterator insert(iterator pos_, const_reference value_) {
+        return insert(const_iterator(pos_.base()), value_);
     }
     /**
      * @brief Inserts element before pos.
@@ -390,16 +1084,36 @@ class vector {
      * @param value_ Element to be insert.
      * @return iterator Iterator pointing to the first element inserted.
      */
-    iterator insert(const_iterator pos_, const_reference value_) {
-        long int diff = std::distance(m_storage, &*pos_);
-        long int i = m_end++ - 1;
+    SC_CONSTEXPR iterator insert(const_iterator pos_, const_reference value_) {
+        size_type diff = static_cast<size_type>(pos_.base() - m_storage);
 
-        if (m_end > m_capacity) reserve(m_capacity + (m_capacity / 2) + 1);
+        size_type count = get_end();
 
-        for (; i >= diff; i--) m_storage[i + 1] = m_storage[i];
-        m_storage[diff] = value_;
+        if (count == get_capacity()) {
+            // Write the prefix, the new element and the suffix straight into the new storage area.
+            size_type new_cap = checked_capacity(count, (count / 2) + 1);
+            pointer temp = allocate_storage(new_cap);
+            fill_new_storage(temp, new_cap, diff, &value_, &value_ + 1);
+            adopt_storage(temp, new_cap, count, diff, 1);
+        } else if (diff == count) {
+            construct_at(m_storage + count, value_);
+            set_end(count + 1);
+        } else {
+            value_type copy(value_);  // `value_` may be one of the elements about to be shifted.
 
-        return &m_storage[diff];
+            if (relocate_by_bytes()) {
+                relocate_bytes(m_storage + diff + 1, m_storage + diff, count - diff);
+                fill_relocated_gap(diff, 1, std::make_move_iterator(&copy), std::make_move_iterator(&copy + 1));
+            } else {
+                // The last element goes to raw memory; the others are shifted by assignment.
+                construct_at(m_storage + count, std::move(m_storage[count - 1]));
+                std::move_backward(m_storage + diff, m_storage + count - 1, m_storage + count);
+                m_storage[diff] = std::move(copy);
+            }
+            set_end(count + 1);
+        }
+
+        return iterator(m_storage + diff);
     }
     /**
      * @brief Inserts elements of range [first, last) before pos.
@@ -411,24 +1125,14 @@ class vector {
      * @return iterator Iterator pointing to the first element inserted.
      */
     template <typename InputItr>
-    iterator insert(iterator pos_, InputItr first_, InputItr last_) {
-        long int len = std::distance(first_, last_);
-        long int diff = std::distance(m_storage, &*pos_);
-        long int i = m_end - 1;
-        m_end += len;
-
-        if (m_end > m_capacity) reserve(m_end + (m_capacity / 2) + 1);
-
-        for (; i >= diff; i--) m_storage[i + len] = m_storage[i];
-
-        i = diff;
-        for (; i < (diff + len); i++) m_storage[i] = *(first_ + i - diff);
-
-        return &m_storage[diff];
+    SC_CONSTEXPR iterator insert(iterator pos_, InputItr first_, InputItr last_) {
+        return insert(const_iterator(pos_.base()), first_, last_);
     }
     /**
      * @brief Inserts elements of range [first, last) before pos.
      *
+     * Input iterators are read in a single pass, and the range may be part of this vector.
+     *
      * @tparam InputItr Type of pointer.
      * @param pos_ Constant iterator before which the content will be inserted.
      * @param first_ Pointer to first element to be insert.
@@ -436,20 +1140,9 @@ class vector {
      * @return iterator Iterator pointing to the first element inserted.
      */
     template <typename InputItr>
-    iterator insert(const_iterator pos_, InputItr first_, InputItr last_) {
-        long int len = std::distance(first_, last_);
-        long int diff = std::distance(m_storage, &*pos_);
-        long int i = m_end - 1;
-        m_end += len;
-
-        if (m_end > m_capacity) reserve(m_end + (m_capacity / 2) + 1);
-
-        for (; i >= diff; i--) m_storage[i + len] = m_storage[i];
-
-        i = diff;
-        for (; i < (diff + len); i++) m_storage[i] = *(first_ + i - diff);
-
-        return &m_storage[diff];
+    SC_CONSTEXPR iterator insert(const_iterator pos_, InputItr first_, InputItr last_) {
+        return insert_range(static_cast<size_type>(pos_.base() - m_storage), first_, last_,
+                            typename std::iterator_traits<InputItr>::iterator_category());
     }
     /**
      * @brief Inserts elements from initializer list ilist before pos.
@@ -458,7 +1151,7 @@ class vector {
      * @param ilist_ Itializer list to insert the values from.
      * @return Iterator pointing to the first element inserted.
      */
-    iterator insert(iterator pos_, const std::initializer_list<value_type>& ilist_) {
+    SC_CONSTEXPR iterator insert(iterator pos_, const std::initializer_list<value_type>& ilist_) {
         return insert(pos_, ilist_.begin(), ilist_.end());
     }
     /**
@@ -468,7 +1161,7 @@ class vector {
      * @param ilist_ Itializer list to insert the values from.
      * @return Iterator pointing to the first element inserted.
      */
-    iterator insert(const_iterator pos_, const std::initializer_list<value_type>& ilist_) {
+    SC_CONSTEXPR iterator insert(const_iterator pos_, const std::initializer_list<value_type>& ilist_) {
         return insert(pos_, ilist_.begin(), ilist_.end());
     }
     /**
@@ -477,46 +1170,43 @@ class vector {
      *        is allocated, otherwise the method does nothing.
      * @param new_cap new capacity of the vector.
      */
-    void reserve(size_type new_cap) {
-        if (new_cap > m_capacity) {
-            pointer temp = new value_type[new_cap];
-
-            for (auto i{0}; i < static_cast<int>(m_end); i++) temp[i] = m_storage[i];
-
-            this->~vector();
-            m_storage = temp;
-            m_capacity = new_cap;
-        }
+    SC_CONSTEXPR void reserve(size_type new_cap) {
+        if (new_cap > get_capacity()) reallocate(new_cap);
     }
     /**
      * @brief Requests the removal of unused capacity.
      */
-    void shrink_to_fit(void) {
-        if (m_capacity != m_end) {
-            pointer temp = new value_type[m_end];
-
-            for (auto i{0}; i < static_cast<int>(m_end); i++) temp[i] = m_storage[i];
-
-            this->~vector();
-            m_storage = temp;
-            m_capacity = m_end;
-        }
+    SC_CONSTEXPR void shrink_to_fit(void) {
+        if (get_capacity() != get_end()) reallocate(get_end());
+    }
+    /**
+     * @brief Reduces the capacity to `new_cap`, or to size() if that is larger.
+     *
+     * Unlike shrink_to_fit(), this leaves room to grow, e.g. `v.shrink_to(2 * v.size())`.
+     * Does nothing when `new_cap` is not below the current capacity.
+     *
+     * @param new_cap Capacity to keep.
+     */
+    SC_CONSTEXPR void shrink_to(size_type new_cap) {
+        if (new_cap < get_end()) new_cap = get_end();
+        if (new_cap < get_capacity()) reallocate(new_cap);
     }
     /**
      * @brief Replaces the contents with count copies of value value.
      * @param count_ the new size of the container.
      * @param value_ the value to initialize elements of the container with.
      */
-    void assign(size_type count_, const_reference value_) {
-        if (count_ >= m_capacity) {
-            reserve(count_);
-            m_end = count_;
-            for (auto i{0}; i < static_cast<int>(m_end); i++) m_storage[i] = value_;
-        } else {
-            for (auto i{0}; i < static_cast<int>(count_); i++) m_storage[i] = value_;
-            for (auto i{count_}; i < m_end; i++) m_storage[i].~value_type();
-            m_end = count_;
+    SC_CONSTEXPR void assign(size_type count_, const_reference value_) {
+        value_type copy(value_);  // `value_` may be one of our own elements.
+
+        clear();
+        if (count_ > get_capacity()) {
+            deallocate_storage(m_storage, get_capacity());
+            m_storage = allocate_storage(count_);
+            set_capacity(count_);
         }
+        for (size_type i{0}; i < count_; i++) construct_at(m_storage + i, copy);
+        set_end(count_);
     }
     /**
      * @brief Replaces the contents with copies of those in the range [first, last).
@@ -525,58 +1215,76 @@ class vector {
      *             contents.
      */
     template <typename InputItr>
-    void assign(InputItr first, InputItr last) {
-        auto diff = std::distance(first, last);
+    SC_CONSTEXPR void assign(InputItr first, InputItr last) {
+        size_type diff = static_cast<size_type>(std::distance(first, last));
+
+        size_type count = get_end();
+
+        if (diff > get_capacity()) {
+            // Build the new contents first: the range may refer to our own elements.
+            pointer temp = allocate_storage(diff);
+            fill_new_storage(temp, diff, 0, first, last);
 
-        if (diff >= m_capacity) {
-            reserve(diff);
-            m_end = diff;
-            for (auto i = 0; i < m_end; i++) m_storage[i] = first[i];
+            release_storage();
+            m_storage = temp;
+            set_capacity(diff);
+            set_end(diff);
         } else {
-            for (auto i = 0; i < diff; i++) m_storage[i] = first[i];
-            for (auto i = diff; i < m_end; i++) m_storage[i].~value_type();
-            m_end = diff;
+            size_type i{0};
+            for (; i < diff and i < count; i++, first++) m_storage[i] = *first;
+            for (; i < diff; i++, first++) construct_at(m_storage + i, *first);
+            if (diff < count) destroy_range(m_storage + diff, m_storage + count);
+            set_end(diff);
         }
     }
     /**
      * @brief Replaces the contents with the elements from the initializer list ilist.
      * @param ilist initializer list to copy the values from.
      */
-    void assign(const std::initializer_list<value_type>& il) { assign(il.begin(), il.end()); }
+    SC_CONSTEXPR void assign(const std::initializer_list<value_type>& il) { assign(il.begin(), il.end()); }
+    /**
+     * @brief Replaces the contents with count copies of value, each thread writing its own slice.
+     *
+     * Only for trivially copyable elements. When the vector must grow, the new storage area is
+     * first touched by the threads; storage kept from before stays where it is.
+     *
+     * @param count_ the new size of the container.
+     * @param value_ the value to initialize elements of the container with.
+     * @param policy `sc::parallel`, or `sc::parallel_t{n}` for at most `n` threads.
+     */
+    void assign(size_type count_, const_reference value_, parallel_t policy) { fill_parallel(count_, value_, policy); }
+    /**
+     * @brief Replaces the contents with a copy of `other`, each thread copying its own slice.
+     *
+     * The parallel counterpart of operator=, for trivially copyable elements.
+     *
+     * @param policy `sc::parallel`, or `sc::parallel_t{n}` for at most `n` threads.
+     */
+    void assign(const vector& other, parallel_t policy) { copy_parallel(other, policy); }
+    /**
+     * @brief Replaces the contents with the values of an element-wise expression, each thread
+     * evaluating its own slice (see expr.h).
+     *
+     * @param policy `sc::parallel`, or `sc::parallel_t{n}` for at most `n` threads.
+     */
+    template <typename E>
+    void assign(const expression<E>& e, parallel_t policy) {
+        evaluate_expression(e.self(), policy);
+    }
     /**
      * @brief Erase an element in vector.
      *
      * @param pos Constant pointer to element to be erased.
      * @return iterator Pointer to 'new' element in position of element erased.
      */
-    iterator erase(const_iterator pos) {
-        long int diff = std::distance(m_storage, &*pos);
-        long int i = diff;
-        m_end--;
-
-        for (; i < static_cast<long int>(m_end); i++) m_storage[i] = m_storage[i + 1];
-
-        m_storage[m_end].~value_type();
-
-        return &m_storage[diff];
-    }
+    SC_CONSTEXPR iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
     /**
      * @brief Erase an element in vector.
      *
      * @param pos Pointer to element to be erased.
      * @return iterator Pointer to 'new' element in position of element erased.
      */
-    iterator erase(iterator pos) {
-        long int diff = std::distance(m_storage, &*pos);
-        long int i = diff;
-        m_end--;
-
-        for (; i < static_cast<long int>(m_end); i++) m_storage[i] = m_storage[i + 1];
-
-        m_storage[m_end].~value_type();
-
-        return &m_storage[diff];
-    }
+    SC_CONSTEXPR iterator erase(iterator pos) { return erase(const_iterator(pos.base())); }
     /**
      * @brief Erase elements in range [first, last) inside vector.
      *
@@ -584,18 +1292,8 @@ class vector {
      * @param last Pointer to one position after the last element to be erased.
      * @return iterator Pointer to the 'new' element in position of first element erased.
      */
-    iterator erase(iterator first, iterator last) {
-        long int len = std::distance(first, last);
-        long int diff = std::distance(m_storage, &*first);
-        long int i = diff;
-        m_end -= len;
-
-        for (; i < static_cast<long int>(m_end); i++) m_storage[i] = m_storage[i + len];
-
-        i = m_end;
-        for (; i < static_cast<long int>(m_end) + len; i++) m_storage[i].~value_type();
-
-        return &m_storage[diff];
+    SC_CONSTEXPR iterator erase(iterator first, iterator last) {
+        return erase(const_iterator(first.base()), const_iterator(last.base()));
     }
     /**
      * @brief Erase elements in range [first, last) inside vector.
@@ -604,18 +1302,26 @@ class vector {
      * @param last Constant pointer one position after the last element to be erased.
      * @return iterator Pointer to the 'new' element in position of first element erased.
      */
-    iterator erase(const_iterator first, const_iterator last) {
-        long int len = std::distance(first, last);
-        long int diff = std::distance(m_storage, &*first);
+    SC_CONSTEXPR iterator erase(const_iterator first, const_iterator last) {
+        long int len = last.base() - first.base();
+        long int diff = first.base() - m_storage;
         long int i = diff;
-        m_end -= len;
+        if (len == 0) return iterator(m_storage + diff);  // Shifting by zero would self-move-assign.
 
-        for (; i < static_cast<long int>(m_end); i++) m_storage[i] = m_storage[i + len];
+        size_type count = get_end();
 
-        i = m_end;
-        for (; i < static_cast<long int>(m_end) + len; i++) m_storage[i].~value_type();
+        if (relocate_by_bytes()) {
+            // Destroy the erased elements, then close the gap with one memmove.
+            destroy_range(m_storage + diff, m_storage + diff + len);
+            relocate_bytes(m_storage + diff, m_storage + diff + len, count - static_cast<size_type>(diff + len));
+        } else {
+            for (; i + len < static_cast<long int>(count); i++) m_storage[i] = std::move(m_storage[i + len]);
+            destroy_range(m_storage + count - len, m_storage + count);
+        }
+        set_end(count - static_cast<size_type>(len));
+        apply_shrink_policy();
 
-        return &m_storage[diff];
+        return iterator(m_storage + diff);
     }
 
     //=== [V] Element access (10)
@@ -624,19 +1330,19 @@ class vector {
      *
      * @return const_reference The constant last-1 element of the list.
      */
-    const_reference back(void) const {
+    SC_CONSTEXPR const_reference back(void) const {
         if (empty()) {
             throw std::length_error("[vector::back()]: vetor vazio.");
         }
 
-        return m_storage[m_end - 1];
+        return m_storage[get_end() - 1];
     }
     /**
      * @brief Return the constant first element of the list.
      *
      * @return const_reference The constant first element of the list.
      */
-    const_reference front(void) const {
+    SC_CONSTEXPR const_reference front(void) const {
         if (empty()) {
             throw std::length_error("[vector::front()]: vetor vazio.");
         }
@@ -648,45 +1354,45 @@ class vector {
      *
      * @return reference The element at the end of the list.
      */
-    reference back(void) { return m_storage[m_end - 1]; }
+    SC_CONSTEXPR reference back(void) { return m_storage[get_end() - 1]; }
     /**
      * @brief Returns the element at the beginning of the list.
      *
      * @return reference The first element of the list.
      */
-    reference front(void) { return m_storage[0]; }
+    SC_CONSTEXPR reference front(void) { return m_storage[0]; }
     /**
      * @brief Returns a pointer to the memory array used internally by the container to store its owned elements.
      *
      * @return pointer A pointer to the memory array.
      */
-    pointer data(void) { return m_storage; }
+    SC_CONSTEXPR pointer data(void) { return m_storage; }
     /**
      * @brief Returns a constant pointer to the memory array used internally by the container to store its owned
      * elements.
      *
-     * @return const_reference A constant pointer to the memory array.
+     * @return const_pointer A constant pointer to the memory array.
      */
-    const_reference data(void) const { return m_storage; }
+    SC_CONSTEXPR const_pointer data(void) const { return m_storage; }
     /**
      * @brief Implements the operator [].
      * @param position index of the element to be accessed.
      * @return constant reference to the requested element.
      */
-    const_reference operator[](size_type position) const { return m_storage[position]; }
+    SC_CONSTEXPR const_reference operator[](size_type position) const { return m_storage[position]; }
     /**
      * @brief Implements the operator [].
      * @param position index of the element to be accessed.
      * @return reference to the requested element.
      */
-    reference operator[](size_type position) { return m_storage[position]; }
+    SC_CONSTEXPR reference operator[](size_type position) { return m_storage[position]; }
     /**
      * @brief Returns element at index `position`.
      * @param position index of the element that should be returned.
      * @return the element of the index `position`.
      */
-    const_reference at(size_type position) const {
-        if (position >= m_end) throw std::out_of_range("[vector::at()]: tentativa de leitura fora do vetor.");
+    SC_CONSTEXPR const_reference at(size_type position) const {
+        if (position >= get_end()) throw std::out_of_range("[vector::at()]: tentativa de leitura fora do vetor.");
 
         return m_storage[position];
     }
@@ -695,8 +1401,8 @@ class vector {
      * @param position index of the element in container.
      * @return the address of the value at index `position`.
      */
-    reference at(size_type position) {
-        if (position >= m_end) throw std::out_of_range("[vector::at()]: tentativa de leitura fora do vetor.");
+    SC_CONSTEXPR reference at(size_type position) {
+        if (position >= get_end()) throw std::out_of_range("[vector::at()]: tentativa de leitura fora do vetor.");
 
         return m_storage[position];
     }
@@ -705,17 +1411,25 @@ class vector {
     /**
      * @brief Prints vector data (stored elements).
      *
+     * The unused capacity is shown as `_`. The stream type is a template parameter so this
+     * header only needs <iosfwd>; include <ostream> (or <iostream>) to print.
+     *
      * @param os_ Stream to print stored elements.
      * @param v_ Vector to print.
-     * @return std::ostream& Stream with vector printed elements.
+     * @return std::basic_ostream& Stream with vector printed elements.
      */
-    friend std::ostream& operator<<(std::ostream& os_, const vector<value_type>& v_) {
+    template <typename CharT, typename Traits>
+    friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os_,
+                                                         const vector& v_) {
         os_ << "{ ";
-        for (auto i{0u}; i < v_.m_capacity; ++i) {
-            if (i == v_.m_end) os_ << "| ";
-            os_ << v_.m_storage[i] << " ";
+        for (size_type i{0}; i < v_.get_capacity(); ++i) {
+            if (i == v_.get_end()) os_ << "| ";
+            if (i < v_.get_end())
+                os_ << v_.m_storage[i] << " ";
+            else
+                os_ << "_ ";
         }
-        os_ << "}, m_end=" << v_.m_end << ", m_capacity=" << v_.m_capacity;
+        os_ << "}, m_end=" << v_.get_end() << ", m_capacity=" << v_.get_capacity();
 
         return os_;
     }
@@ -725,12 +1439,7 @@ class vector {
      * @param first_ First element to swap.
      * @param second_ Second element to swap.
      */
-    friend void swap(vector<value_type>& first_, vector<value_type>& second_) {
-        // Swap each member of the class.
-        std::swap(first_.m_end, second_.m_end);
-        std::swap(first_.m_capacity, second_.m_capacity);
-        std::swap(first_.m_storage, second_.m_storage);
-    }
+    friend SC_CONSTEXPR void swap(vector& first_, vector& second_) { first_.swap_layout(second_); }
 };  // class vector.
 
 //=== [VII] Operators (2)
@@ -741,14 +1450,15 @@ class vector {
  * @param rhs vector whose content is compared with `lhs`.
  * @return true if the contents of the vectors are equal, false otherwise.
  */
-template <typename T>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+SC_CONSTEXPR bool operator==(const vector<T, SizeType, ShrinkPolicy, Storage>& lhs,
+                             const vector<T, SizeType, ShrinkPolicy, Storage>& rhs) {
     if (lhs.size() != rhs.size()) {
         return false;
     }
 
-    for (auto i = 0; i < lhs.size(); i++) {
-        if (lhs.at(i) != rhs.at(i)) {
+    for (typename vector<T, SizeType, ShrinkPolicy, Storage>::size_type i = 0; i < lhs.size(); i++) {
+        if (lhs[i] != rhs[i]) {
             return false;
         }
     }
@@ -762,20 +1472,27 @@ bool operator==(const vector<T>& lhs, const vector<T>& rhs) {
  * @param rhs vector whose content is compared with `lhs`.
  * @return true if the contents of the vectors are not equal, false otherwise.
  */
-template <typename T>
-bool operator!=(const vector<T>& lhs, const vector<T>& rhs) {
-    if (lhs.size() != rhs.size()) {
-        return true;
-    }
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+SC_CONSTEXPR bool operator!=(const vector<T, SizeType, ShrinkPolicy, Storage>& lhs,
+                             const vector<T, SizeType, ShrinkPolicy, Storage>& rhs) {
+    return not(lhs == rhs);
+}
 
-    for (auto i = 0; i < lhs.size(); i++) {
-        if (lhs.at(i) != rhs.at(i)) {
-            return true;
-        }
-    }
+#if defined(SC_VECTOR_TRACKING)
+}  // namespace tracked.
+#else
+// The vector object is only its metadata: no vtable, no padding beyond the size type's.
+static_assert(not std::is_polymorphic<vector<int>>::value, "sc::vector must not have a vtable");
+static_assert(sizeof(vector<int>) == sizeof(int*) + 2 * sizeof(unsigned long), "unexpected sc::vector layout");
+static_assert(sizeof(vector<int, std::uint32_t>) == sizeof(int*) + 2 * sizeof(std::uint32_t),
+              "unexpected sc::vector<T, uint32_t> layout");
+static_assert(sizeof(vector<int, compact<std::uint32_t>>) == sizeof(int*), "compact sc::vector must be one pointer");
 
-    return false;
-}
+/// A vector holds only pointers and sizes, none of them into itself (unlike a tracked vector,
+/// which is linked into the registry and so is left out).
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+struct is_trivially_relocatable<vector<T, SizeType, ShrinkPolicy, Storage>> : std::true_type {};
+#endif
 
 }  // namespace sc.
 #endif
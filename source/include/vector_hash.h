@@ -0,0 +1,329 @@
+#ifndef _VECTOR_HASH_H_
+#define _VECTOR_HASH_H_
+
+#include <cstddef>           // std::size_t
+#include <cstdint>           // std::uint64_t, std::uint32_t
+#include <cstring>           // std::memcpy
+#include <functional>        // std::hash
+#include <initializer_list>  // std::initializer_list
+#include <type_traits>       // std::has_unique_object_representations, std::integral_constant, std::remove_cv
+
+#include "span.h"
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Tells whether a `T` can be hashed through its bytes.
+/*!
+ * It must hold only for types whose equal values have equal bytes: no padding and no two
+ * representations of one value (as `0.0` and `-0.0`). With C++17 this is exactly
+ * `std::has_unique_object_representations`; before that, integers, enums and pointers.
+ * Specialize it for other types with that property.
+ */
+template <typename T>
+struct is_block_hashable
+    : std::integral_constant<bool,
+#if defined(__cpp_lib_has_unique_object_representations)
+                             std::has_unique_object_representations<T>::value
+#else
+                             std::is_integral<T>::value or std::is_enum<T>::value or std::is_pointer<T>::value
+#endif
+                             > {
+};
+
+/// Implementation details.
+namespace detail {
+
+/// XXH64 primes.
+enum : std::uint64_t {
+    hash_p1 = 11400714785074694791ULL,
+    hash_p2 = 14029467366897019727ULL,
+    hash_p3 = 1609587929392839161ULL,
+    hash_p4 = 9650029242287828579ULL,
+    hash_p5 = 2870177450012600261ULL
+};
+
+/// Rotates `x` left by `r` bits.
+inline std::uint64_t rotl64(std::uint64_t x, unsigned r) { return (x << r) | (x >> (64 - r)); }
+/// Reads 8 unaligned bytes.
+inline std::uint64_t read64(const unsigned char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+/// Reads 4 unaligned bytes.
+inline std::uint32_t read32(const unsigned char* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+/// Mixes one 8-byte lane into an accumulator.
+inline std::uint64_t hash_round(std::uint64_t acc, std::uint64_t input) {
+    acc += input * hash_p2;
+    return rotl64(acc, 31) * hash_p1;
+}
+/// Folds an accumulator into the final hash.
+inline std::uint64_t hash_merge(std::uint64_t h, std::uint64_t acc) {
+    h ^= hash_round(0, acc);
+    return h * hash_p1 + hash_p4;
+}
+/// Final avalanche, so every input bit affects every output bit.
+inline std::uint64_t hash_avalanche(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= hash_p2;
+    h ^= h >> 29;
+    h *= hash_p3;
+    return h ^ (h >> 32);
+}
+
+}  // namespace detail.
+
+/**
+ * @brief Hashes `len` bytes with XXH64.
+ *
+ * The bulk loop keeps four independent 64-bit lanes over 32-byte stripes, so the
+ * multiplications pipeline (and vectorize where the target has 64-bit vector multiplies);
+ * the result is the same on every platform with the same endianness.
+ *
+ * @param data First byte.
+ * @param len Number of bytes.
+ * @param seed Seed of the hash.
+ * @return std::uint64_t The hash.
+ */
+inline std::uint64_t hash_bytes(const void* data, std::size_t len, std::uint64_t seed = 0) {
+    using namespace detail;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* const last = p + len;
+    std::uint64_t h;
+
+    if (len >= 32) {
+        std::uint64_t v1 = seed + hash_p1 + hash_p2;
+        std::uint64_t v2 = seed + hash_p2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - hash_p1;
+        for (; last - p >= 32; p += 32) {
+            v1 = hash_round(v1, read64(p));
+            v2 = hash_round(v2, read64(p + 8));
+            v3 = hash_round(v3, read64(p + 16));
+            v4 = hash_round(v4, read64(p + 24));
+        }
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = hash_merge(h, v1);
+        h = hash_merge(h, v2);
+        h = hash_merge(h, v3);
+        h = hash_merge(h, v4);
+    } else {
+        h = seed + hash_p5;
+    }
+    h += static_cast<std::uint64_t>(len);
+
+    for (; last - p >= 8; p += 8) h = rotl64(h ^ hash_round(0, read64(p)), 27) * hash_p1 + hash_p4;
+    if (last - p >= 4) {
+        h = rotl64(h ^ (static_cast<std::uint64_t>(read32(p)) * hash_p1), 23) * hash_p2 + hash_p3;
+        p += 4;
+    }
+    for (; p != last; ++p) h = rotl64(h ^ (*p * static_cast<std::uint64_t>(hash_p5)), 11) * hash_p1;
+
+    return hash_avalanche(h);
+}
+
+/**
+ * @brief Mixes the hash `value` into `seed`.
+ */
+inline std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) {
+    return detail::hash_avalanche(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+/// Implementation details.
+namespace detail {
+
+/// Hashes the elements through their bytes, in one pass over the storage area.
+template <typename T>
+std::uint64_t hash_elements(const T* data, std::size_t n, std::true_type) {
+    return hash_bytes(data, n * sizeof(T));
+}
+/// Combines the `std::hash` of each element, for types that cannot be hashed through their bytes.
+template <typename T>
+std::uint64_t hash_elements(const T* data, std::size_t n, std::false_type) {
+    std::uint64_t h = static_cast<std::uint64_t>(n);
+    std::hash<T> element_hash;
+    for (std::size_t i = 0; i < n; ++i) h = hash_combine(h, element_hash(data[i]));
+    return h;
+}
+
+}  // namespace detail.
+
+/**
+ * @brief Hashes the contents of a vector: equal vectors have equal hashes.
+ */
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+std::uint64_t hash_value(const sc::vector<T, SizeType, ShrinkPolicy, Storage>& v) {
+    return detail::hash_elements(v.data(), static_cast<std::size_t>(v.size()), is_block_hashable<T>());
+}
+
+/**
+ * @brief Hashes the elements viewed by `s`, as hash_value() of a vector with the same elements.
+ */
+template <typename T>
+std::uint64_t hash_value(span<T> s) {
+    using element_type = typename std::remove_cv<T>::type;
+    return detail::hash_elements<element_type>(s.data(), s.size(), is_block_hashable<element_type>());
+}
+
+/// A vector that remembers its hash.
+/*!
+ * Meant for keys of hash maps and dedup caches that are hashed more often than modified.
+ * The hash is computed on the first call to hash() and kept until a mutating member runs;
+ * the elements are only exposed as constants, so every change goes through those members.
+ *
+ * \tparam T The type of the elements.
+ * \tparam SizeType The size type of the underlying sc::vector.
+ */
+template <typename T, typename SizeType = unsigned long>
+class hashed_vector {
+   public:
+    using vector_type = sc::vector<T, SizeType>;                  //!< The wrapped vector.
+    using size_type = typename vector_type::size_type;            //!< The size type.
+    using value_type = T;                                         //!< The value type.
+    using const_reference = const T&;                             //!< Const reference to a stored value.
+    using const_iterator = typename vector_type::const_iterator;  //!< The const_iterator.
+
+   private:
+    vector_type m_vector;          //!< The elements.
+    mutable std::uint64_t m_hash;  //!< Cached hash, meaningful when `m_valid`.
+    mutable bool m_valid;          //!< Whether `m_hash` matches `m_vector`.
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty hashed vector.
+     */
+    hashed_vector(void) : m_vector{}, m_hash{0}, m_valid{false} {}
+    /**
+     * @brief Construct a hashed vector holding a copy of `v`.
+     */
+    explicit hashed_vector(const vector_type& v) : m_vector(v), m_hash{0}, m_valid{false} {}
+    /**
+     * @brief Construct a hashed vector from an initializer list.
+     */
+    hashed_vector(std::initializer_list<value_type> il) : m_vector(il), m_hash{0}, m_valid{false} {}
+
+    //=== [II] Access
+    /**
+     * @brief Returns the hash of the contents, computing it only if they changed since the last call.
+     */
+    std::uint64_t hash(void) const {
+        if (not m_valid) {
+            m_hash = hash_value(m_vector);
+            m_valid = true;
+        }
+        return m_hash;
+    }
+    /**
+     * @brief Returns the wrapped vector.
+     */
+    const vector_type& get(void) const { return m_vector; }
+    /**
+     * @brief Return size of the vector.
+     */
+    size_type size(void) const { return m_vector.size(); }
+    /**
+     * @brief Checks if the vector is empty.
+     */
+    bool empty(void) const { return m_vector.empty(); }
+    /**
+     * @brief Implements the operator [].
+     */
+    const_reference operator[](size_type position) const { return m_vector[position]; }
+    /**
+     * @brief Return constant iterator to the first element.
+     */
+    const_iterator begin(void) const { return m_vector.cbegin(); }
+    /**
+     * @brief Return constant iterator to the element following the last element.
+     */
+    const_iterator end(void) const { return m_vector.cend(); }
+
+    //=== [III] Modifiers (each one invalidates the cached hash)
+    /**
+     * @brief Replaces the element at index `position`.
+     */
+    void set(size_type position, const_reference value) {
+        m_valid = false;
+        m_vector.at(position) = value;
+    }
+    /**
+     * @brief Appends the given element value to the end of the container.
+     */
+    void push_back(const_reference value) {
+        m_valid = false;
+        m_vector.push_back(value);
+    }
+    /**
+     * @brief Removes the last element of the container.
+     */
+    void pop_back(void) {
+        m_valid = false;
+        m_vector.pop_back();
+    }
+    /**
+     * @brief Erases all elements.
+     */
+    void clear(void) {
+        m_valid = false;
+        m_vector.clear();
+    }
+    /**
+     * @brief Replaces the contents with a copy of `v`.
+     */
+    void assign(const vector_type& v) {
+        m_valid = false;
+        m_vector = v;
+    }
+    /**
+     * @brief Runs `f` on the wrapped vector, for changes not covered by the members above.
+     *
+     * @param f Callable taking a `vector_type&`.
+     */
+    template <typename F>
+    void modify(F f) {
+        m_valid = false;
+        f(m_vector);
+    }
+};
+
+/**
+ * @brief Checks if the contents of lhs and rhs are equal, comparing the cached hashes first.
+ */
+template <typename T, typename SizeType>
+bool operator==(const hashed_vector<T, SizeType>& lhs, const hashed_vector<T, SizeType>& rhs) {
+    return lhs.size() == rhs.size() and lhs.hash() == rhs.hash() and lhs.get() == rhs.get();
+}
+/**
+ * @brief Checks if the contents of lhs and rhs are not equal.
+ */
+template <typename T, typename SizeType>
+bool operator!=(const hashed_vector<T, SizeType>& lhs, const hashed_vector<T, SizeType>& rhs) {
+    return not(lhs == rhs);
+}
+
+}  // namespace sc.
+
+namespace std {
+
+/// Hash of the contents of a sc::vector, so it can be a key of unordered containers.
+template <typename T, typename SizeType, typename ShrinkPolicy, typename Storage>
+struct hash<sc::vector<T, SizeType, ShrinkPolicy, Storage>> {
+    std::size_t operator()(const sc::vector<T, SizeType, ShrinkPolicy, Storage>& v) const {
+        return static_cast<std::size_t>(sc::hash_value(v));
+    }
+};
+
+/// Hash of a sc::hashed_vector: the cached hash of its contents.
+template <typename T, typename SizeType>
+struct hash<sc::hashed_vector<T, SizeType>> {
+    std::size_t operator()(const sc::hashed_vector<T, SizeType>& v) const { return static_cast<std::size_t>(v.hash()); }
+};
+
+}  // namespace std.
+#endif
@@ -0,0 +1,419 @@
+#ifndef _VECTOR_STORAGE_H_
+#define _VECTOR_STORAGE_H_
+
+#include <cassert>  // assert()
+#include <cstddef>  // std::size_t, std::max_align_t
+#include <limits>   // std::numeric_limits
+#include <memory>   // std::allocator, std::allocator_traits
+#include <new>      // ::operator new, ::operator delete, std::bad_array_new_length
+
+// Included by vector.h; SC_CONSTEXPR comes from there.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Storage strategy of sc::vector that takes every block from `std::allocator` (the default).
+/*!
+ * A storage strategy provides the raw storage areas of sc::vector through two static
+ * members: `allocate<T>(n)`, which returns room for `n > 0` elements, and
+ * `deallocate<T>(p, n)`, which gets back a block together with the `n` it was allocated
+ * for. The strategy is the fourth template parameter of the vector; its default comes from
+ * sc::default_vector_storage, so a whole element type can switch strategy without touching
+ * the code that names `sc::vector<T>`.
+ */
+struct heap_storage {
+    /// Returns raw room for `n` elements.
+    template <typename T>
+    static SC_CONSTEXPR T* allocate(std::size_t n) {
+        std::allocator<T> alloc;
+        return std::allocator_traits<std::allocator<T>>::allocate(alloc, n);
+    }
+    /// Gives back a block of `n` elements.
+    template <typename T>
+    static SC_CONSTEXPR void deallocate(T* p, std::size_t n) {
+        std::allocator<T> alloc;
+        std::allocator_traits<std::allocator<T>>::deallocate(alloc, p, n);
+    }
+};
+
+/// Implementation details.
+namespace detail {
+
+/// Returns the bytes taken by `n` objects of type `T`, throwing when they do not fit in std::size_t.
+template <typename T>
+std::size_t storage_bytes(std::size_t n, std::size_t extra = 0) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "storage strategies require the default new alignment");
+    if (n > (std::numeric_limits<std::size_t>::max() - extra) / sizeof(T)) throw std::bad_array_new_length();
+    return n * sizeof(T) + extra;
+}
+
+/// Freed heap buffers of one thread, kept in one free list per power-of-two size class.
+/*!
+ * The object has no constructor nor destructor, so its `thread_local` instance is
+ * zero-initialized and stays usable while other thread-local objects are destroyed; the
+ * buffers are freed at thread exit by a separate guard (see local()).
+ */
+struct buffer_cache {
+    enum : std::size_t {
+        min_shift = 6,                            //!< The smallest class holds 64 bytes.
+        max_shift = 16,                           //!< The largest class holds 64 KiB; larger ones are not cached.
+        class_count = max_shift - min_shift + 1,  //!< Number of size classes.
+        max_per_class = 8                         //!< Buffers kept per class.
+    };
+
+    /// A cached buffer, linked through its own first bytes.
+    struct free_buffer {
+        free_buffer* next;  //!< Next buffer of the same class.
+    };
+
+    free_buffer* heads[class_count];  //!< Free list of each class.
+    std::size_t counts[class_count];  //!< Length of each free list.
+    std::size_t hits;                 //!< Allocations served from a free list.
+    std::size_t misses;               //!< Allocations that went to the heap.
+    bool closed;                      //!< Set at thread exit: buffers then go straight back to the heap.
+
+    /// Returns the class of a buffer of `bytes`, or `class_count` when it is too large to cache.
+    static std::size_t class_of(std::size_t bytes) {
+        if (bytes > (std::size_t{1} << max_shift)) return class_count;
+        std::size_t c{0};
+        while ((std::size_t{1} << (min_shift + c)) < bytes) ++c;
+        return c;
+    }
+    /// Returns the bytes actually allocated for class `c`.
+    static std::size_t class_bytes(std::size_t c) { return std::size_t{1} << (min_shift + c); }
+
+    /// Returns a buffer of at least `bytes`, from the free lists when possible.
+    void* take(std::size_t bytes) {
+        std::size_t c = class_of(bytes);
+        if (c == class_count) return ::operator new(bytes);
+        if (heads[c] != nullptr) {
+            free_buffer* b = heads[c];
+            heads[c] = b->next;
+            --counts[c];
+            ++hits;
+            return b;
+        }
+        ++misses;
+        return ::operator new(class_bytes(c));
+    }
+    /// Keeps a buffer of `bytes` obtained from take(), or frees it when its list is full.
+    void give(void* p, std::size_t bytes) {
+        std::size_t c = class_of(bytes);
+        if (c == class_count or closed or counts[c] == max_per_class) {
+            ::operator delete(p);
+            return;
+        }
+        heads[c] = ::new (p) free_buffer{heads[c]};
+        ++counts[c];
+    }
+    /// Frees every cached buffer.
+    void release(void) {
+        for (std::size_t c{0}; c < class_count; ++c) {
+            while (heads[c] != nullptr) {
+                free_buffer* b = heads[c];
+                heads[c] = b->next;
+                ::operator delete(b);
+            }
+            counts[c] = 0;
+        }
+    }
+
+    /// Returns the cache of the calling thread.
+    static buffer_cache& local(void) {
+        /// Frees the buffers at thread exit and closes the cache for the vectors destroyed later.
+        struct guard {
+            buffer_cache* cache;
+            ~guard(void) {
+                cache->release();
+                cache->closed = true;
+            }
+        };
+        static thread_local buffer_cache cache;
+        static thread_local guard cleanup{&cache};
+        (void)cleanup;
+        return cache;
+    }
+};
+
+}  // namespace detail.
+
+/// Storage strategy of sc::vector that recycles freed buffers through a per-thread cache.
+/*!
+ * Blocks are rounded up to a power of two (64 bytes to 64 KiB) and, once freed, kept in a
+ * free list of the freeing thread, up to eight per size, for the next allocation of that
+ * size. Workloads that keep creating and dropping short-lived vectors then stop calling
+ * `operator new` once the cache is warm. Larger blocks go straight to the heap.
+ *
+ * A block may be freed by a thread other than the one that allocated it; it then joins the
+ * cache of the freeing thread.
+ */
+struct cached_storage {
+    /// Counters of the calling thread's cache.
+    struct stats {
+        std::size_t hits;     //!< Allocations served from the cache.
+        std::size_t misses;   //!< Cacheable allocations that went to the heap.
+        std::size_t buffers;  //!< Buffers currently cached.
+        std::size_t bytes;    //!< Bytes currently cached.
+    };
+
+    /// Returns raw room for `n` elements.
+    template <typename T>
+    static T* allocate(std::size_t n) {
+        return static_cast<T*>(detail::buffer_cache::local().take(detail::storage_bytes<T>(n)));
+    }
+    /// Gives back a block of `n` elements, keeping it for reuse when there is room.
+    template <typename T>
+    static void deallocate(T* p, std::size_t n) {
+        detail::buffer_cache::local().give(p, n * sizeof(T));
+    }
+
+    /**
+     * @brief Returns the counters of the calling thread's cache.
+     */
+    static stats thread_stats(void) {
+        const detail::buffer_cache& cache = detail::buffer_cache::local();
+        stats s{cache.hits, cache.misses, 0, 0};
+        for (std::size_t c{0}; c < detail::buffer_cache::class_count; ++c) {
+            s.buffers += cache.counts[c];
+            s.bytes += cache.counts[c] * detail::buffer_cache::class_bytes(c);
+        }
+        return s;
+    }
+    /**
+     * @brief Frees the buffers cached by the calling thread.
+     */
+    static void release(void) { detail::buffer_cache::local().release(); }
+};
+
+/// A monotonic (bump) allocator for the storage of many vectors, freed all at once.
+/*!
+ * Allocating moves a pointer forward inside the current chunk; freeing does nothing,
+ * except for the most recent block, which is given back so that a vector growing at the
+ * top of the arena reuses its own space. reset() rewinds the arena to its first chunk in
+ * O(1), keeping every chunk for the next round.
+ *
+ * Vectors draw from an arena through sc::arena_storage while an sc::arena_scope is active.
+ * Every vector built from an arena must be destroyed before the arena is reset or
+ * destroyed (checked by an assertion). The arena itself is not thread-safe.
+ */
+class vector_arena {
+   private:
+    /// Header of a chunk; the usable bytes follow it.
+    struct chunk {
+        chunk* next;       //!< Next chunk, used after this one is full.
+        std::size_t size;  //!< Usable bytes.
+    };
+
+    enum : std::size_t { alignment = alignof(std::max_align_t) };
+
+    std::size_t m_chunk_bytes;  //!< Usable bytes of a regular chunk.
+    chunk* m_first;             //!< First chunk, or `nullptr` before the first allocation.
+    chunk* m_current;           //!< Chunk being filled.
+    char* m_top;                //!< Next free byte of the current chunk.
+    char* m_limit;              //!< End of the current chunk.
+    char* m_last;               //!< Most recent block, the only one deallocate() gives back.
+    std::size_t m_live;         //!< Blocks handed out and not given back yet.
+
+    /// Rounds `n` up to the alignment of every block.
+    static std::size_t aligned(std::size_t n) { return (n + alignment - 1) / alignment * alignment; }
+    /// Returns the first usable byte of `c`.
+    static char* data_of(chunk* c) { return reinterpret_cast<char*>(c) + aligned(sizeof(chunk)); }
+
+    /// Makes `c` the chunk being filled.
+    void enter(chunk* c) {
+        m_current = c;
+        m_top = data_of(c);
+        m_limit = m_top + c->size;
+    }
+    /// Moves to a chunk with room for `bytes`: the next one if large enough, else a new one.
+    void next_chunk(std::size_t bytes) {
+        chunk* follow = m_current == nullptr ? nullptr : m_current->next;
+        if (follow != nullptr and follow->size >= bytes) {
+            enter(follow);
+            return;
+        }
+        std::size_t size = bytes > m_chunk_bytes ? bytes : m_chunk_bytes;
+        chunk* c = static_cast<chunk*>(::operator new(aligned(sizeof(chunk)) + size));
+        c->next = follow;
+        c->size = size;
+        if (m_current == nullptr)
+            m_first = c;
+        else
+            m_current->next = c;
+        enter(c);
+    }
+
+   public:
+    //=== [I] SPECIAL MEMBERS
+    /**
+     * @brief Construct an empty arena; no memory is taken before the first allocation.
+     *
+     * @param chunk_bytes Size of each chunk; larger blocks get a chunk of their own.
+     */
+    explicit vector_arena(std::size_t chunk_bytes = 64 * 1024)
+        : m_chunk_bytes{aligned(chunk_bytes)},
+          m_first{nullptr},
+          m_current{nullptr},
+          m_top{nullptr},
+          m_limit{nullptr},
+          m_last{nullptr},
+          m_live{0} {}
+    /**
+     * @brief Frees every chunk.
+     */
+    ~vector_arena(void) {
+        assert(m_live == 0 and "a vector outlived its arena");
+        while (m_first != nullptr) {
+            chunk* c = m_first;
+            m_first = c->next;
+            ::operator delete(c);
+        }
+    }
+
+    vector_arena(const vector_arena&) = delete;
+    vector_arena& operator=(const vector_arena&) = delete;
+
+    //=== [II] ALLOCATION
+    /**
+     * @brief Returns `bytes` of raw memory aligned for any fundamental type.
+     */
+    void* allocate(std::size_t bytes) {
+        bytes = aligned(bytes);
+        if (m_current == nullptr or static_cast<std::size_t>(m_limit - m_top) < bytes) next_chunk(bytes);
+        m_last = m_top;
+        m_top += bytes;
+        ++m_live;
+        return m_last;
+    }
+    /**
+     * @brief Gives back a block of `bytes`; only the most recent block is actually reused.
+     */
+    void deallocate(void* p, std::size_t bytes) {
+        assert(m_live > 0);
+        --m_live;
+        if (p == m_last and m_last + aligned(bytes) == m_top) {
+            m_top = m_last;
+            m_last = nullptr;
+        }
+    }
+    /**
+     * @brief Makes the whole arena available again, in O(1); the chunks are kept.
+     */
+    void reset(void) {
+        assert(m_live == 0 and "a vector still uses the arena");
+        if (m_first != nullptr) enter(m_first);
+        m_last = nullptr;
+    }
+
+    //=== [III] CAPACITY
+    /**
+     * @brief Returns the number of blocks handed out and not given back.
+     */
+    std::size_t live_blocks(void) const { return m_live; }
+    /**
+     * @brief Returns the bytes of memory held by the arena.
+     */
+    std::size_t capacity(void) const {
+        std::size_t total{0};
+        for (chunk* c = m_first; c != nullptr; c = c->next) total += c->size;
+        return total;
+    }
+};
+
+/// Implementation details.
+namespace detail {
+
+/// Arena the vectors with sc::arena_storage built by the calling thread draw from.
+inline vector_arena*& current_arena(void) {
+    static thread_local vector_arena* arena = nullptr;
+    return arena;
+}
+
+/// Frees a block that sc::arena_storage took from the heap. Out of line, so GCC cannot follow
+/// arena blocks into the `operator delete` and warn about them (-Wfree-nonheap-object).
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+inline void free_heap_block(void* block) {
+    ::operator delete(block);
+}
+
+}  // namespace detail.
+
+/// Makes the vectors with sc::arena_storage allocate from an arena while the scope lives.
+/*!
+ * Scopes nest; the innermost arena wins. The setting belongs to the calling thread.
+ */
+class arena_scope {
+    vector_arena* m_previous;  //!< Arena to restore on destruction.
+
+   public:
+    /**
+     * @brief Makes `arena` the source of the storage allocated from now on by this thread.
+     */
+    explicit arena_scope(vector_arena& arena) : m_previous{detail::current_arena()} {
+        detail::current_arena() = &arena;
+    }
+    /**
+     * @brief Restores the previous arena.
+     */
+    ~arena_scope(void) { detail::current_arena() = m_previous; }
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+};
+
+/// Storage strategy of sc::vector that draws from the arena of the active sc::arena_scope.
+/*!
+ * Outside any scope the blocks come from the heap. Each block starts with the address of
+ * its arena, so a vector may grow, shrink or be destroyed anywhere, inside or outside a
+ * scope, and still give its storage back to where it came from.
+ */
+struct arena_storage {
+    /// Returns raw room for `n` elements, from the current arena if there is one.
+    template <typename T>
+    static T* allocate(std::size_t n) {
+        std::size_t bytes = detail::storage_bytes<T>(n, header_bytes);
+        vector_arena* arena = detail::current_arena();
+        void* block = arena != nullptr ? arena->allocate(bytes) : ::operator new(bytes);
+        ::new (block) vector_arena*(arena);
+        return reinterpret_cast<T*>(static_cast<char*>(block) + header_bytes);
+    }
+    /// Gives back a block of `n` elements to its arena, or to the heap.
+    template <typename T>
+    static void deallocate(T* p, std::size_t n) {
+        char* block = reinterpret_cast<char*>(p) - header_bytes;
+        vector_arena* arena = *reinterpret_cast<vector_arena**>(block);
+        if (arena != nullptr)
+            arena->deallocate(block, header_bytes + n * sizeof(T));
+        else
+            detail::free_heap_block(block);
+    }
+
+   private:
+    enum : std::size_t { header_bytes = alignof(std::max_align_t) };  //!< Room for the arena address.
+};
+
+/// Storage strategy of `sc::vector<T>` when none is given: sc::heap_storage.
+/*!
+ * Specialize it (or use SC_VECTOR_STORAGE) to move every `sc::vector<T>` of an element type
+ * to another strategy. As with any default template argument, the specialization must be
+ * visible before the first use of `sc::vector<T>`.
+ */
+template <typename T>
+struct default_vector_storage {
+    using type = heap_storage;  //!< The strategy.
+};
+
+}  // namespace sc.
+
+/// Makes `Storage` the storage strategy of `sc::vector<Type>`; use at global scope.
+#define SC_VECTOR_STORAGE(Type, Storage)          \
+    namespace sc {                                \
+    template <>                                   \
+    struct default_vector_storage<Type> {         \
+        using type = Storage;                     \
+    };                                            \
+    }
+
+#endif
@@ -0,0 +1,277 @@
+#ifndef _VECTOR_TRACKING_H_
+#define _VECTOR_TRACKING_H_
+
+#include <algorithm>  // std::sort
+#include <atomic>     // std::atomic
+#include <cstddef>    // std::size_t
+#include <cstdio>     // std::snprintf
+#include <map>        // std::map
+#include <mutex>      // std::recursive_mutex, std::lock_guard
+#include <string>     // std::string
+#include <vector>     // std::vector (the registry cannot use sc::vector, which it tracks)
+
+// Included by vector.h when SC_VECTOR_TRACKING is defined; SC_CONSTEXPR comes from there.
+
+/// Sequence container namespace.
+namespace sc {
+
+/// Implementation details.
+namespace detail {
+
+/// Whether tracking code may run: never inside a constant expression.
+SC_CONSTEXPR inline bool tracking_enabled(void) {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return not std::is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+/// Tag given to the vectors constructed by the calling thread (see sc::tracking_scope).
+inline const char*& current_tracking_site(void) {
+    static thread_local const char* site = nullptr;
+    return site;
+}
+
+/// Registration of one live vector in the global registry (an intrusive circular list).
+struct tracking_node {
+    tracking_node* prev;                //!< Previous node of the registry.
+    tracking_node* next;                //!< Next node of the registry.
+    const char* site;                   //!< Allocation site or tag; set before linking, then constant.
+    void* owner;                        //!< The vector, or `nullptr` for the registry's own nodes.
+    void (*trim)(void*);                //!< Calls the owner's shrink_to_fit().
+    std::size_t element_size;           //!< sizeof(T) of the owner.
+    std::atomic<std::size_t> count;     //!< Owner's size, updated by the owner.
+    std::atomic<std::size_t> capacity;  //!< Owner's capacity, updated by the owner.
+
+    SC_CONSTEXPR tracking_node(void* owner_, void (*trim_)(void*), std::size_t element_size_,
+                               const char* inherited_site = nullptr);
+    SC_CONSTEXPR ~tracking_node(void);
+
+    tracking_node(const tracking_node&) = delete;
+    tracking_node& operator=(const tracking_node&) = delete;
+
+    /// Records a new size; a relaxed store, so reports never race with the owner.
+    SC_CONSTEXPR void note_count(std::size_t n) {
+        if (tracking_enabled()) count.store(n, std::memory_order_relaxed);
+    }
+    /// Records a new capacity.
+    SC_CONSTEXPR void note_capacity(std::size_t n) {
+        if (tracking_enabled()) capacity.store(n, std::memory_order_relaxed);
+    }
+    /// Links `this` before `pos`; the registry lock must be held.
+    void link_before(tracking_node* pos) {
+        prev = pos->prev;
+        next = pos;
+        prev->next = this;
+        pos->prev = this;
+    }
+    /// Removes `this` from the registry; the registry lock must be held.
+    void unlink(void) {
+        prev->next = next;
+        next->prev = prev;
+    }
+};
+
+/// The registry of live vectors.
+struct tracking_registry {
+    std::recursive_mutex mutex;  //!< Recursive: trimming a vector of vectors creates and destroys vectors.
+    tracking_node head;          //!< Sentinel of the circular list.
+
+    tracking_registry(void) : mutex{}, head{nullptr, nullptr, 0} {
+        head.prev = &head;
+        head.next = &head;
+    }
+};
+
+/// Returns the registry, created by the first tracked vector.
+inline tracking_registry& vector_registry(void) {
+    static tracking_registry registry;
+    return registry;
+}
+
+/// Adds `node` to the registry, tagged with the active site, else with `inherited` (the site
+/// of the source of a copy). The site is set before the node is linked and never changes.
+inline void register_node(tracking_node* node, const char* inherited) {
+    const char* tag = current_tracking_site() != nullptr ? current_tracking_site() : inherited;
+    node->site = tag != nullptr ? tag : "(untagged)";
+    tracking_registry& registry = vector_registry();
+    std::lock_guard<std::recursive_mutex> lock(registry.mutex);
+    node->link_before(&registry.head);
+}
+/// Removes `node` from the registry.
+inline void unregister_node(tracking_node* node) {
+    tracking_registry& registry = vector_registry();
+    std::lock_guard<std::recursive_mutex> lock(registry.mutex);
+    node->unlink();
+}
+
+inline SC_CONSTEXPR tracking_node::tracking_node(void* owner_, void (*trim_)(void*), std::size_t element_size_,
+                                                 const char* inherited_site)
+    : prev{nullptr}, next{nullptr}, site{nullptr}, owner{owner_}, trim{trim_}, element_size{element_size_}, count{0},
+      capacity{0} {
+    // The sentinel and cursors (no owner) are not registered, nor is anything in a constant expression.
+    if (owner != nullptr and tracking_enabled()) register_node(this, inherited_site);
+}
+
+inline SC_CONSTEXPR tracking_node::~tracking_node(void) {
+    if (owner != nullptr and tracking_enabled()) unregister_node(this);
+}
+
+}  // namespace detail.
+
+/// Tags the vectors constructed by the calling thread while the scope lives.
+/*!
+ * Scopes nest; the innermost tag wins. A copy made outside any scope keeps the tag of its
+ * source. The tag must outlive the vectors (a string literal is the usual choice); see
+ * SC_VECTOR_SITE() to tag with the current file and line.
+ */
+class tracking_scope {
+    const char* m_previous;  //!< Tag to restore on destruction.
+
+   public:
+    /**
+     * @brief Makes `tag` the site of the vectors constructed from now on by this thread.
+     */
+    explicit tracking_scope(const char* tag) : m_previous{detail::current_tracking_site()} {
+        detail::current_tracking_site() = tag;
+    }
+    /**
+     * @brief Restores the previous tag.
+     */
+    ~tracking_scope(void) { detail::current_tracking_site() = m_previous; }
+
+    tracking_scope(const tracking_scope&) = delete;
+    tracking_scope& operator=(const tracking_scope&) = delete;
+};
+
+#define SC_TRACKING_STRINGIZE2(x) #x
+#define SC_TRACKING_STRINGIZE(x) SC_TRACKING_STRINGIZE2(x)
+#define SC_TRACKING_CONCAT2(a, b) a##b
+#define SC_TRACKING_CONCAT(a, b) SC_TRACKING_CONCAT2(a, b)
+/// Tags the vectors constructed until the end of the enclosing block with "file:line".
+#define SC_VECTOR_SITE()                                                                     \
+    ::sc::tracking_scope SC_TRACKING_CONCAT(sc_vector_site_, __LINE__)(__FILE__ ":" SC_TRACKING_STRINGIZE(__LINE__))
+
+/// Memory held by the live vectors of one site.
+struct site_usage {
+    std::string site;            //!< Allocation site or tag.
+    std::size_t vectors;         //!< Number of live vectors.
+    std::size_t size_bytes;      //!< Bytes taken by elements.
+    std::size_t capacity_bytes;  //!< Bytes allocated for elements.
+
+    /// Bytes allocated but not used.
+    std::size_t slack_bytes(void) const { return capacity_bytes - size_bytes; }
+};
+
+/**
+ * @brief Aggregates the live vectors per site, the largest slack first.
+ *
+ * Safe to call while other threads use their vectors: the sizes are read from atomic copies.
+ */
+inline std::vector<site_usage> memory_usage(void) {
+    std::map<std::string, site_usage> sites;
+    {
+        detail::tracking_registry& registry = detail::vector_registry();
+        std::lock_guard<std::recursive_mutex> lock(registry.mutex);
+        for (detail::tracking_node* n = registry.head.next; n != &registry.head; n = n->next) {
+            if (n->owner == nullptr) continue;
+            site_usage& u = sites[n->site];
+            u.site = n->site;
+            u.vectors += 1;
+            u.size_bytes += n->count.load(std::memory_order_relaxed) * n->element_size;
+            u.capacity_bytes += n->capacity.load(std::memory_order_relaxed) * n->element_size;
+        }
+    }
+
+    std::vector<site_usage> result;
+    for (auto it = sites.begin(); it != sites.end(); ++it) result.push_back(it->second);
+    std::sort(result.begin(), result.end(), [](const site_usage& a, const site_usage& b) {
+        return a.slack_bytes() != b.slack_bytes() ? a.slack_bytes() > b.slack_bytes() : a.site < b.site;
+    });
+    return result;
+}
+
+/// Output formats of memory_report().
+enum class report_format { text, json };
+
+/**
+ * @brief Describes the memory of the live vectors per site, the largest slack first.
+ *
+ * @param format `text` gives an aligned table with a total line; `json` an array of objects
+ *        with the fields `site`, `vectors`, `size_bytes`, `capacity_bytes` and `slack_bytes`.
+ */
+inline std::string memory_report(report_format format = report_format::text) {
+    std::vector<site_usage> usage = memory_usage();
+    std::string out;
+    char line[512];
+
+    if (format == report_format::json) {
+        out = "[";
+        for (std::size_t i{0}; i < usage.size(); ++i) {
+            std::string site;
+            for (char c : usage[i].site) {
+                if (c == '"' or c == '\\') site += '\\';
+                site += c;
+            }
+            std::snprintf(line, sizeof line,
+                          "%s\n  {\"site\": \"%s\", \"vectors\": %zu, \"size_bytes\": %zu, \"capacity_bytes\": %zu, "
+                          "\"slack_bytes\": %zu}",
+                          i == 0 ? "" : ",", site.c_str(), usage[i].vectors, usage[i].size_bytes,
+                          usage[i].capacity_bytes, usage[i].slack_bytes());
+            out += line;
+        }
+        out += usage.empty() ? "]\n" : "\n]\n";
+        return out;
+    }
+
+    site_usage total{"total", 0, 0, 0};
+    std::snprintf(line, sizeof line, "%-40s %8s %14s %14s %14s\n", "site", "vectors", "size_bytes", "capacity_bytes",
+                  "slack_bytes");
+    out = line;
+    for (const site_usage& u : usage) {
+        std::snprintf(line, sizeof line, "%-40s %8zu %14zu %14zu %14zu\n", u.site.c_str(), u.vectors, u.size_bytes,
+                      u.capacity_bytes, u.slack_bytes());
+        out += line;
+        total.vectors += u.vectors;
+        total.size_bytes += u.size_bytes;
+        total.capacity_bytes += u.capacity_bytes;
+    }
+    std::snprintf(line, sizeof line, "%-40s %8zu %14zu %14zu %14zu\n", "total", total.vectors, total.size_bytes,
+                  total.capacity_bytes, total.slack_bytes());
+    return out + line;
+}
+
+/**
+ * @brief Calls shrink_to_fit() on every live vector whose unused capacity exceeds
+ *        `threshold` (a fraction of its capacity, from 0 to 1).
+ *
+ * Unlike the reports, this touches the vectors themselves: call it only when no other
+ * thread is using them, e.g. at a quiescent point of the program.
+ *
+ * @return std::size_t The number of bytes given back.
+ */
+inline std::size_t trim_all(double threshold = 0.0) {
+    detail::tracking_registry& registry = detail::vector_registry();
+    std::lock_guard<std::recursive_mutex> lock(registry.mutex);
+
+    // A cursor node marks the position, so trimming may link and unlink other nodes.
+    detail::tracking_node cursor{nullptr, nullptr, 0};
+    std::size_t released{0};
+    for (detail::tracking_node* n = registry.head.next; n != &registry.head; n = cursor.next) {
+        cursor.link_before(n->next);
+        if (n->owner != nullptr) {
+            std::size_t cap = n->capacity.load(std::memory_order_relaxed);
+            std::size_t used = n->count.load(std::memory_order_relaxed);
+            if (cap > used and static_cast<double>(cap - used) > threshold * static_cast<double>(cap)) {
+                n->trim(n->owner);
+                released += (cap - n->capacity.load(std::memory_order_relaxed)) * n->element_size;
+            }
+        }
+        cursor.unlink();
+    }
+    return released;
+}
+
+}  // namespace sc.
+#endif
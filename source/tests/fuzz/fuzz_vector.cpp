@@ -0,0 +1,28 @@
+/*!
+ * @file fuzz_vector.cpp
+ * @brief libFuzzer target: the input is a program of vector operations (see vector_diff.h),
+ * run on sc::vector and std::vector side by side for every configuration.
+ *
+ * Build with clang: cmake -DVECTOR_FUZZ=ON -DCMAKE_CXX_COMPILER=clang++, then run
+ * `fuzz_vector -max_len=4096 corpus/`. A crash input can be shrunk and replayed with
+ * `stress_vector --replay=crash-...`.
+ */
+
+#include <cstdint>
+#include <cstdlib>  // abort
+#include <iostream>
+
+#include "vector_diff.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size) {
+    fuzz::program_t program = fuzz::decode(data, size);
+    for (const fuzz::Config& config : fuzz::configs()) {
+        fuzz::Failure failure = config.run(program, 256);
+        if (failure.failed()) {
+            std::cerr << config.name << ": " << failure.what << " after step " << failure.step << " ("
+                      << fuzz::to_string(program[static_cast<std::size_t>(failure.step)]) << ")\n";
+            std::abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*!
+ * @file stress_vector.cpp
+ * @brief Randomized differential stress driver: sc::vector against std::vector.
+ *
+ * Runs random programs on every configuration of fuzz::configs() and reports the throughput.
+ * On a mismatch it shrinks the program, prints it, saves its bytes (an input for the libFuzzer
+ * target too) and exits with 1.
+ *
+ * Usage: stress_vector [--ops=N] [--length=L] [--max-size=M] [--seed=S] [--save=FILE] [--replay=FILE]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>  // strtoull
+#include <fstream>
+#include <iostream>
+#include <iterator>  // istreambuf_iterator
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vector_diff.h"
+
+/// Reads the value of `--name=value` into `value`; `false` if `arg` is another option.
+static bool option(const std::string& arg, const std::string& name, std::string& value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+/// Shrinks a failing program, prints it and saves its bytes to `path`.
+static void report(const fuzz::Config& config, const fuzz::program_t& program, std::size_t max_size,
+                   const std::string& path) {
+    fuzz::program_t small = fuzz::shrink(
+        program, [&](const fuzz::program_t& p) { return config.run(p, max_size).failed(); });
+    fuzz::Failure failure = config.run(small, max_size);
+
+    std::cout << "\n" << config.name << ": " << failure.what << " after step " << failure.step << " of this program ("
+              << program.size() << " operations shrunk to " << small.size() << "):\n";
+    for (std::size_t i{0}; i < small.size(); ++i) std::cout << "  " << i << ": " << fuzz::to_string(small[i]) << "\n";
+
+    std::vector<std::uint8_t> bytes = fuzz::encode(small);
+    std::ofstream out(path, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    std::cout << "Saved to " << path << "; replay it with --replay=" << path << ".\n";
+}
+
+int main(int argc, char* argv[]) {
+    unsigned long long total_ops{1000000}, seed{std::random_device{}()};
+    std::size_t length{1000}, max_size{256};
+    std::string save_path{"stress_vector_failure.bin"}, replay_path, value;
+    for (int i{1}; i < argc; ++i) {
+        std::string arg{argv[i]};
+        if (option(arg, "ops", value))
+            total_ops = std::strtoull(value.c_str(), nullptr, 10);
+        else if (option(arg, "length", value))
+            length = std::strtoull(value.c_str(), nullptr, 10);
+        else if (option(arg, "max-size", value))
+            max_size = std::strtoull(value.c_str(), nullptr, 10);
+        else if (option(arg, "seed", value))
+            seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (not option(arg, "save", save_path) and not option(arg, "replay", replay_path)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--ops=N] [--length=L] [--max-size=M] [--seed=S] [--save=FILE] [--replay=FILE]\n";
+            return 2;
+        }
+    }
+    if (length == 0) length = 1;
+
+    // Replays a saved program on every configuration.
+    if (not replay_path.empty()) {
+        std::ifstream in(replay_path, std::ios::binary);
+        std::vector<std::uint8_t> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        fuzz::program_t program = fuzz::decode(bytes.data(), bytes.size());
+        int status{0};
+        for (const fuzz::Config& config : fuzz::configs()) {
+            fuzz::Failure failure = config.run(program, max_size);
+            std::cout << config.name << ": "
+                      << (failure.failed() ? failure.what + " after step " + std::to_string(failure.step) : "ok")
+                      << "\n";
+            if (failure.failed()) status = 1;
+        }
+        return status;
+    }
+
+    std::cout << "Seed " << seed << ", " << total_ops << " operations per configuration in programs of " << length
+              << ", vectors of at most " << max_size << " elements.\n";
+    for (const fuzz::Config& config : fuzz::configs()) {
+        std::mt19937_64 rng{seed};
+        auto start = std::chrono::steady_clock::now();
+        unsigned long long done{0};
+        while (done < total_ops) {
+            fuzz::program_t program = fuzz::random_program(rng, length);
+            if (config.run(program, max_size).failed()) {
+                report(config, program, max_size, save_path);
+                return 1;
+            }
+            done += program.size();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << config.name << ": " << done << " operations in " << seconds << " s ("
+                  << static_cast<unsigned long long>(done / seconds) << " ops/s)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,481 @@
+#ifndef _VECTOR_DIFF_H_
+#define _VECTOR_DIFF_H_
+
+/*!
+ * @file vector_diff.h
+ * @brief Differential testing of sc::vector against std::vector.
+ *
+ * A program is a list of operations (push_back, insert, erase, assign, reserve, ...) decoded
+ * from bytes, four per operation, so that random generators and libFuzzer inputs drive the
+ * same code. run_program() applies each operation to an sc::vector and to a std::vector and
+ * compares them after every step; shrink() reduces a failing program to a small one.
+ */
+
+#include <cstddef>    // std::size_t, std::ptrdiff_t
+#include <cstdint>    // std::uint8_t
+#include <iterator>   // std::input_iterator_tag
+#include <limits>     // std::numeric_limits
+#include <memory>     // std::shared_ptr, std::make_shared
+#include <random>     // std::mt19937_64
+#include <sstream>    // std::ostringstream
+#include <stdexcept>  // std::exception
+#include <string>     // std::string, std::to_string
+#include <vector>     // std::vector, the reference
+
+#include "../../include/vector.h"
+
+/// Differential testing against std::vector.
+namespace fuzz {
+
+/// Operations of a program.
+enum class op_t : std::uint8_t {
+    PUSH_BACK,          //!< push_back(value).
+    POP_BACK,           //!< pop_back(), when not empty.
+    INSERT,             //!< insert(pos, value).
+    INSERT_SELF,        //!< insert(pos, v[src]): the value is one of the elements.
+    INSERT_RANGE,       //!< insert(pos, first, last) from forward iterators.
+    INSERT_INPUT,       //!< insert(pos, first, last) from single-pass input iterators.
+    INSERT_SELF_RANGE,  //!< insert(pos, v.begin() + i, v.begin() + j).
+    ERASE,              //!< erase(pos).
+    ERASE_RANGE,        //!< erase(first, last).
+    ASSIGN_FILL,        //!< assign(count, value).
+    ASSIGN_RANGE,       //!< assign(first, last).
+    ASSIGN_SELF,        //!< assign(v.begin() + i, v.begin() + j).
+    RESERVE,            //!< reserve(n).
+    SHRINK_TO_FIT,      //!< shrink_to_fit().
+    CLEAR,              //!< clear().
+    COPY,               //!< Copy-construct, then copy-assign back.
+    COUNT               //!< Number of operations.
+};
+
+/// One operation and its three argument bytes; their meaning depends on the operation.
+struct Op {
+    op_t kind;       //!< What to do.
+    std::uint8_t a;  //!< Usually a position.
+    std::uint8_t b;  //!< Usually a second position, or the low byte of a value.
+    std::uint8_t c;  //!< Usually a count, or the high byte of a value.
+};
+
+/// A list of operations.
+typedef std::vector<Op> program_t;
+
+/// Decodes a program from bytes, four per operation; a trailing partial operation is ignored.
+inline program_t decode(const std::uint8_t* data, std::size_t size) {
+    program_t program;
+    program.reserve(size / 4);
+    for (std::size_t i{0}; i + 4 <= size; i += 4)
+        program.push_back(Op{static_cast<op_t>(data[i] % static_cast<std::uint8_t>(op_t::COUNT)), data[i + 1],
+                             data[i + 2], data[i + 3]});
+    return program;
+}
+
+/// Encodes a program into the bytes decode() reads it back from.
+inline std::vector<std::uint8_t> encode(const program_t& program) {
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(program.size() * 4);
+    for (const Op& op : program) {
+        bytes.push_back(static_cast<std::uint8_t>(op.kind));
+        bytes.push_back(op.a);
+        bytes.push_back(op.b);
+        bytes.push_back(op.c);
+    }
+    return bytes;
+}
+
+/// Draws a program of `length` operations.
+inline program_t random_program(std::mt19937_64& rng, std::size_t length) {
+    std::vector<std::uint8_t> bytes(length * 4);
+    for (auto& byte : bytes) byte = static_cast<std::uint8_t>(rng());
+    // One kind byte in eight becomes an extra push_back, so that the vectors get past their first
+    // reallocations; the other bytes, below 224, still draw every operation equally often.
+    for (std::size_t i{0}; i < bytes.size(); i += 4)
+        if (bytes[i] >= 224) bytes[i] = static_cast<std::uint8_t>(op_t::PUSH_BACK);
+    return decode(bytes.data(), bytes.size());
+}
+
+/// Readable form of an operation, e.g. "INSERT a=3 b=17 c=0".
+inline std::string to_string(const Op& op) {
+    static const char* const names[] = {"PUSH_BACK",    "POP_BACK",          "INSERT", "INSERT_SELF",
+                                        "INSERT_RANGE", "INSERT_INPUT",      "INSERT_SELF_RANGE",
+                                        "ERASE",        "ERASE_RANGE",       "ASSIGN_FILL",
+                                        "ASSIGN_RANGE", "ASSIGN_SELF",       "RESERVE",
+                                        "SHRINK_TO_FIT", "CLEAR",            "COPY"};
+    std::ostringstream oss;
+    oss << names[static_cast<int>(op.kind)] << " a=" << int{op.a} << " b=" << int{op.b} << " c=" << int{op.c};
+    return oss.str();
+}
+
+//=== Element types.
+
+/// An instrumented element: counts live objects, and detects use after destruction, relocation
+/// by bytes (it records its own address) and moved-from objects left in the contents.
+class Probe {
+   private:
+    int m_value;          //!< Payload; moved_from once moved.
+    const Probe* m_self;  //!< `this` while alive.
+
+    static constexpr int moved_from = std::numeric_limits<int>::min();
+
+   public:
+    /// Objects constructed and not yet destroyed.
+    static long& live(void) {
+        static long n{0};
+        return n;
+    }
+    /// Accesses to objects that were destroyed or memcpy'd to another address.
+    static long& violations(void) {
+        static long n{0};
+        return n;
+    }
+
+    explicit Probe(int v = 0) : m_value{v}, m_self{this} { ++live(); }
+    Probe(const Probe& other) : m_value{other.checked()}, m_self{this} { ++live(); }
+    Probe(Probe&& other) noexcept : m_value{other.checked()}, m_self{this} {
+        other.m_value = moved_from;
+        ++live();
+    }
+    Probe& operator=(const Probe& other) {
+        m_value = other.checked();
+        checked();
+        return *this;
+    }
+    Probe& operator=(Probe&& other) noexcept {
+        m_value = other.checked();
+        other.m_value = moved_from;
+        checked();
+        return *this;
+    }
+    ~Probe(void) {
+        checked();
+        m_self = nullptr;
+        --live();
+    }
+
+    /// The payload, counting a violation if this object is not where it was built.
+    int checked(void) const {
+        if (m_self != this) ++violations();
+        return m_value;
+    }
+    bool operator==(const Probe& other) const { return checked() == other.checked() and m_value != moved_from; }
+    bool operator!=(const Probe& other) const { return not(*this == other); }
+};
+
+/// How the engine builds and inspects values of each element type.
+template <typename T>
+struct element_traits;
+
+/// Trivial elements: the memcpy/memmove paths.
+template <>
+struct element_traits<int> {
+    static int make(int v) { return v; }
+    static long live(void) { return -1; }  //!< -1: not instrumented.
+    static long violations(void) { return 0; }
+    static void reset(void) {}
+};
+
+/// Instrumented elements: the element-wise paths.
+template <>
+struct element_traits<Probe> {
+    static Probe make(int v) { return Probe{v}; }
+    static long live(void) { return Probe::live(); }
+    static long violations(void) { return Probe::violations(); }
+    static void reset(void) { Probe::violations() = 0; }
+};
+
+/// Non-trivial but trivially relocatable elements: the memcpy paths with reference counts.
+template <>
+struct element_traits<std::shared_ptr<int>> {
+    static std::shared_ptr<int> make(int v) { return std::make_shared<int>(v); }
+    static long live(void) { return -1; }
+    static long violations(void) { return 0; }
+    static void reset(void) {}
+};
+
+/// Strings long enough to live on the heap half of the time.
+template <>
+struct element_traits<std::string> {
+    static std::string make(int v) { return std::string(static_cast<std::size_t>(v % 40), static_cast<char>('a' + v % 26)); }
+    static long live(void) { return -1; }
+    static long violations(void) { return 0; }
+    static void reset(void) {}
+};
+
+/// A single-pass view of a range, to drive the input-iterator overloads.
+template <typename T>
+class input_iterator {
+   private:
+    const T* m_ptr;  //!< Current element.
+
+   public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    explicit input_iterator(const T* p) : m_ptr{p} {}
+    reference operator*(void) const { return *m_ptr; }
+    input_iterator& operator++(void) {
+        ++m_ptr;
+        return *this;
+    }
+    input_iterator operator++(int) {
+        input_iterator old = *this;
+        ++m_ptr;
+        return old;
+    }
+    bool operator==(const input_iterator& other) const { return m_ptr == other.m_ptr; }
+    bool operator!=(const input_iterator& other) const { return m_ptr != other.m_ptr; }
+};
+
+//=== Running programs.
+
+/// Outcome of a program: the index of the first operation after which the vectors differed.
+struct Failure {
+    long step;         //!< -1 if the program passed.
+    std::string what;  //!< What differed.
+
+    bool failed(void) const { return step >= 0; }
+};
+
+namespace detail {
+
+/// Applies `op` to the vector under test and to the reference; false if the operation does not apply.
+template <typename Vec, typename T>
+bool apply(Vec& v, std::vector<T>& ref, const Op& op, std::size_t max_size) {
+    typedef element_traits<T> traits;
+    const std::size_t n = ref.size();
+    const int value = op.b | (op.c << 8);
+    std::vector<T> values;  // Source of the range operations.
+    if (op.kind == op_t::INSERT_RANGE or op.kind == op_t::INSERT_INPUT or op.kind == op_t::ASSIGN_RANGE)
+        for (int k{0}; k < op.c % 9; ++k) values.push_back(traits::make(value + k));
+
+    switch (op.kind) {
+        case op_t::PUSH_BACK: {
+            if (n >= max_size) return false;
+            T x = traits::make(value);
+            v.push_back(x);
+            ref.push_back(x);
+            return true;
+        }
+        case op_t::POP_BACK:
+            if (n == 0) return false;
+            v.pop_back();
+            ref.pop_back();
+            return true;
+        case op_t::INSERT: {
+            if (n >= max_size) return false;
+            std::ptrdiff_t pos = op.a % (n + 1);
+            T x = traits::make(value);
+            v.insert(v.begin() + pos, x);
+            ref.insert(ref.begin() + pos, x);
+            return true;
+        }
+        case op_t::INSERT_SELF: {
+            if (n == 0 or n >= max_size) return false;
+            std::ptrdiff_t pos = op.a % (n + 1);
+            std::size_t src = op.b % n;
+            v.insert(v.begin() + pos, v[src]);
+            ref.insert(ref.begin() + pos, ref[src]);
+            return true;
+        }
+        case op_t::INSERT_RANGE:
+        case op_t::INSERT_INPUT: {
+            if (n + values.size() > max_size) return false;
+            std::ptrdiff_t pos = op.a % (n + 1);
+            if (op.kind == op_t::INSERT_RANGE)
+                v.insert(v.begin() + pos, values.begin(), values.end());
+            else
+                v.insert(v.begin() + pos, input_iterator<T>(values.data()),
+                         input_iterator<T>(values.data() + values.size()));
+            ref.insert(ref.begin() + pos, values.begin(), values.end());
+            return true;
+        }
+        case op_t::INSERT_SELF_RANGE: {
+            if (n == 0) return false;
+            std::size_t i = op.b % n, j = i + op.c % (n - i + 1);
+            if (n + (j - i) > max_size) return false;
+            std::ptrdiff_t pos = op.a % (n + 1);
+            v.insert(v.begin() + pos, v.begin() + i, v.begin() + j);
+            std::vector<T> copy(ref.begin() + i, ref.begin() + j);  // std::vector does not allow aliasing here.
+            ref.insert(ref.begin() + pos, copy.begin(), copy.end());
+            return true;
+        }
+        case op_t::ERASE: {
+            if (n == 0) return false;
+            std::ptrdiff_t pos = op.a % n;
+            v.erase(v.begin() + pos);
+            ref.erase(ref.begin() + pos);
+            return true;
+        }
+        case op_t::ERASE_RANGE: {
+            std::size_t i = op.a % (n + 1), j = i + op.b % (n - i + 1);
+            v.erase(v.begin() + i, v.begin() + j);
+            ref.erase(ref.begin() + i, ref.begin() + j);
+            return true;
+        }
+        case op_t::ASSIGN_FILL: {
+            std::size_t count = op.a % 64 < max_size ? op.a % 64 : max_size;
+            T x = traits::make(value);
+            v.assign(count, x);
+            ref.assign(count, x);
+            return true;
+        }
+        case op_t::ASSIGN_RANGE:
+            v.assign(values.begin(), values.end());
+            ref.assign(values.begin(), values.end());
+            return true;
+        case op_t::ASSIGN_SELF: {
+            std::size_t i = op.a % (n + 1), j = i + op.b % (n - i + 1);
+            v.assign(v.begin() + i, v.begin() + j);
+            std::vector<T> copy(ref.begin() + i, ref.begin() + j);
+            ref.assign(copy.begin(), copy.end());
+            return true;
+        }
+        case op_t::RESERVE:
+            v.reserve(static_cast<typename Vec::size_type>(op.a) * 2);
+            return true;
+        case op_t::SHRINK_TO_FIT:
+            v.shrink_to_fit();
+            return true;
+        case op_t::CLEAR:
+            v.clear();
+            ref.clear();
+            return true;
+        case op_t::COPY: {
+            Vec copy(v);
+            Vec other;
+            other = copy;
+            v = other;
+            return true;
+        }
+        case op_t::COUNT: break;
+    }
+    return false;
+}
+
+/// Describes the first difference between the vector under test and the reference, or returns "".
+template <typename Vec, typename T>
+std::string compare(const Vec& v, const std::vector<T>& ref, long live_before) {
+    typedef element_traits<T> traits;
+    std::ostringstream oss;
+    if (v.size() != ref.size())
+        oss << "size " << v.size() << ", expected " << ref.size();
+    else if (v.capacity() < v.size())
+        oss << "capacity " << v.capacity() << " below size " << v.size();
+    else if (static_cast<std::size_t>(v.cend() - v.cbegin()) != ref.size())
+        oss << "end() - begin() is " << (v.cend() - v.cbegin()) << ", expected " << ref.size();
+    else {
+        for (std::size_t i{0}; i < ref.size(); ++i)
+            if (not(v[i] == ref[i])) {
+                oss << "element " << i << " differs";
+                break;
+            }
+    }
+    if (oss.str().empty() and traits::violations() != 0)
+        oss << traits::violations() << " access(es) to destroyed or relocated elements";
+    if (oss.str().empty() and traits::live() >= 0 and
+        traits::live() - live_before != static_cast<long>(v.size() + ref.size()))
+        oss << traits::live() - live_before - static_cast<long>(v.size() + ref.size())
+            << " element(s) leaked or destroyed twice";
+    return oss.str();
+}
+
+}  // namespace detail.
+
+/// Runs `program` on a `Vec` and a std::vector side by side, comparing them after every operation.
+/*!
+ * \tparam Vec An sc::vector configuration.
+ * @param max_size The operations that would grow the vectors beyond this size are skipped.
+ * @return The first step after which the vectors differed, or -1 and an empty message.
+ */
+template <typename Vec>
+Failure run_program(const program_t& program, std::size_t max_size = 256) {
+    typedef typename Vec::value_type T;
+    const long live_before = element_traits<T>::live();
+    element_traits<T>::reset();
+    Failure result{-1, ""};
+    {
+        Vec v;
+        std::vector<T> ref;
+        for (std::size_t step{0}; step < program.size(); ++step) {
+            try {
+                detail::apply(v, ref, program[step], max_size);
+            } catch (const std::exception& e) {
+                result = Failure{static_cast<long>(step), std::string("exception: ") + e.what()};
+                break;
+            }
+            std::string what = detail::compare(v, ref, live_before);
+            if (not what.empty()) {
+                result = Failure{static_cast<long>(step), what};
+                break;
+            }
+        }
+    }
+    if (not result.failed() and element_traits<T>::live() >= 0 and element_traits<T>::live() != live_before)
+        result = Failure{static_cast<long>(program.size()) - 1, "elements leaked by the destructor"};
+    return result;
+}
+
+/// Reduces a program for which `fails(program)` holds to a smaller one that still fails.
+/*!
+ * Removes chunks of operations, halving the chunk size down to single operations, then
+ * zeroes the argument bytes one by one; repeats until nothing changes.
+ */
+template <typename Pred>
+program_t shrink(program_t program, Pred fails) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t chunk = program.size() / 2 > 0 ? program.size() / 2 : 1; chunk > 0; chunk /= 2) {
+            for (std::size_t start{0}; start + chunk <= program.size();) {
+                program_t candidate(program.begin(), program.begin() + start);
+                candidate.insert(candidate.end(), program.begin() + start + chunk, program.end());
+                if (fails(candidate)) {
+                    program.swap(candidate);
+                    changed = true;
+                } else {
+                    start += chunk;
+                }
+            }
+        }
+        for (std::size_t i{0}; i < program.size(); ++i) {
+            std::uint8_t Op::*fields[] = {&Op::a, &Op::b, &Op::c};
+            for (auto field : fields) {
+                if (program[i].*field == 0) continue;
+                program_t candidate = program;
+                candidate[i].*field = 0;
+                if (fails(candidate)) {
+                    program.swap(candidate);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return program;
+}
+
+/// A vector configuration under test.
+struct Config {
+    const char* name;                                        //!< Readable name.
+    Failure (*run)(const program_t& program, std::size_t max_size);  //!< run_program<Vec>.
+};
+
+/// The configurations covering the fast paths: memmove for trivial and relocatable
+/// elements, element-wise shifts for the others, the compact layout, a shrink policy and
+/// the buffer cache.
+inline const std::vector<Config>& configs(void) {
+    static const std::vector<Config> all{
+        {"vector<int>", &run_program<sc::vector<int>>},
+        {"vector<int, compact<uint32_t>>", &run_program<sc::vector<int, sc::compact<std::uint32_t>>>},
+        {"vector<int, cached_storage>",
+         &run_program<sc::vector<int, unsigned long, sc::never_shrink, sc::cached_storage>>},
+        {"vector<Probe, shrink_below<4>>", &run_program<sc::vector<Probe, unsigned long, sc::shrink_below<4>>>},
+        {"vector<shared_ptr<int>>", &run_program<sc::vector<std::shared_ptr<int>>>},
+        {"vector<string>", &run_program<sc::vector<std::string>>},
+    };
+    return all;
+}
+
+}  // namespace fuzz.
+#endif
@@ -0,0 +1,52 @@
+#ifndef _SAME_CONTENTS_H_
+#define _SAME_CONTENTS_H_
+
+/*!
+ * @file same_contents.h
+ * @brief Compares a container under test with a reference range, for the test suites.
+ */
+
+#include <cstddef>   // std::size_t, std::ptrdiff_t
+#include <iterator>  // std::iterator_traits
+
+namespace test_detail {
+
+/// Whether [first, last) holds `n` elements, by subtraction (random access iterators only).
+template <typename Itr>
+bool spans(Itr first, Itr last, std::ptrdiff_t n, std::random_access_iterator_tag) {
+    return last - first == n;
+}
+/// Other iterators were already counted by the caller.
+template <typename Itr>
+bool spans(Itr, Itr, std::ptrdiff_t, std::input_iterator_tag) {
+    return true;
+}
+
+}  // namespace test_detail
+
+/**
+ * @brief Whether `c` holds the elements of `ref`, in order.
+ *
+ * Checks size(), operator[] and a full iteration with the const iterators; random access
+ * iterators must also be `size()` apart.
+ */
+template <typename Container, typename Reference>
+bool same_contents(const Container& c, const Reference& ref) {
+    std::size_t n{0};
+    for (auto r = ref.cbegin(); r != ref.cend(); ++r) ++n;
+    if (static_cast<std::size_t>(c.size()) != n) return false;
+
+    std::size_t i{0};
+    for (auto r = ref.cbegin(); r != ref.cend(); ++r, ++i)
+        if (not(c[i] == *r)) return false;
+
+    i = 0;
+    auto r = ref.cbegin();
+    for (auto it = c.cbegin(); it != c.cend(); ++it, ++r, ++i)
+        if (i == n or not(*it == *r)) return false;
+
+    using category = typename std::iterator_traits<decltype(c.cbegin())>::iterator_category;
+    return i == n and test_detail::spans(c.cbegin(), c.cend(), static_cast<std::ptrdiff_t>(n), category());
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*!
+ * @file alloc_count.cpp
+ * @brief Replacements of the global operator new and delete that count the allocations.
+ *
+ * All forms are replaced, so that every block is obtained and released by the same functions.
+ */
+
+#include <atomic>
+#include <cstdlib>  // malloc, free
+#include <new>      // bad_alloc, nothrow_t
+
+#include "perf_check.h"
+
+namespace {
+/// Calls to the global operator new.
+std::atomic<size_t> g_allocations{0};
+
+void *counted_alloc(std::size_t size) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}  // namespace
+
+size_t allocation_count(void) { return g_allocations.load(std::memory_order_relaxed); }
+
+void *operator new(std::size_t size) {
+    void *p = counted_alloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](std::size_t size) {
+    void *p = counted_alloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return counted_alloc(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+// The sized forms, called by code built as C++14 or later.
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
@@ -0,0 +1,434 @@
+/*!
+ * @file perf_check.cpp
+ * @brief Implementation of the timing baselines and of the performance regression gate.
+ */
+
+#include "perf_check.h"
+
+#include <algorithm>  // sort, max
+#include <cctype>   // isspace
+#include <cmath>    // erfc, sqrt
+#include <cstdlib>  // strtod, strtoul
+#include <fstream>
+#include <iomanip>  // setw, setprecision
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <utility>  // pair
+
+#include "test_manager.h"
+
+//=== PerfLog.
+
+PerfLog &PerfLog::instance(void) {
+    static PerfLog log;
+    return log;
+}
+
+/*!
+ * Appends the samples of one run of a test to the ones of the previous runs.
+ * @param name "suite/test".
+ * @param samples_ns Durations in nanoseconds: one for a test, one per repetition for a BENCH_TEST.
+ * @param allocations Allocations of the run (per repetition for a BENCH_TEST).
+ */
+void PerfLog::add(const std::string &name, const std::vector<double> &samples_ns, double allocations) {
+    PerfRecord &record = m_records[name];
+    if (record.samples_ns.empty() or allocations < record.allocations) record.allocations = allocations;
+    if (record.samples_ns.empty() or allocations > record.allocations_max) record.allocations_max = allocations;
+    record.samples_ns.insert(record.samples_ns.end(), samples_ns.begin(), samples_ns.end());
+}
+
+/// Remembers that a test failed, in any run.
+void PerfLog::fail(const std::string &name) {
+    if (std::find(m_failures.begin(), m_failures.end(), name) == m_failures.end()) m_failures.push_back(name);
+}
+
+/// Writes `s` as a JSON string.
+static void write_json_string(std::ostream &out, const std::string &s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"' or c == '\\')
+            out << '\\' << c;
+        else if (c == '\n')
+            out << "\\n";
+        else if (static_cast<unsigned char>(c) < 0x20)
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+                << std::setfill(' ');
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+/*!
+ * The baseline is a JSON object whose "tests" member lists, for each test, its name, the
+ * range of allocations of a run and all its samples in nanoseconds.
+ */
+bool PerfLog::save(const std::string &path, const perf_records_t &records) {
+    std::ofstream out(path);
+    if (not out) return false;
+    out << "{\n  \"format\": \"tm-perf-1\",\n  \"tests\": [";
+    bool first{true};
+    for (const auto &r : records) {
+        out << (first ? "\n" : ",\n") << "    {\"name\": ";
+        write_json_string(out, r.first);
+        out << ", \"allocations\": " << r.second.allocations << ", \"allocations_max\": " << r.second.allocations_max
+            << ", \"samples_ns\": [";
+        for (size_t i{0}; i < r.second.samples_ns.size(); ++i)
+            out << (i == 0 ? "" : ", ") << std::setprecision(10) << r.second.samples_ns[i];
+        out << "]}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+namespace {
+/// Reads the JSON subset written by PerfLog::save(). Every method returns `false` on malformed input.
+class JsonReader {
+   private:
+    const std::string &m_text;  //!< The document.
+    size_t m_pos;               //!< Next character to read.
+
+   public:
+    explicit JsonReader(const std::string &text) : m_text(text), m_pos{0} {}
+
+    /// Skips blanks and tells whether the next character is `c`.
+    bool peek(char c) {
+        while (m_pos < m_text.size() and std::isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos;
+        return m_pos < m_text.size() and m_text[m_pos] == c;
+    }
+    /// Like peek(), consuming `c` if found.
+    bool accept(char c) {
+        if (not peek(c)) return false;
+        ++m_pos;
+        return true;
+    }
+    bool string(std::string &s) {
+        if (not accept('"')) return false;
+        s.clear();
+        while (m_pos < m_text.size() and m_text[m_pos] != '"') {
+            char c = m_text[m_pos++];
+            if (c == '\\') {
+                if (m_pos >= m_text.size()) return false;
+                c = m_text[m_pos++];
+                if (c == 'n')
+                    c = '\n';
+                else if (c == 'u') {
+                    if (m_pos + 4 > m_text.size()) return false;
+                    c = static_cast<char>(std::strtoul(m_text.substr(m_pos, 4).c_str(), nullptr, 16));
+                    m_pos += 4;
+                }
+            }
+            s += c;
+        }
+        return accept('"');
+    }
+    bool number(double &x) {
+        peek(' ');  // Skips blanks.
+        const char *begin = m_text.c_str() + m_pos;
+        char *end = nullptr;
+        x = std::strtod(begin, &end);
+        m_pos += static_cast<size_t>(end - begin);
+        return end != begin;
+    }
+    bool numbers(std::vector<double> &xs) {
+        if (not accept('[')) return false;
+        if (accept(']')) return true;
+        do {
+            double x;
+            if (not number(x)) return false;
+            xs.push_back(x);
+        } while (accept(','));
+        return accept(']');
+    }
+    /// Skips a string, number or array of numbers, the values of the members it does not know.
+    bool skip(void) {
+        std::string s;
+        std::vector<double> xs;
+        double x;
+        if (peek('"')) return string(s);
+        if (peek('[')) return numbers(xs);
+        return number(x);
+    }
+    bool test(std::string &name, PerfRecord &record) {
+        if (not accept('{')) return false;
+        do {
+            std::string key;
+            if (not string(key) or not accept(':')) return false;
+            bool ok = key == "name" ? string(name)
+                      : key == "allocations" ? number(record.allocations)
+                      : key == "allocations_max" ? number(record.allocations_max)
+                      : key == "samples_ns"  ? numbers(record.samples_ns)
+                                             : skip();
+            if (not ok) return false;
+        } while (accept(','));
+        return accept('}');
+    }
+    bool document(perf_records_t &records) {
+        if (not accept('{')) return false;
+        do {
+            std::string key;
+            if (not string(key) or not accept(':')) return false;
+            if (key != "tests") {
+                if (not skip()) return false;
+                continue;
+            }
+            if (not accept('[')) return false;
+            if (accept(']')) continue;
+            do {
+                std::string name;
+                PerfRecord record;
+                if (not test(name, record)) return false;
+                records[name] = record;
+            } while (accept(','));
+            if (not accept(']')) return false;
+        } while (accept(','));
+        return accept('}');
+    }
+};
+}  // namespace
+
+bool PerfLog::load(const std::string &path, perf_records_t &records) {
+    std::ifstream in(path);
+    if (not in) return false;
+    std::ostringstream text;
+    text << in.rdbuf();
+    std::string document = text.str();
+    records.clear();
+    return JsonReader{document}.document(records);
+}
+
+//=== Statistics.
+
+double median(std::vector<double> samples) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    return n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+}
+
+double mann_whitney_p(const std::vector<double> &a, const std::vector<double> &b) {
+    const double n1 = static_cast<double>(a.size());
+    const double n2 = static_cast<double>(b.size());
+    if (a.empty() or b.empty()) return 1;
+
+    // Ranks of the pooled samples (ties get the average rank); the flag marks samples of `b`.
+    std::vector<std::pair<double, bool>> pooled;
+    for (double x : a) pooled.push_back(std::make_pair(x, false));
+    for (double x : b) pooled.push_back(std::make_pair(x, true));
+    std::sort(pooled.begin(), pooled.end());
+
+    double rank_sum_b{0}, ties{0};
+    for (size_t i{0}; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() and pooled[j].first == pooled[i].first) ++j;
+        double t = static_cast<double>(j - i);
+        double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2;
+        for (size_t k{i}; k < j; ++k)
+            if (pooled[k].second) rank_sum_b += rank;
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    // Normal approximation of U, with the tie and continuity corrections.
+    const double n = n1 + n2;
+    const double u = rank_sum_b - n2 * (n2 + 1) / 2;
+    const double variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)));
+    if (variance <= 0) return 1;
+    const double z = (u - n1 * n2 / 2 - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/*!
+ * A test is slower when its median grew beyond the tolerance and the Mann-Whitney test finds
+ * the slowdown significant; faster in the symmetric case. Without a significant change in time,
+ * a test is flagged too when its fewest allocations exceed the most of the baseline beyond the
+ * tolerance, so that counts varying with thread timing do not raise false alarms.
+ */
+std::vector<PerfDiff> perf_compare(const perf_records_t &baseline, const perf_records_t &current,
+                                   const PerfOptions &options) {
+    std::vector<PerfDiff> diffs;
+    for (const auto &c : current) {
+        PerfDiff d;
+        d.name = c.first;
+        d.new_ns = median(c.second.samples_ns);
+        d.new_allocs = c.second.allocations;
+        auto b = baseline.find(c.first);
+        if (b == baseline.end()) {
+            d.base_ns = d.base_allocs = 0;
+            d.p_value = 1;
+            d.verdict = PerfDiff::verdict_t::ADDED;
+            diffs.push_back(d);
+            continue;
+        }
+        d.base_ns = median(b->second.samples_ns);
+        d.base_allocs = b->second.allocations_max;
+        bool measurable = std::max(d.base_ns, d.new_ns) >= options.min_ns;
+        double p_slower = mann_whitney_p(b->second.samples_ns, c.second.samples_ns);
+        double p_faster = mann_whitney_p(c.second.samples_ns, b->second.samples_ns);
+        d.p_value = d.new_ns >= d.base_ns ? p_slower : p_faster;
+        d.verdict = PerfDiff::verdict_t::SAME;
+        if (measurable and d.new_ns > d.base_ns * (1 + options.tolerance) and p_slower < options.alpha)
+            d.verdict = PerfDiff::verdict_t::SLOWER;
+        else if (d.new_allocs > d.base_allocs * (1 + options.tolerance) and d.new_allocs - d.base_allocs >= 1)
+            d.verdict = PerfDiff::verdict_t::MORE_ALLOCS;
+        else if (measurable and d.new_ns * (1 + options.tolerance) < d.base_ns and p_faster < options.alpha)
+            d.verdict = PerfDiff::verdict_t::FASTER;
+        diffs.push_back(d);
+    }
+    for (const auto &b : baseline) {
+        if (current.count(b.first) != 0) continue;
+        PerfDiff d;
+        d.name = b.first;
+        d.base_ns = median(b.second.samples_ns);
+        d.base_allocs = b.second.allocations_max;
+        d.new_ns = d.new_allocs = 0;
+        d.p_value = 1;
+        d.verdict = PerfDiff::verdict_t::REMOVED;
+        diffs.push_back(d);
+    }
+    return diffs;
+}
+
+void print_perf_table(std::vector<PerfDiff> diffs, const PerfOptions &options) {
+    std::stable_sort(diffs.begin(), diffs.end(),
+                     [](const PerfDiff &a, const PerfDiff &b) { return a.regressed() and not b.regressed(); });
+
+    const int name_width = 56;
+    std::cout << std::left << std::setw(name_width) << "Test" << std::right << std::setw(13) << "Baseline"
+              << std::setw(13) << "Current" << std::setw(9) << "Change" << std::setw(8) << "p" << std::setw(18)
+              << "Allocations"
+              << "  Verdict\n"
+              << std::string(name_width + 13 + 13 + 9 + 8 + 18 + 14, '-') << "\n";
+
+    size_t regressions{0};
+    for (const PerfDiff &d : diffs) {
+        std::string name = d.name.size() > static_cast<size_t>(name_width - 1)
+                               ? "..." + d.name.substr(d.name.size() - (name_width - 4))
+                               : d.name;
+        std::ostringstream change, p, allocs;
+        bool both = d.verdict != PerfDiff::verdict_t::ADDED and d.verdict != PerfDiff::verdict_t::REMOVED;
+        if (both and d.base_ns > 0)
+            change << std::showpos << std::fixed << std::setprecision(1) << (d.new_ns / d.base_ns - 1) * 100 << "%";
+        if (both) p << std::fixed << std::setprecision(3) << d.p_value;
+        allocs << d.base_allocs << " -> " << d.new_allocs;
+
+        const char *verdict = "ok";
+        switch (d.verdict) {
+            case PerfDiff::verdict_t::SAME: break;
+            case PerfDiff::verdict_t::FASTER: verdict = "\e[1;32mfaster\e[0m"; break;
+            case PerfDiff::verdict_t::SLOWER: verdict = "\e[1;31mSLOWER\e[0m"; break;
+            case PerfDiff::verdict_t::MORE_ALLOCS: verdict = "\e[1;31mMORE ALLOCATIONS\e[0m"; break;
+            case PerfDiff::verdict_t::ADDED: verdict = "new"; break;
+            case PerfDiff::verdict_t::REMOVED: verdict = "gone"; break;
+        }
+        if (d.regressed()) ++regressions;
+
+        std::cout << std::left << std::setw(name_width) << name << std::right << std::setw(13)
+                  << (d.verdict == PerfDiff::verdict_t::ADDED ? "-" : TestManager::format_duration(d.base_ns))
+                  << std::setw(13)
+                  << (d.verdict == PerfDiff::verdict_t::REMOVED ? "-" : TestManager::format_duration(d.new_ns))
+                  << std::setw(9) << change.str() << std::setw(8) << p.str() << std::setw(18) << allocs.str() << "  "
+                  << verdict << "\n";
+    }
+    std::cout << "\n"
+              << diffs.size() << " tests compared (tolerance " << options.tolerance * 100 << "%, alpha "
+              << options.alpha << "): " << regressions << " regression" << (regressions == 1 ? "" : "s") << ".\n";
+}
+
+//=== Driver.
+
+namespace {
+/// Swallows everything written to it.
+class NullBuffer : public std::streambuf {
+   protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+/// Reads the value of `--name=value` into `value`; `false` if `arg` is another option.
+bool option(const std::string &arg, const std::string &name, std::string &value) {
+    std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+void usage(const char *program) {
+    std::cerr << "Usage: " << program << " [--perf-record=FILE | --perf-check=FILE] [--perf-runs=N]"
+              << " [--perf-tolerance=X] [--perf-alpha=X] [--perf-min-ns=X]\n";
+}
+}  // namespace
+
+int perf_main(int argc, char *argv[], void (*run_suites)(void)) {
+    std::string record_path, check_path, value;
+    unsigned long runs{5};
+    PerfOptions options;
+    for (int i{1}; i < argc; ++i) {
+        std::string arg{argv[i]};
+        if (option(arg, "perf-record", record_path) or option(arg, "perf-check", check_path)) continue;
+        if (option(arg, "perf-runs", value))
+            runs = std::strtoul(value.c_str(), nullptr, 10);
+        else if (option(arg, "perf-tolerance", value))
+            options.tolerance = std::strtod(value.c_str(), nullptr);
+        else if (option(arg, "perf-alpha", value))
+            options.alpha = std::strtod(value.c_str(), nullptr);
+        else if (option(arg, "perf-min-ns", value))
+            options.min_ns = std::strtod(value.c_str(), nullptr);
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (record_path.empty() == check_path.empty() or runs == 0) {
+        if (record_path.empty() and check_path.empty() and argc == 1) {
+            run_suites();
+            return 0;
+        }
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Runs the suites with their reports muted.
+    PerfLog &log = PerfLog::instance();
+    log.clear();
+    NullBuffer null;
+    for (unsigned long r{0}; r < runs; ++r) {
+        std::cout << "Run " << r + 1 << "/" << runs << "..." << std::endl;
+        std::streambuf *out = std::cout.rdbuf(&null);
+        std::streambuf *err = std::cerr.rdbuf(&null);
+        run_suites();
+        std::cout.rdbuf(out);
+        std::cerr.rdbuf(err);
+    }
+    if (not log.failures().empty()) {
+        std::cout << "Failed tests, no timings compared:\n";
+        for (const auto &name : log.failures()) std::cout << "  " << name << "\n";
+        return 1;
+    }
+
+    perf_records_t baseline;
+    if (record_path.empty() and not PerfLog::load(check_path, baseline)) {
+        if (std::ifstream(check_path)) {
+            std::cerr << "Malformed baseline " << check_path << ".\n";
+            return 2;
+        }
+        std::cout << "No baseline in " << check_path << " yet: recording this run.\n";
+        record_path = check_path;
+    }
+    if (not record_path.empty()) {
+        if (not PerfLog::save(record_path, log.records())) {
+            std::cerr << "Could not write " << record_path << ".\n";
+            return 2;
+        }
+        std::cout << "Baseline of " << log.records().size() << " tests (" << runs << " runs) written to "
+                  << record_path << ".\n";
+        return 0;
+    }
+
+    std::vector<PerfDiff> diffs = perf_compare(baseline, log.records(), options);
+    print_perf_table(diffs, options);
+    for (const PerfDiff &d : diffs)
+        if (d.regressed()) return 1;
+    return 0;
+}
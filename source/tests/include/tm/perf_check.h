@@ -0,0 +1,121 @@
+#ifndef _PERF_CHECK_
+#define _PERF_CHECK_
+
+/*!
+ * @file perf_check.h
+ * @brief Timing baselines and the performance regression gate of the test driver.
+ *
+ * Every TestManager reports the time and the number of allocations of its tests to the
+ * process-wide PerfLog. In perf mode the driver runs all suites several times, then either
+ * writes the samples to a JSON baseline or compares them with one, test by test.
+ */
+
+#include <cstddef>  // size_t
+#include <map>
+#include <string>
+#include <vector>
+
+/// Number of calls to the global operator new so far, in all threads.
+size_t allocation_count(void);
+
+/// Samples gathered for one test or benchmark.
+struct PerfRecord {
+    std::vector<double> samples_ns;  //!< One per run of a test, or one per repetition of a BENCH_TEST.
+    double allocations;              //!< Fewest allocations of a run (per repetition for a BENCH_TEST).
+    double allocations_max;          //!< Most allocations of a run; threads can make the count vary.
+
+    PerfRecord(void) : samples_ns{}, allocations{0}, allocations_max{0} { /* empty */
+    }
+};
+
+/// Samples of every test, by "suite/test" name.
+typedef std::map<std::string, PerfRecord> perf_records_t;
+
+/// Collects the timings reported by every TestManager of the process.
+class PerfLog {
+   private:
+    perf_records_t m_records;              //!< The samples so far.
+    std::vector<std::string> m_failures;  //!< Tests that failed in some run.
+
+    PerfLog(void) = default;
+
+   public:
+    /// The log of the process.
+    static PerfLog &instance(void);
+
+    /// Adds the samples of a run of a test, and its allocation count.
+    void add(const std::string &name, const std::vector<double> &samples_ns, double allocations);
+    /// The samples so far.
+    const perf_records_t &records(void) const { return m_records; }
+    /// Records that a test failed.
+    void fail(const std::string &name);
+    /// Tests that failed so far.
+    const std::vector<std::string> &failures(void) const { return m_failures; }
+    /// Forgets all samples and failures.
+    void clear(void) {
+        m_records.clear();
+        m_failures.clear();
+    }
+
+    /// Writes `records` to `path` as JSON; returns `false` if the file could not be written.
+    static bool save(const std::string &path, const perf_records_t &records);
+    /// Reads a file written by save(); returns `false` if it is missing or malformed.
+    static bool load(const std::string &path, perf_records_t &records);
+};
+
+/// Thresholds of a comparison against a baseline.
+struct PerfOptions {
+    double tolerance;  //!< Slowdown of the median accepted as noise (0.10 is 10%).
+    double alpha;      //!< Significance level of the Mann-Whitney test.
+    double min_ns;     //!< Tests whose medians are both below this are never flagged.
+
+    PerfOptions(void) : tolerance{0.10}, alpha{0.01}, min_ns{1e5} { /* empty */
+    }
+};
+
+/// One line of the comparison of a test against its baseline.
+struct PerfDiff {
+    /// Verdict on the test.
+    enum class verdict_t : int { SAME, FASTER, SLOWER, MORE_ALLOCS, ADDED, REMOVED };
+
+    std::string name;    //!< "suite/test".
+    double base_ns;      //!< Baseline median.
+    double new_ns;       //!< Current median.
+    double p_value;      //!< Probability of a change this large in the direction of the medians by chance.
+    double base_allocs;  //!< Most allocations of a baseline run.
+    double new_allocs;   //!< Fewest allocations of a current run.
+    verdict_t verdict;   //!< Outcome.
+
+    /// Whether the test regressed.
+    bool regressed(void) const { return verdict == verdict_t::SLOWER or verdict == verdict_t::MORE_ALLOCS; }
+};
+
+/// Median of a list of samples (0 for an empty list).
+double median(std::vector<double> samples);
+
+/// One-sided Mann-Whitney U test: p-value of `b` being stochastically larger than `a`.
+/*!
+ * Uses the normal approximation with tie and continuity corrections; it returns 1 when
+ * either list is empty or all samples are equal.
+ */
+double mann_whitney_p(const std::vector<double> &a, const std::vector<double> &b);
+
+/// Compares each test of `current` with the same test of `baseline`.
+std::vector<PerfDiff> perf_compare(const perf_records_t &baseline, const perf_records_t &current,
+                                   const PerfOptions &options);
+
+/// Prints the comparison as a table, regressions first.
+void print_perf_table(std::vector<PerfDiff> diffs, const PerfOptions &options);
+
+/// Entry point of the test driver.
+/*!
+ * Without options, runs the suites once. Otherwise runs them `--perf-runs=N` times (5 by default)
+ * with their output muted, and then:
+ * - `--perf-record=FILE` writes the samples to the baseline FILE;
+ * - `--perf-check=FILE` compares them with FILE (recording it if missing), prints the diff table
+ *   and returns 1 on a significant regression. `--perf-tolerance=X` and `--perf-alpha=X` tune the gate.
+ * @return The exit status of the driver.
+ */
+int perf_main(int argc, char *argv[], void (*run_suites)(void));
+
+#endif
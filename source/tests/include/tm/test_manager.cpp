@@ -7,6 +7,9 @@
 
 #include "test_manager.h"
 
+#include <cmath>    // sqrt
+#include <sstream>  // ostringstream
+
 /*!
  * Updates the test result database.
  * @param key The unique test key, which is the test's name.
@@ -24,7 +27,98 @@ void TestManager::result(const std::string& key, bool value, int line) {
     }
 }
 
-void TestManager::summary(void) const {
+/*!
+ * Stores the time taken by a test, measured by the `Timer` of BEGIN_TEST, and reports it to
+ * the PerfLog (a BENCH_TEST has reported its repetitions already).
+ * @param key The unique test key, which is the test's name.
+ * @param wall_ms Wall-clock time, in milliseconds.
+ * @param cpu_ms CPU time, in milliseconds.
+ * @param allocations Calls to operator new during the test.
+ */
+void TestManager::record_time(const std::string& key, double wall_ms, double cpu_ms, size_t allocations) {
+    Entry& entry = tests_record[key];
+    entry.m_wall_ms = wall_ms;
+    entry.m_cpu_ms = cpu_ms;
+    if (entry.m_runs == 0)
+        PerfLog::instance().add(test_suite_name + "/" + key, std::vector<double>{wall_ms * 1e6},
+                                static_cast<double>(allocations));
+    if (entry.m_result == Entry::result_t::FAILED) PerfLog::instance().fail(test_suite_name + "/" + key);
+}
+
+/*!
+ * Stores the statistics of the timed runs of a BENCH_TEST. A benchmark without any
+ * expectation that failed counts as a success.
+ * @param key The unique test key, which is the test's name.
+ * @param samples Duration of each timed run, in nanoseconds.
+ * @param allocations Average calls to operator new per timed run.
+ */
+void TestManager::record_bench(const std::string& key, std::vector<double> samples, double allocations) {
+    Entry& entry = tests_record[key];
+    if (samples.empty()) return;
+    PerfLog::instance().add(test_suite_name + "/" + key, samples, allocations);
+
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    double mean{0};
+    for (double x : samples) mean += x;
+    mean /= static_cast<double>(n);
+    double variance{0};
+    for (double x : samples) variance += (x - mean) * (x - mean);
+
+    entry.m_runs = n;
+    entry.m_min_ns = samples.front();
+    entry.m_median_ns = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    entry.m_stddev_ns = n > 1 ? std::sqrt(variance / static_cast<double>(n - 1)) : 0.0;
+    if (entry.m_result == Entry::result_t::UNDEFINED) entry.m_result = Entry::result_t::SUCCESS;
+}
+
+/*!
+ * Closes the run that just ended (timing it, unless it was a warmup run) and starts the next one.
+ * @return `true` while the body of the benchmark must run again.
+ */
+bool TestManager::BenchRun::next(void) {
+    if (m_timing) {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count());
+        m_allocs += allocation_count() - m_alloc_start;
+    }
+    if (m_warmup > 0) {
+        --m_warmup;
+        m_timing = false;
+        return true;
+    }
+    if (m_samples.size() == m_iterations) {
+        m_tm.record_bench(m_key, m_samples, static_cast<double>(m_allocs) / static_cast<double>(m_iterations));
+        return false;
+    }
+    m_timing = true;
+    m_alloc_start = allocation_count();
+    m_start = std::chrono::steady_clock::now();
+    return true;
+}
+
+/*!
+ * Formats a duration with three significant decimals and the largest unit below it.
+ * @param ns The duration in nanoseconds.
+ */
+std::string TestManager::format_duration(double ns) {
+    const char* unit = "ns";
+    if (ns >= 1e9) {
+        ns /= 1e9;
+        unit = "s";
+    } else if (ns >= 1e6) {
+        ns /= 1e6;
+        unit = "ms";
+    } else if (ns >= 1e3) {
+        ns /= 1e3;
+        unit = "us";
+    }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << ns << " " << unit;
+    return oss.str();
+}
+
+void TestManager::summary(order_t order) const {
     size_t n_successful{0}, n_failed{0}, n_disabled{0}, n_undefined{0};
 
     // This list helps us to print all the test results in the same order
@@ -36,6 +130,11 @@ void TestManager::summary(void) const {
     // Sort the vector
     std::sort(sorted_list.begin(), sorted_list.end(),
               [](const hash_item& h1, const hash_item& h2) -> bool { return h1.second.m_seq < h2.second.m_seq; });
+    // Or by decreasing wall-clock time, to spot the slowest tests.
+    if (order == order_t::SLOWEST)
+        std::stable_sort(sorted_list.begin(), sorted_list.end(), [](const hash_item& h1, const hash_item& h2) -> bool {
+            return h1.second.m_wall_ms > h2.second.m_wall_ms;
+        });
 
     // Print out the tests result from the sorted list.
     std::cout << "[===========] Running " << n_tests << " from the \"" << test_suite_name << "\" test suite.\n";
@@ -50,7 +149,13 @@ void TestManager::summary(void) const {
         else if (t.second.m_result == TestManager::Entry::result_t::UNDEFINED)
             n_undefined++;
     }
-    std::cout << "[===========] " << n_tests << " tests from the \"" << test_suite_name << "\" test suite ran.\n";
+    std::cout << "[===========] " << n_tests << " tests from the \"" << test_suite_name << "\" test suite ran";
+    if (show_times) {
+        double total_ms{0};
+        for (const auto& t : sorted_list) total_ms += t.second.m_wall_ms;
+        std::cout << " in " << format_duration(total_ms * 1e6);
+    }
+    std::cout << ".\n";
 
     // Final summary
     if (n_successful != 0)
@@ -8,8 +8,11 @@
  * @author Selan R. dos Santos
  *
  * Updated on January 27th, 2021: improved macro definition and unified divergent versions.
+ * Updated with a timing mode: wall-clock and CPU time per test, and BENCH_TEST for micro-benchmarks.
+ * Updated with allocation counts and the perf baseline of the driver (see perf_check.h).
  */
 
+#include <cstdlib>   // getenv
 #include <iostream>  // cout, endl
 using std::cout;
 using std::endl;
@@ -25,6 +28,11 @@ using std::string;
 using std::unordered_map;
 #include <vector>
 using std::vector;
+#include <chrono>  // steady_clock
+#include <ctime>   // clock
+#include <atomic>  // atomic_signal_fence
+
+#include "perf_check.h"  // allocation_count, PerfLog
 
 /// Implements a simple test manager.
 class TestManager {
@@ -38,9 +46,25 @@ class TestManager {
         result_t m_result;  //!< The test result.
         int m_line;         //!< The test line number.
         bool m_enabled;     //!< Indicates wheter the test is enabled (default) or not.
+        double m_wall_ms;   //!< Wall-clock time of the whole test, in milliseconds.
+        double m_cpu_ms;    //!< CPU time of the whole test (all threads), in milliseconds.
+        size_t m_runs;      //!< Timed repetitions of a BENCH_TEST; 0 for a regular test.
+        double m_min_ns;    //!< Fastest repetition, in nanoseconds.
+        double m_median_ns; //!< Median repetition, in nanoseconds.
+        double m_stddev_ns; //!< Standard deviation of the repetitions, in nanoseconds.
         /// Default Ctro
         Entry(string d = "no_name", size_t s = 0, result_t r = result_t::UNDEFINED, int l = 0, bool e = true)
-            : m_desc{d}, m_seq{s}, m_result{r}, m_line{l}, m_enabled{e} { /* empty */
+            : m_desc{d},
+              m_seq{s},
+              m_result{r},
+              m_line{l},
+              m_enabled{e},
+              m_wall_ms{0},
+              m_cpu_ms{0},
+              m_runs{0},
+              m_min_ns{0},
+              m_median_ns{0},
+              m_stddev_ns{0} { /* empty */
         }
     };
     /// Records the tests results. The key is the test name, and the data is an `Entry`.
@@ -49,6 +73,10 @@ class TestManager {
     std::string test_suite_name;
     /// Number of tests registred.
     size_t n_tests;
+    /// Whether summary() shows the time of each test.
+    bool show_times;
+    /// Whether summary() lists the slowest tests first.
+    bool slowest_first;
 
    private:
     /// Prints out the overall result of a single test.
@@ -74,13 +102,92 @@ class TestManager {
             std::cout << "[ "
                       << "\e[1;35mUNDEFINED\e[0m"
                       << " ] at line " << entry.m_line << ".\n";
-    }
 
+        if (entry.m_runs != 0)
+            std::cout << "[     "
+                      << "\e[1;33mBENCH\e[0m"
+                      << " ] " << entry.m_runs << " runs: min " << format_duration(entry.m_min_ns) << ", median "
+                      << format_duration(entry.m_median_ns) << ", stddev " << format_duration(entry.m_stddev_ns)
+                      << ".\n";
+        if (show_times)
+            std::cout << "[      "
+                      << "\e[1;33mTIME\e[0m"
+                      << " ] " << format_duration(entry.m_wall_ms * 1e6) << " wall, "
+                      << format_duration(entry.m_cpu_ms * 1e6) << " cpu.\n";
+    }
     //=== Public interface.
    public:
+    /// Formats a duration given in nanoseconds with a suitable unit.
+    static std::string format_duration(double ns);
+
+    /// Order of the tests in summary().
+    enum class order_t : int { SEQUENCE, SLOWEST };
+
+    /// Measures the wall-clock and CPU time, and the allocations, of a test from BEGIN_TEST to the end of its block.
+    class Timer {
+       private:
+        TestManager &m_tm;                                    //!< Suite of the test.
+        std::string m_key;                                    //!< Test name.
+        std::chrono::steady_clock::time_point m_wall_start;  //!< Wall-clock start.
+        std::clock_t m_cpu_start;                             //!< CPU-time start.
+        size_t m_alloc_start;                                 //!< Allocation count at the start.
+
+       public:
+        Timer(TestManager &tm, const std::string &key)
+            : m_tm(tm),
+              m_key{key},
+              m_wall_start{std::chrono::steady_clock::now()},
+              m_cpu_start{std::clock()},
+              m_alloc_start{allocation_count()} {}
+        ~Timer(void) {
+            double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_wall_start).count();
+            double cpu = 1000.0 * static_cast<double>(std::clock() - m_cpu_start) / CLOCKS_PER_SEC;
+            m_tm.record_time(m_key, wall, cpu, allocation_count() - m_alloc_start);
+        }
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+    };
+
+    /// Drives the repetitions of a BENCH_TEST: a few untimed warmup runs, then `iterations` timed ones.
+    class BenchRun {
+       private:
+        TestManager &m_tm;                              //!< Suite of the test.
+        std::string m_key;                              //!< Test name.
+        size_t m_warmup;                                //!< Warmup runs left.
+        size_t m_iterations;                            //!< Timed runs wanted.
+        std::vector<double> m_samples;                  //!< Duration of each timed run, in nanoseconds.
+        std::chrono::steady_clock::time_point m_start;  //!< Start of the current timed run.
+        bool m_timing;                                  //!< Whether a timed run is in progress.
+        size_t m_alloc_start;                           //!< Allocation count at the start of the current timed run.
+        size_t m_allocs;                                //!< Allocations of the timed runs so far.
+
+       public:
+        BenchRun(TestManager &tm, const std::string &key, size_t iterations)
+            : m_tm(tm),
+              m_key{key},
+              m_warmup{iterations / 10 + 1},
+              m_iterations{iterations == 0 ? 1 : iterations},
+              m_samples{},
+              m_start{},
+              m_timing{false},
+              m_alloc_start{0},
+              m_allocs{0} {
+            m_samples.reserve(m_iterations);
+        }
+        /// Closes the previous run and tells whether the body must run again.
+        bool next(void);
+    };
+
     /// Default constructor that may take the test suite name.
+    /*!
+     * The environment variable `TM_TIMING` turns the timing mode on for every suite: `1` shows
+     * the time of each test, `slowest` also lists the slowest tests first.
+     */
     explicit TestManager(const std::string suite_name = "Default")
-        : test_suite_name{suite_name}, n_tests{0} { /* empty */
+        : test_suite_name{suite_name}, n_tests{0}, show_times{false}, slowest_first{false} {
+        const char *mode = std::getenv("TM_TIMING");
+        if (mode != nullptr and *mode != '\0' and std::string(mode) != "0") show_times = true;
+        if (mode != nullptr and std::string(mode) == "slowest") slowest_first = true;
     }
 
     /// Registers a test with this suite
@@ -97,18 +204,55 @@ class TestManager {
         tests_record[key_name].m_enabled = value;
     }
 
+    /// Turns the display of the test times in summary() on or off.
+    void timing(bool value = true) { show_times = value; }
+
     /// Updates the test result.
     void result(const std::string &key, bool value, int line);
 
-    /// Shows the test suite results.
-    void summary(void) const;
+    /// Stores the time taken by a test, and the allocations it made.
+    void record_time(const std::string &key, double wall_ms, double cpu_ms, size_t allocations = 0);
+
+    /// Stores the statistics of the timed runs of a BENCH_TEST, given in nanoseconds.
+    void record_bench(const std::string &key, std::vector<double> samples, double allocations = 0);
+
+    /// Shows the test suite results, in the order of registration or the slowest tests first.
+    void summary(order_t order) const;
+    /// Shows the test suite results, in the order given by `TM_TIMING` (registration by default).
+    void summary(void) const { summary(slowest_first ? order_t::SLOWEST : order_t::SEQUENCE); }
 };
 
+/// Keeps the compiler from optimizing `value` (and the computation of it) away.
+template <typename T>
+inline void DoNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+/// Forces pending writes to memory to be treated as observable.
+inline void ClobberMemory(void) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
 //=== MACRO definitions.
 #define BEGIN_TEST(tm, key, msg) \
     std::string _test_id{key};   \
     TestManager &_tm = tm;       \
-    _tm.record(key, msg)
+    _tm.record(key, msg);        \
+    TestManager::Timer _test_timer { _tm, _test_id }
+/// Registers a micro-benchmark whose body (the statement or block that follows) runs
+/// `iterations` timed times after a short warmup; summary() shows min/median/stddev per run.
+#define BENCH_TEST(tm, key, msg, iterations) \
+    BEGIN_TEST(tm, key, msg);                \
+    for (TestManager::BenchRun _bench_run{_tm, _test_id, iterations}; _bench_run.next();)
 #endif
 //#define RESULT(tm, key, res) tm.result( key, res, __LINE__ )
 #define RESULT(key, res) _tm.result(key, res, __LINE__)
@@ -1,18 +1,158 @@
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "../include/vector.h"
+#include "include/tm/perf_check.h"
 #include "include/tm/test_manager.h"
 
 #define which_lib sc
 // To run tests with the STL's vector, uncomment the line below.
 // #define which_lib std
 
+/// Counts how many times its objects are copied and moved.
+struct Tracked {
+    static int copies;  //!< Copy constructions and assignments.
+    static int moves;   //!< Move constructions and assignments.
+    int value;          //!< Payload.
+
+    Tracked(int v = 0) : value{v} {}
+    Tracked(const Tracked& other) : value{other.value} { ++copies; }
+    Tracked(Tracked&& other) noexcept : value{other.value} { ++moves; }
+    Tracked& operator=(const Tracked& other) {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+    Tracked& operator=(Tracked&& other) noexcept {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+    static void reset(void) { copies = moves = 0; }
+};
+int Tracked::copies{0};
+int Tracked::moves{0};
+
+/// Owns a heap int and counts moves and destructions; safe to relocate by memcpy.
+struct Handle {
+    static int moves;  //!< Move constructions.
+    static int dtors;  //!< Destructions.
+    int* value;        //!< Owned payload.
+
+    explicit Handle(int v = 0) : value{new int(v)} {}
+    Handle(const Handle& other) : value{new int(*other.value)} {}
+    Handle(Handle&& other) noexcept : value{other.value} {
+        other.value = nullptr;
+        ++moves;
+    }
+    Handle& operator=(Handle other) noexcept {
+        std::swap(value, other.value);
+        return *this;
+    }
+    ~Handle(void) {
+        ++dtors;
+        delete value;
+    }
+    static void reset(void) { moves = dtors = 0; }
+};
+int Handle::moves{0};
+int Handle::dtors{0};
+SC_TRIVIALLY_RELOCATABLE(Handle)
+
+/// Points into itself, so it must never be relocated by memcpy.
+struct SelfPointer {
+    int value;
+    int* self;
+
+    SelfPointer(int v = 0) : value{v}, self{&value} {}
+    SelfPointer(const SelfPointer& other) : value{other.value}, self{&value} {}
+};
+/// Counts its live objects; its copy constructor throws once `copies_left` runs out.
+struct Fragile {
+    static int live;         //!< Objects alive.
+    static int copies_left;  //!< Copies allowed before one throws.
+    int value;               //!< Payload.
+
+    Fragile(int v = 0) : value{v} { ++live; }
+    Fragile(const Fragile& other) : value{other.value} {
+        if (copies_left-- == 0) throw std::runtime_error("Fragile copy");
+        ++live;
+    }
+    Fragile& operator=(const Fragile&) = default;
+    ~Fragile(void) { --live; }
+};
+int Fragile::live{0};
+int Fragile::copies_left{0};
+
+static_assert(sc::is_trivially_relocatable<int>::value, "trivially copyable types relocate");
+static_assert(sc::is_trivially_relocatable<Handle>::value, "opted in with SC_TRIVIALLY_RELOCATABLE");
+static_assert(sc::is_trivially_relocatable<std::unique_ptr<int>>::value, "unique_ptr relocates");
+static_assert(sc::is_trivially_relocatable<sc::vector<std::string>>::value, "sc::vector relocates");
+static_assert(not sc::is_trivially_relocatable<SelfPointer>::value, "not opted in");
+
+// Test suites implemented in other translation units.
+void run_persistent_vector_tests(void);
+void run_gap_vector_tests(void);
+void run_ring_vector_tests(void);
+void run_vector_hash_tests(void);
+void run_parse_tests(void);
+void run_packed_vector_tests(void);
+void run_static_vector_tests(void);
+void run_rcu_vector_tests(void);
+void run_vector_tracking_tests(void);
+void run_vector_storage_tests(void);
+void run_sort_tests(void);
+void run_perf_check_tests(void);
+void run_vector_diff_tests(void);
+void run_expr_tests(void);
+void run_span_tests(void);
+void run_pipeline_tests(void);
+void run_queue_tests(void);
+void run_shm_vector_tests(void);
+
+/// Exercises the modifiers inside a function that is `constexpr` in C++20 mode.
+SC_CONSTEXPR int squares_checksum(int n) {
+    sc::vector<int> vec;
+    for (int i{1}; i <= n; ++i) vec.push_back(i * i);
+    vec.insert(vec.begin(), {-1, -2});
+    vec.erase(vec.begin(), vec.begin() + 2);
+    sc::vector<int> copy{vec};
+
+    int sum{0};
+    for (auto e : copy) sum += e;
+    return sum;
+}
+
+#if __cplusplus >= 202002L && defined(__cpp_constexpr_dynamic_alloc)
+#include <array>
+/// Builds a lookup table at compile time; the result is a plain array baked into the binary.
+constexpr std::array<int, 8> make_powers_of_two(void) {
+    sc::vector<int> vec;
+    vec.push_back(1);
+    while (vec.size() < 8) vec.push_back(vec.back() * 2);
+
+    std::array<int, 8> table{};
+    std::copy(vec.begin(), vec.end(), table.begin());
+    return table;
+}
+constexpr auto powers_of_two = make_powers_of_two();
+static_assert(powers_of_two[7] == 128, "table must be computed at compile time");
+static_assert(squares_checksum(10) == 385, "vector must be usable in constant expressions");
+#endif
+
 // ============================================================================
 // TESTING VECTOR AS A CONTAINER OF INTEGERS
 // ============================================================================
 
-int main(void) {
+/// Runs every test suite once.
+static void run_all_tests(void) {
     TestManager tm{"Testing a vector of integer"};
 
     {
@@ -507,6 +647,66 @@ int main(void) {
         EXPECT_EQ(vec1, (which_lib::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
     }
 
+    {
+        BEGIN_TEST(tm, "InsertInputIterator", "vec.insert(pos, istream_iterator, istream_iterator)");
+        which_lib::vector<int> vec{1, 2, 3, 4, 5};
+
+        // Single-pass source, with and without reallocation.
+        std::istringstream in{"6 7 8"};
+        vec.insert(std::next(vec.begin(), 2), std::istream_iterator<int>(in), std::istream_iterator<int>());
+        EXPECT_EQ(vec, (which_lib::vector<int>{1, 2, 6, 7, 8, 3, 4, 5}));
+
+        vec.reserve(20);
+        std::istringstream in2{"9 10"};
+        vec.insert(vec.begin(), std::istream_iterator<int>(in2), std::istream_iterator<int>());
+        EXPECT_EQ(vec, (which_lib::vector<int>{9, 10, 1, 2, 6, 7, 8, 3, 4, 5}));
+        EXPECT_EQ(vec.capacity(), 20u);
+    }
+
+    {
+        BEGIN_TEST(tm, "InsertSelfRange", "vec.insert(pos, vec.begin() + i, vec.end())");
+        // With reallocation: the source is read from the old storage area.
+        which_lib::vector<int> vec{1, 2, 3, 4, 5};
+        vec.insert(vec.begin(), std::next(vec.begin(), 3), vec.end());
+        EXPECT_EQ(vec, (which_lib::vector<int>{4, 5, 1, 2, 3, 4, 5}));
+
+        // Without reallocation: the source overlaps the shifted tail.
+        vec = {1, 2, 3, 4, 5};
+        vec.reserve(20);
+        vec.insert(std::next(vec.begin(), 1), std::next(vec.begin(), 2), vec.end());
+        EXPECT_EQ(vec, (which_lib::vector<int>{1, 3, 4, 5, 2, 3, 4, 5}));
+
+        // A single element of the vector itself.
+        vec = {1, 2, 3};
+        vec.insert(vec.begin(), vec.back());
+        EXPECT_EQ(vec, (which_lib::vector<int>{3, 1, 2, 3}));
+        vec.insert(vec.begin(), vec.back());
+        EXPECT_EQ(vec, (which_lib::vector<int>{3, 3, 1, 2, 3}));
+        vec.push_back(vec.front());
+        EXPECT_EQ(vec, (which_lib::vector<int>{3, 3, 1, 2, 3, 3}));
+    }
+
+    {
+        BEGIN_TEST(tm, "InsertMovesOnce", "growing insert moves each element once");
+        which_lib::vector<Tracked> vec{1, 2, 3, 4, 5};
+        which_lib::vector<Tracked> source{6, 7};
+
+        // Full vector: the insertion reallocates.
+        Tracked::reset();
+        vec.insert(std::next(vec.begin(), 2), Tracked{10});
+        EXPECT_EQ(Tracked::moves, 5);
+        EXPECT_EQ(Tracked::copies, 1);
+
+        vec.shrink_to_fit();
+        Tracked::reset();
+        vec.insert(std::next(vec.begin(), 1), source.begin(), source.end());
+        EXPECT_EQ(Tracked::moves, 6);
+        EXPECT_EQ(Tracked::copies, 2);
+
+        int expected[]{1, 6, 7, 2, 10, 3, 4, 5};
+        for (auto i{0u}; i < vec.size(); ++i) EXPECT_EQ(vec[i].value, expected[i]);
+    }
+
     {
         BEGIN_TEST(tm, "AssignCountValue2", "vec.assign( count, value)");
         // Initial vector.
@@ -568,6 +768,12 @@ int main(void) {
         past_last = vec.erase(vec.begin(), vec.end());
         EXPECT_EQ(vec.end(), past_last);
         EXPECT_TRUE(vec.empty());
+
+        // An empty range is a no-op, also for elements that a self-move would empty.
+        which_lib::vector<std::string> words{"alpha", "beta", "gamma"};
+        auto same = words.erase(std::next(words.begin(), 1), std::next(words.begin(), 1));
+        EXPECT_EQ(words, (which_lib::vector<std::string>{"alpha", "beta", "gamma"}));
+        EXPECT_EQ(std::next(words.begin(), 1), same);
     }
 
     {
@@ -597,6 +803,215 @@ int main(void) {
         EXPECT_EQ(vec.size(), 4);
     }
 
+    {
+        BEGIN_TEST(tm, "NarrowSizeType", "sc::vector<int, std::uint32_t>");
+
+        sc::vector<int, std::uint32_t> vec{1, 2, 3};
+        for (auto i{4}; i <= 100; ++i) vec.push_back(i);
+        vec.insert(vec.begin(), {-1, 0});
+        vec.erase(vec.begin());
+
+        EXPECT_EQ(sizeof(vec), sizeof(int*) + 2 * sizeof(std::uint32_t));
+        EXPECT_EQ(vec.size(), 101);
+        EXPECT_EQ(vec.front(), 0);
+        EXPECT_EQ(vec.back(), 100);
+
+        auto copy = vec;
+        EXPECT_EQ(copy, vec);
+    }
+
+    {
+        BEGIN_TEST(tm, "CompactLayout", "sc::vector<std::string, sc::compact<std::uint32_t>>");
+
+        using compact_vector = sc::vector<std::string, sc::compact<std::uint32_t>>;
+        compact_vector vec;
+        EXPECT_EQ(sizeof(vec), sizeof(void*));
+        EXPECT_TRUE(vec.empty());
+        EXPECT_EQ(vec.capacity(), 0);
+
+        for (auto i{0}; i < 50; ++i) vec.push_back(std::to_string(i));
+        vec.insert(vec.begin() + 10, {"a", "b"});
+        vec.erase(vec.begin(), vec.begin() + 5);
+        EXPECT_EQ(vec.size(), 47);
+        EXPECT_EQ(vec[5], "a");
+        EXPECT_EQ(vec.back(), "49");
+
+        compact_vector other{"x"};
+        swap(vec, other);
+        EXPECT_EQ(vec.size(), 1);
+        EXPECT_EQ(other.size(), 47);
+
+        vec = other;
+        EXPECT_EQ(vec, other);
+        vec.clear();
+        vec.shrink_to_fit();
+        EXPECT_EQ(vec.capacity(), 0);
+    }
+
+    {
+        BEGIN_TEST(tm, "ShrinkPolicy", "sc::shrink_below<4> gives memory back with hysteresis");
+
+        sc::vector<int, unsigned long, sc::shrink_below<4, 16>> vec;
+        for (auto i{0}; i < 1000; ++i) vec.push_back(i);
+        auto cap = vec.capacity();
+
+        // Down to a quarter of the capacity nothing changes; one more removal halves the slack.
+        while (vec.size() > cap / 4) vec.pop_back();
+        EXPECT_EQ(vec.capacity(), cap);
+        vec.pop_back();
+        EXPECT_EQ(vec.capacity(), 2 * vec.size());
+        EXPECT_EQ(vec.back(), static_cast<int>(vec.size()) - 1);
+
+        // Oscillating around the new size does not reallocate.
+        auto* storage = vec.data();
+        for (auto i{0}; i < 100; ++i) {
+            vec.push_back(i);
+            vec.pop_back();
+        }
+        EXPECT_EQ(vec.data(), storage);
+
+        vec.erase(vec.begin(), vec.end() - 10);
+        EXPECT_EQ(vec.capacity(), 20);
+        vec.clear();
+        EXPECT_EQ(vec.capacity(), 16);
+
+        // Copy-assigning a vector whose size matches our capacity must not shrink before the copy.
+        sc::vector<int, unsigned long, sc::shrink_below<4, 16>> big, same;
+        for (auto i{0}; i < 64; ++i) big.push_back(i);
+        big.shrink_to_fit();
+        same = big;
+        same.erase(same.begin() + 1, same.end());
+        same.reserve(64);
+        same = big;
+        EXPECT_EQ(same.size(), 64);
+        EXPECT_EQ(same[63], 63);
+
+        // The default policy keeps the capacity; shrink_to() leaves room to grow.
+        sc::vector<int> plain(100);
+        plain.reserve(1000);
+        plain.clear();
+        EXPECT_EQ(plain.capacity(), 1000);
+        for (auto i{0}; i < 100; ++i) plain.push_back(i);
+        plain.shrink_to(200);
+        EXPECT_EQ(plain.capacity(), 200);
+        plain.shrink_to(10);
+        EXPECT_EQ(plain.capacity(), 100);
+        EXPECT_EQ(plain[99], 99);
+    }
+
+    {
+        BEGIN_TEST(tm, "TrivialRelocation", "relocatable elements are moved by memcpy, not constructors");
+
+        sc::vector<Handle> vec;
+        for (auto i{0}; i < 8; ++i) vec.push_back(Handle(i));
+        Handle::reset();
+
+        vec.reserve(100);
+        EXPECT_EQ(Handle::moves, 0);
+        EXPECT_EQ(Handle::dtors, 0);
+
+        // Only the new value is moved (from the copy taken aside); the tail is shifted by memmove.
+        vec.insert(vec.begin() + 2, Handle(42));
+        EXPECT_EQ(Handle::moves, 1);
+        EXPECT_EQ(Handle::dtors, 2);
+        Handle::reset();
+        vec.erase(vec.begin(), vec.begin() + 2);
+        EXPECT_EQ(Handle::moves, 0);
+        EXPECT_EQ(Handle::dtors, 2);
+        vec.shrink_to_fit();
+        EXPECT_EQ(Handle::dtors, 2);
+
+        std::vector<int> expected{42, 2, 3, 4, 5, 6, 7};
+        EXPECT_EQ(vec.size(), expected.size());
+        for (auto i{0u}; i < expected.size(); ++i) EXPECT_EQ(*vec[i].value, expected[i]);
+
+        // Vectors of vectors grow without touching the inner vectors.
+        sc::vector<sc::vector<std::string>> nested;
+        for (auto i{0}; i < 100; ++i) nested.push_back({std::string(30, 'a' + i % 26), std::string(30, 'a' + i % 26)});
+        nested.erase(nested.begin(), nested.begin() + 50);
+        EXPECT_EQ(nested.size(), 50);
+        EXPECT_EQ(nested[0][1], std::string(30, 'a' + 50 % 26));
+        EXPECT_EQ(nested.back()[0], std::string(30, 'a' + 99 % 26));
+    }
+
+    {
+        BEGIN_TEST(tm, "ThrowingGrowth", "a copy that throws while growing leaks nothing and keeps the vector");
+
+        Fragile::copies_left = 1 << 30;
+        {
+            sc::vector<Fragile> vec;
+            vec.reserve(4);
+            for (auto i{0}; i < 4; ++i) vec.push_back(Fragile(i));  // Each push_back copies once.
+            Fragile extra(9);
+            auto throws = [](int allowed, std::function<void(void)> grow) {
+                Fragile::copies_left = allowed;
+                bool threw{false};
+                try {
+                    grow();
+                } catch (const std::runtime_error&) {
+                    threw = true;
+                }
+                Fragile::copies_left = 1 << 30;
+                return threw;
+            };
+            const int live = Fragile::live;
+
+            // The new element itself, then each element moved (copied: no noexcept move) across.
+            EXPECT_TRUE(throws(0, [&] { vec.push_back(extra); }));
+            EXPECT_TRUE(throws(2, [&] { vec.push_back(extra); }));
+            EXPECT_TRUE(throws(3, [&] { vec.insert(vec.begin() + 1, extra); }));
+            Fragile more[6]{Fragile(5), Fragile(6), Fragile(7), Fragile(8), Fragile(9), Fragile(10)};
+            EXPECT_TRUE(throws(1, [&] { vec.insert(vec.begin() + 2, more, more + 3); }));
+            EXPECT_TRUE(throws(4, [&] { vec.insert(vec.begin() + 2, more, more + 3); }));
+            EXPECT_TRUE(throws(3, [&] { vec.assign(more, more + 6); }));
+            EXPECT_EQ(Fragile::live, live + 6);
+
+            EXPECT_EQ(vec.size(), 4);
+            EXPECT_EQ(vec.capacity(), 4);
+            for (auto i{0}; i < 4; ++i) EXPECT_EQ(vec[i].value, i);
+        }
+        EXPECT_EQ(Fragile::live, 0);
+    }
+
+    {
+        BEGIN_TEST(tm, "ParallelFillCopy", "sc::parallel construction, copy and assign of a large vector");
+
+        const unsigned long n = 2000000;  // Large enough for four slices.
+        sc::vector<int> filled(n, sc::parallel_t{4}, 7);
+        EXPECT_EQ(filled.size(), n);
+        EXPECT_EQ(filled[0], 7);
+        EXPECT_EQ(filled[n / 2 + 1], 7);
+        EXPECT_EQ(filled[n - 1], 7);
+
+        sc::vector<int> zeros(n, sc::parallel);
+        EXPECT_EQ(zeros[n - 1], 0);
+
+        for (unsigned long i{0}; i < n; i += 1000) filled[i] = static_cast<int>(i);
+        sc::vector<int> copy(filled, sc::parallel_t{4});
+        EXPECT_EQ(copy, filled);
+
+        sc::vector<int> target{1, 2, 3};
+        target.assign(filled, sc::parallel_t{3});
+        EXPECT_EQ(target, filled);
+        target.assign(n + 10, target[1000], sc::parallel_t{4});
+        EXPECT_EQ(target.size(), n + 10);
+        EXPECT_EQ(target[n + 9], 1000);
+
+        // Small vectors take the sequential path.
+        target.assign(3, 5, sc::parallel);
+        EXPECT_EQ(target, (sc::vector<int>{5, 5, 5}));
+    }
+
+    {
+        // A performance smoke test: run with TM_TIMING=1 to see the times of every test.
+        BENCH_TEST(tm, "PushBackBench", "push_back of 100000 ints into an empty vector", 20) {
+            sc::vector<int> vec;
+            for (auto i{0}; i < 100000; ++i) vec.push_back(i);
+            DoNotOptimize(vec.back());
+            EXPECT_EQ(vec.size(), 100000);
+        }
+    }
+
     tm.summary();
     std::cout << "\n\n";
 
@@ -781,6 +1196,7 @@ int main(void) {
         while (it1 != vec.end()) {
             // same address
             EXPECT_EQ(it1 - it2, i);
+            EXPECT_EQ(it2 - it1, -i);  // Signed, not the absolute distance.
             i++;
             it1++;
         }
@@ -849,6 +1265,47 @@ int main(void) {
     }
 
     tm2.summary();
+    std::cout << "\n\n";
 
-    return 0;
+    TestManager tm3{"Compile-time vector"};
+
+    {
+        BEGIN_TEST(tm3, "ConstexprModifiers", "push_back/insert/erase/copy inside a constexpr function");
+
+        EXPECT_EQ(squares_checksum(10), 385);
+        EXPECT_EQ(squares_checksum(0), 0);
+    }
+
+#if __cplusplus >= 202002L && defined(__cpp_constexpr_dynamic_alloc)
+    {
+        BEGIN_TEST(tm3, "ConstexprTable", "table filled by a vector at compile time");
+
+        for (auto i{0u}; i < powers_of_two.size(); ++i) EXPECT_EQ(powers_of_two[i], 1 << i);
+    }
+#endif
+
+    tm3.summary();
+    std::cout << "\n\n";
+
+    run_persistent_vector_tests();
+    run_gap_vector_tests();
+    run_ring_vector_tests();
+    run_vector_hash_tests();
+    run_parse_tests();
+    run_packed_vector_tests();
+    run_static_vector_tests();
+    run_rcu_vector_tests();
+    run_vector_tracking_tests();
+    run_vector_storage_tests();
+    run_sort_tests();
+    run_perf_check_tests();
+    run_vector_diff_tests();
+    run_expr_tests();
+    run_span_tests();
+    run_pipeline_tests();
+    run_queue_tests();
+    run_shm_vector_tests();
 }
+
+/// Runs the tests once, or in perf mode (see perf_main()) to record or check a timing baseline.
+int main(int argc, char *argv[]) { return perf_main(argc, argv, run_all_tests); }
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+
+#include "../include/expr.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING EXPRESSION TEMPLATES
+// ============================================================================
+
+void run_expr_tests(void) {
+    TestManager tm{"Testing expression templates"};
+
+    {
+        BEGIN_TEST(tm, "Arithmetic", "element-wise + - * / and negation, in one pass");
+
+        sc::vector<double> a{1, 2, 3, 4};
+        sc::vector<double> b{4, 3, 2, 1};
+        sc::vector<double> c{0.5, 0.5, 0.5, 0.5};
+
+        sc::vector<double> r = a * b + c;
+        EXPECT_EQ(r, (sc::vector<double>{4.5, 6.5, 6.5, 4.5}));
+
+        r = (a - b) / c;
+        EXPECT_EQ(r, (sc::vector<double>{-6, -2, 2, 6}));
+
+        r = -a + a * a;
+        EXPECT_EQ(r, (sc::vector<double>{0, 2, 6, 12}));
+
+        // The operands stay as they were.
+        EXPECT_EQ(a, (sc::vector<double>{1, 2, 3, 4}));
+        EXPECT_EQ(b, (sc::vector<double>{4, 3, 2, 1}));
+    }
+
+    {
+        BEGIN_TEST(tm, "Scalars", "scalars are broadcast and take the element type of the vector");
+
+        sc::vector<float> a{1, 2, 3};
+        sc::vector<float> r = a * 2 + 1;
+        EXPECT_EQ(r, (sc::vector<float>{3, 5, 7}));
+        r = 10 - a;
+        EXPECT_EQ(r, (sc::vector<float>{9, 8, 7}));
+        r = 6 / a * a;
+        EXPECT_EQ(r, (sc::vector<float>{6, 6, 6}));
+
+        sc::vector<int> i{7, 8, 9};
+        sc::vector<int> q = i / 2;  // Integer division, not a double scalar.
+        EXPECT_EQ(q, (sc::vector<int>{3, 4, 4}));
+    }
+
+    {
+        BEGIN_TEST(tm, "Functions", "sqrt, abs, min and max element by element");
+
+        sc::vector<double> a{4, -9, 16};
+        sc::vector<double> b{1, 2, 3};
+
+        sc::vector<double> r = sc::sqrt(sc::abs(a));
+        EXPECT_EQ(r, (sc::vector<double>{2, 3, 4}));
+        r = sc::min(a, b);
+        EXPECT_EQ(r, (sc::vector<double>{1, -9, 3}));
+        r = sc::max(a, 0.0) + sc::min(b, 2);
+        EXPECT_EQ(r, (sc::vector<double>{5, 2, 18}));
+
+        sc::vector<int> i{-3, 0, 5};
+        sc::vector<int> k = sc::abs(i);
+        EXPECT_EQ(k, (sc::vector<int>{3, 0, 5}));
+    }
+
+    {
+        BEGIN_TEST(tm, "Masks", "comparisons give masks for where, any and all");
+
+        sc::vector<double> a{-1, 2, -3, 4};
+        sc::vector<double> b{0, 2, 0, 5};
+
+        sc::vector<bool> mask = a < b;
+        EXPECT_EQ(mask, (sc::vector<bool>{true, false, true, true}));
+        mask = sc::equal(a, b);
+        EXPECT_EQ(mask, (sc::vector<bool>{false, true, false, false}));
+        mask = a >= 0;
+        EXPECT_EQ(mask, (sc::vector<bool>{false, true, false, true}));
+
+        sc::vector<double> r = sc::where(a < 0, -a, a * 10);
+        EXPECT_EQ(r, (sc::vector<double>{1, 20, 3, 40}));
+        r = sc::where(a >= b, 1, 0);
+        EXPECT_EQ(r, (sc::vector<double>{0, 1, 0, 0}));
+
+        EXPECT_TRUE(sc::any(a > 3));
+        EXPECT_FALSE(sc::any(a > 4));
+        EXPECT_TRUE(sc::all(a <= b));
+        EXPECT_FALSE(sc::all(sc::not_equal(a, b)));
+        EXPECT_EQ(sc::sum(a * b), 24);
+        EXPECT_EQ(sc::sum(a), 2);
+
+        // Whole-vector comparison is unchanged.
+        EXPECT_FALSE((a == b));
+    }
+
+    {
+        BEGIN_TEST(tm, "Assignment", "storage is reused and operands may alias the target");
+
+        sc::vector<double> a{1, 2, 3, 4};
+        sc::vector<double> b{1, 1, 1, 1};
+        sc::vector<double> r(8);
+        const double* storage = r.cbegin().base();
+        r = a + b;
+        EXPECT_EQ(r.size(), 4);
+        EXPECT_EQ(r.capacity(), 8);
+        EXPECT_TRUE((r.cbegin().base() == storage));
+
+        // Element i only reads index i, so the target can be an operand.
+        a = a * a + a;
+        EXPECT_EQ(a, (sc::vector<double>{2, 6, 12, 20}));
+
+        sc::vector<double> empty;
+        r = empty * 2;
+        EXPECT_TRUE(r.empty());
+
+        sc::vector<double> big(1000, sc::parallel_t{1}, 3.0);
+        r = big - 1;
+        EXPECT_EQ(r.size(), 1000);
+        EXPECT_EQ(r[999], 2);
+    }
+
+    {
+        BEGIN_TEST(tm, "Sizes", "operands of different sizes throw std::length_error");
+
+        sc::vector<int> a{1, 2, 3};
+        sc::vector<int> b{1, 2};
+        bool threw{false};
+        try {
+            sc::vector<int> r = a + b;
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        threw = false;
+        try {
+            sc::vector<int> r = sc::where(a > 1, a, b);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "Parallel", "assign with a parallel policy matches the serial result");
+
+        const std::size_t n{100000};
+        sc::vector<double> a(n), b(n);
+        for (std::size_t i{0}; i < n; ++i) {
+            a[i] = static_cast<double>(i);
+            b[i] = static_cast<double>(n - i);
+        }
+        sc::vector<double> serial = sc::sqrt(a * b) + 1;
+        sc::vector<double> threaded;
+        threaded.assign(sc::sqrt(a * b) + 1, sc::parallel_t{4});
+        EXPECT_EQ(threaded, serial);
+        threaded.assign(a - b, sc::parallel);
+        EXPECT_EQ(threaded[0], -static_cast<double>(n));
+        EXPECT_EQ(threaded[n - 1], static_cast<double>(n - 2));
+    }
+
+    {
+        const std::size_t n{1 << 16};
+        sc::vector<float> a(n, sc::parallel_t{1}, 1.5f), b(n, sc::parallel_t{1}, 2.0f), c(n, sc::parallel_t{1}, 0.25f), r(n);
+        BENCH_TEST(tm, "FusedMultiplyAdd", "r = a * b + c on 65536 floats, no temporaries", 200) {
+            r = a * b + c;
+            DoNotOptimize(r[n - 1]);
+        }
+        EXPECT_EQ(r[n - 1], 3.25f);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,157 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/gap_vector.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING GAP VECTOR
+// ============================================================================
+
+void run_gap_vector_tests(void) {
+    TestManager tm{"Testing a gap vector"};
+
+    {
+        BEGIN_TEST(tm, "Constructors", "gap_vector<int> gv{ 1, 2, 3 }, gv(n), gv(first, last), copy");
+
+        sc::gap_vector<int> gv{1, 2, 3, 4, 5};
+        EXPECT_TRUE(same_contents(gv, std::vector<int>{1, 2, 3, 4, 5}));
+        EXPECT_TRUE(same_contents(sc::gap_vector<int>(3), std::vector<int>(3)));
+        EXPECT_TRUE(sc::gap_vector<int>{}.empty());
+
+        std::vector<int> src{9, 8, 7};
+        sc::gap_vector<int> ranged(src.begin(), src.end());
+        EXPECT_TRUE(same_contents(ranged, src));
+
+        gv.move_cursor(2);
+        sc::gap_vector<int> copy{gv};
+        EXPECT_EQ(copy, gv);
+        ranged = gv;
+        EXPECT_EQ(ranged, gv);
+    }
+
+    {
+        BEGIN_TEST(tm, "InsertAtCursor", "clustered inserts in the middle");
+
+        sc::gap_vector<std::string> gv{"first", "last"};
+        std::vector<std::string> ref{"first", "last"};
+
+        auto pos = gv.insert(gv.cbegin() + 1, "line 0");
+        ref.insert(ref.begin() + 1, "line 0");
+        EXPECT_EQ(*pos, "line 0");
+        for (auto i{1}; i < 100; ++i) {
+            // Typing line after line: the cursor only moves forward by one each time.
+            gv.insert(gv.cbegin() + 1 + i, "line " + std::to_string(i));
+            ref.insert(ref.begin() + 1 + i, "line " + std::to_string(i));
+        }
+        EXPECT_EQ(gv.cursor(), 101);
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        // Inserting one of our own elements.
+        gv.insert(gv.cbegin(), gv.back());
+        ref.insert(ref.begin(), ref.back());
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        gv.insert(gv.cbegin() + 3, {"a", "b", "c"});
+        ref.insert(ref.begin() + 3, {"a", "b", "c"});
+        EXPECT_TRUE(same_contents(gv, ref));
+    }
+
+    {
+        BEGIN_TEST(tm, "Erase", "gv.erase(pos), gv.erase(first, last), backspace");
+
+        sc::gap_vector<int> gv;
+        std::vector<int> ref;
+        for (auto i{0}; i < 50; ++i) {
+            gv.push_back(i);
+            ref.push_back(i);
+        }
+
+        auto next = gv.erase(gv.cbegin() + 10);
+        ref.erase(ref.begin() + 10);
+        EXPECT_EQ(*next, 11);
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        gv.erase(gv.cbegin() + 20, gv.cbegin() + 30);
+        ref.erase(ref.begin() + 20, ref.begin() + 30);
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        // Backspace: erase the element right before the cursor, repeatedly.
+        gv.move_cursor(15);
+        for (auto i{0}; i < 5; ++i) gv.erase(gv.cbegin() + (gv.cursor() - 1));
+        ref.erase(ref.begin() + 10, ref.begin() + 15);
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        gv.erase_at_cursor();
+        ref.erase(ref.begin() + 10);
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        gv.pop_back();
+        ref.pop_back();
+        EXPECT_TRUE(same_contents(gv, ref));
+
+        gv.clear();
+        EXPECT_TRUE(gv.empty());
+        bool worked{false};
+        try {
+            gv.pop_back();
+        } catch (std::length_error& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+    }
+
+    {
+        BEGIN_TEST(tm, "MoveCursor", "gv.move_cursor(pos) keeps the contents");
+
+        sc::gap_vector<int> gv;
+        std::vector<int> ref;
+        for (auto i{0}; i < 20; ++i) {
+            gv.push_back(i);
+            ref.push_back(i);
+        }
+        for (auto pos : {0u, 20u, 7u, 13u, 13u, 1u}) {
+            gv.move_cursor(pos);
+            EXPECT_EQ(gv.cursor(), pos);
+            EXPECT_TRUE(same_contents(gv, ref));
+        }
+
+        bool worked{false};
+        try {
+            gv.move_cursor(21);
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+
+        gv.shrink_to_fit();
+        EXPECT_EQ(gv.capacity(), 20);
+        EXPECT_TRUE(same_contents(gv, ref));
+    }
+
+    {
+        BEGIN_TEST(tm, "ElementAccess", "gv.at(i), gv.front(), gv.back(), gv.to_vector()");
+
+        sc::gap_vector<int> gv{1, 2, 3, 4};
+        gv.move_cursor(2);
+        gv.at(2) = 30;
+        EXPECT_EQ(gv[2], 30);
+        EXPECT_EQ(gv.front(), 1);
+        EXPECT_EQ(gv.back(), 4);
+
+        bool worked{false};
+        try {
+            gv.at(4);
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+
+        EXPECT_EQ(gv.to_vector(), (sc::vector<int>{1, 2, 30, 4}));
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
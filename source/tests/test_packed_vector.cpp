@@ -0,0 +1,87 @@
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "../include/packed_vector.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING PACKED VECTOR
+// ============================================================================
+
+void run_packed_vector_tests(void) {
+    TestManager tm{"Testing a packed vector"};
+
+    {
+        BEGIN_TEST(tm, "SortedIds", "packed_vector<uint64_t> pv{ sorted ids }");
+
+        std::mt19937 gen{42};
+        sc::vector<std::uint64_t> ids;
+        std::uint64_t id{1000000000};
+        for (auto i{0}; i < 10000; ++i) ids.push_back(id += gen() % 1000);
+
+        sc::packed_vector<std::uint64_t> pv{ids};
+        EXPECT_TRUE(same_contents(pv, ids));
+        EXPECT_EQ(pv.to_vector(), ids);
+        EXPECT_EQ(pv.sealed_blocks(), 10000 / 128);
+        // Each block spans less than 2^17, so it takes about a quarter of the raw size.
+        EXPECT_LT(pv.memory_bytes(), ids.size() * sizeof(std::uint64_t) / 3);
+    }
+
+    {
+        BEGIN_TEST(tm, "PushBack", "pv.push_back(value) across blocks");
+
+        sc::packed_vector<int> pv;
+        sc::vector<int> ref;
+        for (auto i{0}; i < 1000; ++i) {
+            int v = (i % 3 == 0) ? -i : i * 7;
+            pv.push_back(v);
+            ref.push_back(v);
+            if (i == 127 or i == 128 or i == 500) {
+                EXPECT_TRUE(same_contents(pv, ref));
+                EXPECT_EQ(pv.to_vector(), ref);
+            }
+        }
+        EXPECT_TRUE(same_contents(pv, ref));
+        EXPECT_EQ(pv.to_vector(), ref);
+        EXPECT_EQ(pv.at(999), ref[999]);
+
+        bool worked{false};
+        try {
+            pv.at(1000);
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+
+        pv.clear();
+        EXPECT_TRUE(pv.empty());
+        pv.push_back(5);
+        EXPECT_EQ(pv[0], 5);
+    }
+
+    {
+        BEGIN_TEST(tm, "Widths", "constant, full-range and narrow blocks");
+
+        using limits = std::numeric_limits<std::int64_t>;
+        sc::vector<std::int64_t> ref;
+        for (auto i{0}; i < 128; ++i) ref.push_back(7);                                        // Width 0.
+        for (auto i{0}; i < 128; ++i) ref.push_back(i % 2 ? limits::max() : limits::min());  // Width 64.
+        for (auto i{0}; i < 128; ++i) ref.push_back(-64 + i);                                // Width 7.
+        for (auto i{0}; i < 50; ++i) ref.push_back(i);                                       // Open block.
+
+        sc::packed_vector<std::int64_t> pv{ref};
+        EXPECT_TRUE(same_contents(pv, ref));
+        EXPECT_EQ(pv.to_vector(), ref);
+
+        sc::packed_vector<std::uint8_t> bytes{0, 255, 1, 254};
+        EXPECT_EQ(bytes[1], 255);
+        EXPECT_EQ(bytes, (sc::packed_vector<std::uint8_t>{0, 255, 1, 254}));
+        EXPECT_NE(bytes, (sc::packed_vector<std::uint8_t>{0, 255, 1}));
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
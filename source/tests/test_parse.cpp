@@ -0,0 +1,140 @@
+#include <clocale>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "../include/parse.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING TEXT PARSING
+// ============================================================================
+
+void run_parse_tests(void) {
+    TestManager tm{"Testing parse_into"};
+
+    {
+        BEGIN_TEST(tm, "Integers", "sc::parse_into(vec, first, last, ',')");
+
+        std::string text = "1,-2, 3\n+4,,9223372036854775807\t-9223372036854775808\r\n";
+        sc::vector<std::int64_t> vec{0};
+        auto count = sc::parse_into(vec, text.data(), text.data() + text.size(), ',');
+
+        EXPECT_EQ(count, 6);
+        EXPECT_EQ(vec, (sc::vector<std::int64_t>{0, 1, -2, 3, 4, INT64_MAX, INT64_MIN}));
+        EXPECT_EQ(vec.capacity(), vec.size());  // Reserved once, exactly.
+    }
+
+    {
+        BEGIN_TEST(tm, "Doubles", "sc::parse_into(vec, first, last)");
+
+        std::string text = "  0.5 -1e3 2.25e-2  7 ";
+        sc::vector<double> vec;
+        sc::parse_into(vec, text.data(), text.data() + text.size());
+
+        EXPECT_EQ(vec, (sc::vector<double>{0.5, -1000.0, 0.0225, 7.0}));
+
+        sc::vector<double> none;
+        EXPECT_EQ(sc::parse_into(none, text.data(), text.data()), 0);
+        EXPECT_TRUE(none.empty());
+    }
+
+    {
+        BEGIN_TEST(tm, "Locale", "a comma-decimal global locale does not change the parsing");
+
+        // Whichever of these exists; with none installed the test still runs in the "C" locale.
+        const std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+        const char* names[] = {"de_DE.UTF-8", "de_DE.utf8", "de_DE", "pt_BR.UTF-8", "fr_FR.UTF-8", "German"};
+        for (const char* name : names)
+            if (std::setlocale(LC_NUMERIC, name) != nullptr) break;
+
+        std::string text = "1.5 -2.25e1 0.125";
+        sc::vector<double> doubles;
+        sc::vector<float> floats;
+        sc::vector<long double> longs;
+        bool threw{false};
+        try {
+            sc::parse_into(doubles, text.data(), text.data() + text.size());
+            sc::parse_into(floats, text.data(), text.data() + text.size());
+            sc::parse_into(longs, text.data(), text.data() + text.size());
+        } catch (const std::exception&) {
+            threw = true;
+        }
+        std::setlocale(LC_NUMERIC, previous.c_str());
+
+        EXPECT_FALSE(threw);
+        EXPECT_EQ(doubles, (sc::vector<double>{1.5, -22.5, 0.125}));
+        EXPECT_EQ(floats, (sc::vector<float>{1.5f, -22.5f, 0.125f}));
+        EXPECT_EQ(longs.size(), 3);
+        EXPECT_TRUE((longs[1] == -22.5L));
+    }
+
+    {
+        BEGIN_TEST(tm, "Errors", "bad tokens throw with their position");
+
+        std::string text = "10 20 3x 40";
+        sc::vector<int> vec;
+        bool worked{false};
+        try {
+            sc::parse_into(vec, text.data(), text.data() + text.size());
+        } catch (std::invalid_argument& e) {
+            worked = std::string(e.what()).find("posição 6") != std::string::npos;
+        }
+        EXPECT_TRUE(worked);
+        EXPECT_EQ(vec, (sc::vector<int>{10, 20}));
+
+        std::string big = "1 300";
+        sc::vector<std::uint8_t> bytes;
+        worked = false;
+        try {
+            sc::parse_into(bytes, big.data(), big.data() + big.size());
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+
+        std::string negative = "-1";
+        sc::vector<unsigned> naturals;
+        worked = false;
+        try {
+            sc::parse_into(naturals, negative.data(), negative.data() + negative.size());
+        } catch (std::invalid_argument& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+    }
+
+    {
+        BEGIN_TEST(tm, "Threaded", "sc::parse_into(vec, first, last, ',', 4)");
+
+        // Large enough to be cut into several chunks, with separators of both kinds.
+        std::string text;
+        for (auto i{0}; i < 100000; ++i) text += std::to_string(i * 37 - 1000000) + (i % 10 == 9 ? "\n" : ",");
+
+        sc::vector<long> sequential;
+        sc::parse_into(sequential, text.data(), text.data() + text.size(), ',');
+        sc::vector<long> threaded{-1};
+        auto count = sc::parse_into(threaded, text.data(), text.data() + text.size(), ',', 4);
+
+        EXPECT_EQ(count, 100000);
+        EXPECT_EQ(sequential.size(), 100000);
+        EXPECT_EQ(threaded.front(), -1);
+        threaded.erase(threaded.begin());
+        EXPECT_EQ(threaded, sequential);
+
+        // An error in any chunk is reported with its position in the whole text.
+        text[text.size() - 3] = '?';
+        bool worked{false};
+        try {
+            sc::parse_into(threaded, text.data(), text.data() + text.size(), ',', 4);
+        } catch (std::invalid_argument& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+        EXPECT_EQ(threaded.size(), 100000);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
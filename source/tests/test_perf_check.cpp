@@ -0,0 +1,109 @@
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "include/tm/perf_check.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING THE PERF BASELINE OF THE DRIVER
+// ============================================================================
+
+/// A record with the given samples and allocations.
+static PerfRecord make_record(const std::vector<double>& samples, double allocations) {
+    PerfRecord r;
+    r.samples_ns = samples;
+    r.allocations = r.allocations_max = allocations;
+    return r;
+}
+
+void run_perf_check_tests(void) {
+    TestManager tm{"Testing the perf baseline"};
+
+    {
+        BEGIN_TEST(tm, "MannWhitney", "p-values of the one-sided test");
+
+        std::vector<double> low{10, 11, 12, 13, 14, 15, 16, 17};
+        std::vector<double> high{20, 21, 22, 23, 24, 25, 26, 27};
+        EXPECT_TRUE((mann_whitney_p(low, high) < 0.001));  // Every sample of `high` is larger.
+        EXPECT_TRUE((mann_whitney_p(high, low) > 0.999));
+        EXPECT_TRUE((std::fabs(mann_whitney_p(low, low) - 0.5) < 0.1));
+        EXPECT_EQ(mann_whitney_p(std::vector<double>(4, 7.0), std::vector<double>(4, 7.0)), 1.0);
+        EXPECT_EQ(mann_whitney_p(low, std::vector<double>{}), 1.0);
+        EXPECT_EQ(median(std::vector<double>{3, 1, 2, 10}), 2.5);
+    }
+
+    {
+        BEGIN_TEST(tm, "Compare", "slower, faster, unchanged, added and removed tests");
+
+        perf_records_t base, current;
+        base["s/slower"] = make_record({1e6, 1.01e6, 0.99e6, 1e6, 1.02e6}, 5);
+        current["s/slower"] = make_record({1.5e6, 1.52e6, 1.49e6, 1.5e6, 1.51e6}, 5);
+        base["s/faster"] = make_record({2e6, 2.1e6, 2.05e6, 2e6, 2.02e6}, 5);
+        current["s/faster"] = make_record({1e6, 1.1e6, 1.05e6, 1e6, 1.02e6}, 5);
+        base["s/tiny"] = make_record({100, 101, 102, 100, 99}, 0);
+        current["s/tiny"] = make_record({900, 901, 902, 900, 899}, 0);  // Below min_ns.
+        base["s/allocs"] = make_record({1e6, 1e6, 1e6}, 10);
+        current["s/allocs"] = make_record({1e6, 1e6, 1e6}, 20);
+        base["s/gone"] = make_record({1e6}, 0);
+        current["s/new"] = make_record({1e6}, 0);
+
+        PerfOptions options;
+        std::vector<PerfDiff> diffs = perf_compare(base, current, options);
+        EXPECT_EQ(diffs.size(), 6);
+        size_t checked{0};
+        for (const PerfDiff& d : diffs) {
+            PerfDiff::verdict_t expected = d.name == "s/slower"   ? PerfDiff::verdict_t::SLOWER
+                                           : d.name == "s/faster" ? PerfDiff::verdict_t::FASTER
+                                           : d.name == "s/tiny"   ? PerfDiff::verdict_t::SAME
+                                           : d.name == "s/allocs" ? PerfDiff::verdict_t::MORE_ALLOCS
+                                           : d.name == "s/gone"   ? PerfDiff::verdict_t::REMOVED
+                                                                  : PerfDiff::verdict_t::ADDED;
+            if (d.verdict == expected) ++checked;
+        }
+        EXPECT_EQ(checked, 6);
+
+        // A looser tolerance accepts the slowdown.
+        options.tolerance = 0.60;
+        options.min_ns = 0;
+        for (const PerfDiff& d : perf_compare(base, current, options))
+            if (d.name == "s/slower") EXPECT_EQ(d.verdict, PerfDiff::verdict_t::SAME);
+    }
+
+    {
+        BEGIN_TEST(tm, "Baseline", "JSON baselines round-trip and bad files are rejected");
+
+        const std::string path = "perf_check_test.json";
+        perf_records_t records, loaded;
+        records["Suite \"A\"/test\\1"] = make_record({1.5, 2.25, 1e9}, 3);
+        records["Suite B/test"] = make_record({}, 0);
+        records["Suite B/test"].allocations_max = 7;
+        EXPECT_TRUE(PerfLog::save(path, records));
+        EXPECT_TRUE(PerfLog::load(path, loaded));
+        EXPECT_EQ(loaded.size(), 2);
+        EXPECT_TRUE((loaded["Suite \"A\"/test\\1"].samples_ns == records["Suite \"A\"/test\\1"].samples_ns));
+        EXPECT_EQ(loaded["Suite \"A\"/test\\1"].allocations, 3);
+        EXPECT_EQ(loaded["Suite B/test"].allocations_max, 7);
+
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        std::fputs("{\"tests\": [{\"name\": \"x\", \"samples_ns\": [1, 2", f);
+        std::fclose(f);
+        EXPECT_FALSE(PerfLog::load(path, loaded));
+        std::remove(path.c_str());
+        EXPECT_FALSE(PerfLog::load(path, loaded));
+    }
+
+    {
+        BEGIN_TEST(tm, "AllocationCount", "operator new calls are counted");
+
+        size_t before = allocation_count();
+        std::vector<int>* p = new std::vector<int>(100);
+        EXPECT_EQ(allocation_count() - before, 2);
+        delete p;
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <vector>
+
+#include "../include/persistent_vector.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING PERSISTENT VECTOR
+// ============================================================================
+
+void run_persistent_vector_tests(void) {
+    TestManager tm{"Testing a persistent vector"};
+
+    {
+        BEGIN_TEST(tm, "FromVector", "persistent_vector<int> pv{ vec }; pv.to_vector()");
+
+        sc::vector<int> vec;
+        std::vector<int> ref;
+        for (auto i{0}; i < 5000; ++i) {
+            vec.push_back(i);
+            ref.push_back(i);
+        }
+        sc::persistent_vector<int> pv{vec};
+
+        EXPECT_TRUE(same_contents(pv, ref));
+        EXPECT_EQ(pv.to_vector(), vec);
+        EXPECT_TRUE(sc::persistent_vector<int>{}.empty());
+        EXPECT_EQ((sc::persistent_vector<int>{1, 2, 3}).back(), 3);
+    }
+
+    {
+        BEGIN_TEST(tm, "PushBackVersions", "pv2 = pv1.push_back(value)");
+
+        std::vector<sc::persistent_vector<int>> versions{sc::persistent_vector<int>{}};
+        for (auto i{0}; i < 2000; ++i) versions.push_back(versions.back().push_back(i));
+
+        // Every version still holds exactly the elements it had when it was created.
+        bool ok{true};
+        for (auto v{0u}; v < versions.size(); v += 97) {
+            EXPECT_EQ(versions[v].size(), v);
+            for (auto i{0u}; i < v; ++i) ok = ok and versions[v][i] == (int)i;
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_TRUE(versions[0].empty());
+
+        auto shorter = versions[1500].pop_back();
+        EXPECT_EQ(shorter.size(), 1499);
+        EXPECT_EQ(versions[1500].size(), 1500);
+    }
+
+    {
+        BEGIN_TEST(tm, "Set", "pv2 = pv1.set(i, value)");
+
+        sc::persistent_vector<int> pv{sc::vector<int>(3000)};
+        auto pv2 = pv.set(2048, 7).set(0, 1);
+
+        EXPECT_EQ(pv[2048], 0);
+        EXPECT_EQ(pv2[2048], 7);
+        EXPECT_EQ(pv2[0], 1);
+        EXPECT_EQ(pv2.size(), pv.size());
+
+        bool worked{false};
+        try {
+            pv.set(3000, 1);
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+    }
+
+    {
+        BEGIN_TEST(tm, "ConcatAndSlice", "pv1.concat(pv2), pv.slice(first, last)");
+
+        // Mix pieces of many sizes so the seams hit partially filled nodes.
+        sc::persistent_vector<int> pv;
+        std::vector<int> ref;
+        int next{0};
+        for (auto len : {1, 31, 33, 0, 1024, 7, 100, 5000, 2, 32}) {
+            sc::vector<int> piece;
+            for (auto i{0}; i < len; ++i) {
+                piece.push_back(next);
+                ref.push_back(next++);
+            }
+            pv = pv.concat(sc::persistent_vector<int>{piece});
+            EXPECT_TRUE(same_contents(pv, ref));
+        }
+
+        // Slices of slices, concatenated back together.
+        auto left = pv.slice(0, 3000);
+        auto middle = pv.slice(3000, 3003);
+        auto right = pv.slice(3003, pv.size());
+        EXPECT_EQ(left.concat(middle).concat(right), pv);
+
+        auto inner = pv.slice(17, 5111).slice(40, 4000);
+        EXPECT_TRUE(same_contents(inner, std::vector<int>(ref.begin() + 57, ref.begin() + 4017)));
+        EXPECT_TRUE(pv.slice(10, 10).empty());
+
+        // Appending to a relaxed tree.
+        auto grown = inner.push_back(-1).set(0, -2);
+        EXPECT_EQ(grown.back(), -1);
+        EXPECT_EQ(grown.front(), -2);
+        EXPECT_EQ(inner.front(), 57);
+    }
+
+    {
+        BEGIN_TEST(tm, "Transient", "auto t = pv.transient(); t.push_back(x); t.persistent()");
+
+        sc::persistent_vector<int> base{1, 2, 3};
+        auto builder = base.transient();
+        for (auto i{4}; i <= 10000; ++i) builder.push_back(i);
+        builder.set(0, 100);
+        auto built = builder.persistent();
+
+        EXPECT_EQ(base.size(), 3);
+        EXPECT_EQ(base[0], 1);
+        EXPECT_EQ(built.size(), 10000);
+        EXPECT_EQ(built[0], 100);
+        EXPECT_EQ(built[9999], 10000);
+
+        // Further edits of the builder do not leak into the published version.
+        builder.set(9999, -1);
+        builder.push_back(10001);
+        EXPECT_EQ(built[9999], 10000);
+        EXPECT_EQ(built.size(), 10000);
+        EXPECT_EQ(builder.persistent()[9999], -1);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
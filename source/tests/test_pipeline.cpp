@@ -0,0 +1,173 @@
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/pipeline.h"
+#include "../include/static_vector.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING PIPELINES
+// ============================================================================
+
+void run_pipeline_tests(void) {
+    TestManager tm{"Testing pipelines"};
+
+    {
+        BEGIN_TEST(tm, "FilterTransform", "filter and transform stages collect into one vector");
+
+        sc::vector<int> v{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        auto even = [](int x) { return x % 2 == 0; };
+        auto square = [](int x) { return x * x; };
+
+        sc::vector<int> out = v | sc::filter(even) | sc::transform(square) | sc::collect<sc::vector>();
+        EXPECT_EQ(out, (sc::vector<int>{4, 16, 36, 64, 100}));
+
+        // Stages change the element type.
+        sc::vector<std::string> text = v | sc::filter([](int x) { return x > 7; }) |
+                                       sc::transform([](int x) { return std::to_string(x); }) |
+                                       sc::collect<sc::vector>();
+        EXPECT_EQ(text, (sc::vector<std::string>{"8", "9", "10"}));
+
+        std::vector<long> longs = v | sc::transform([](int x) { return 2L * x; }) | sc::collect<std::vector>();
+        EXPECT_EQ(longs.size(), 10);
+        EXPECT_EQ(longs.back(), 20);
+    }
+
+    {
+        BEGIN_TEST(tm, "OneAllocation", "a multi-stage pipeline makes one allocation");
+
+        sc::vector<int> v(1000);
+        for (int i{0}; i < 1000; ++i) v[i] = i;
+
+        size_t before = allocation_count();
+        sc::vector<int> out = v | sc::filter([](int x) { return x % 3 == 0; }) |
+                              sc::transform([](int x) { return x + 1; }) |
+                              sc::filter([](int x) { return x % 2 == 0; }) | sc::drop(5) |
+                              sc::collect<sc::vector>();
+        EXPECT_EQ(allocation_count() - before, 1);
+        EXPECT_EQ(out.size(), 162);
+        EXPECT_EQ(out.front(), 34);
+        EXPECT_GE(out.capacity(), out.size());
+    }
+
+    {
+        BEGIN_TEST(tm, "TakeDrop", "take stops reading its input, drop skips");
+
+        sc::vector<int> v{5, 6, 7, 8, 9};
+        EXPECT_EQ((v | sc::take(2) | sc::collect<sc::vector>()), (sc::vector<int>{5, 6}));
+        EXPECT_EQ((v | sc::take(9) | sc::collect<sc::vector>()), v);
+        EXPECT_TRUE((v | sc::take(0) | sc::collect<sc::vector>()).empty());
+        EXPECT_EQ((v | sc::drop(3) | sc::collect<sc::vector>()), (sc::vector<int>{8, 9}));
+        EXPECT_TRUE((v | sc::drop(7) | sc::collect<sc::vector>()).empty());
+        EXPECT_EQ((v | sc::drop(1) | sc::take(2) | sc::collect<sc::vector>()), (sc::vector<int>{6, 7}));
+
+        // The predicate never sees the elements after the last one taken.
+        int calls{0};
+        auto counted = [&calls](int x) {
+            ++calls;
+            return x % 2 == 1;
+        };
+        sc::vector<int> odd = v | sc::filter(counted) | sc::take(2) | sc::collect<sc::vector>();
+        EXPECT_EQ(odd, (sc::vector<int>{5, 7}));
+        EXPECT_EQ(calls, 3);
+
+        EXPECT_EQ((v | sc::take(3)).size_hint(), 3);
+        EXPECT_EQ((v | sc::drop(2)).size_hint(), 3);
+    }
+
+    {
+        BEGIN_TEST(tm, "Chunk", "chunks are spans of a container, or vectors after other stages");
+
+        sc::vector<int> v{1, 2, 3, 4, 5, 6, 7};
+        sc::vector<sc::span<int>> spans = v | sc::chunk(3) | sc::collect<sc::vector>();
+        EXPECT_EQ(spans.size(), 3);
+        EXPECT_TRUE((spans[0].data() == v.data()));
+        EXPECT_EQ(spans[1].front(), 4);
+        EXPECT_EQ(spans[2].size(), 1);
+        spans[2][0] = 70;  // The spans alias the vector.
+        EXPECT_EQ(v.back(), 70);
+
+        sc::vector<sc::vector<int>> groups =
+            v | sc::filter([](int x) { return x != 3; }) | sc::chunk(2) | sc::collect<sc::vector>();
+        EXPECT_EQ(groups.size(), 3);
+        EXPECT_EQ(groups[1], (sc::vector<int>{4, 5}));
+        EXPECT_EQ(groups[2], (sc::vector<int>{6, 70}));
+
+        int sums{0};
+        for (sc::span<int> c : v | sc::chunk(4)) sums += c.back();
+        EXPECT_EQ(sums, 4 + 70);
+
+        sc::vector<int> none;
+        EXPECT_TRUE((none | sc::filter([](int) { return true; }) | sc::chunk(2) | sc::collect<sc::vector>()).empty());
+
+        bool threw{false};
+        try {
+            sc::chunk(0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "EnumerateZip", "enumerate indexes, zip stops at the shorter input");
+
+        sc::vector<char> letters{'a', 'b', 'c'};
+        sc::vector<std::pair<std::size_t, char>> indexed =
+            letters | sc::drop(1) | sc::enumerate() | sc::collect<sc::vector>();
+        EXPECT_EQ(indexed.size(), 2);
+        EXPECT_TRUE((indexed[1] == std::make_pair(std::size_t{1}, 'c')));
+
+        sc::vector<int> numbers{10, 20, 30, 40};
+        sc::vector<std::pair<char, int>> pairs = letters | sc::zip(numbers) | sc::collect<sc::vector>();
+        EXPECT_EQ(pairs.size(), 3);
+        EXPECT_TRUE((pairs[2] == std::make_pair('c', 30)));
+
+        int dot{0};
+        for (auto p : sc::zip(numbers, numbers | sc::transform([](int x) { return x / 10; }))) dot += p.first * p.second;
+        EXPECT_EQ(dot, 300);
+        EXPECT_EQ(sc::zip(letters, numbers).size_hint(), 3);
+    }
+
+    {
+        BEGIN_TEST(tm, "Sources", "pipelines start from any contiguous container, span or array");
+
+        sc::static_vector<int, 4> sv{1, 2, 3};
+        std::array<int, 3> arr{{4, 5, 6}};
+        int raw[2]{7, 8};
+        const sc::vector<int> cv{9, 10};
+        auto plus1 = sc::transform([](int x) { return x + 1; });
+
+        EXPECT_EQ((sv | plus1 | sc::collect<sc::vector>()), (sc::vector<int>{2, 3, 4}));
+        EXPECT_EQ((arr | plus1 | sc::collect<sc::vector>()), (sc::vector<int>{5, 6, 7}));
+        EXPECT_EQ((raw | plus1 | sc::collect<sc::vector>()), (sc::vector<int>{8, 9}));
+        EXPECT_EQ((cv | plus1 | sc::collect<sc::vector>()), (sc::vector<int>{10, 11}));
+        EXPECT_EQ((sc::span<const int>(cv).first(1) | plus1 | sc::collect<sc::vector>()), (sc::vector<int>{10}));
+
+        // Stored pipelines can be run again; filters over a mutable container give references.
+        sc::vector<int> v{1, 2, 3, 4};
+        auto odd = v | sc::filter([](int x) { return x % 2 == 1; });
+        for (int& x : odd) x *= 10;
+        EXPECT_EQ(v, (sc::vector<int>{10, 2, 30, 4}));
+        EXPECT_TRUE((odd | sc::collect<sc::vector>()).empty());
+    }
+
+    {
+        sc::vector<int> v(1 << 16);
+        for (int i{0}; i < (1 << 16); ++i) v[i] = i;
+        BENCH_TEST(tm, "PipelineBench", "filter, transform and filter over 65536 ints into one vector", 20) {
+            sc::vector<int> out = v | sc::filter([](int x) { return x % 3 != 0; }) |
+                                  sc::transform([](int x) { return x * 7; }) |
+                                  sc::filter([](int x) { return x % 2 == 0; }) | sc::collect<sc::vector>();
+            DoNotOptimize(out.size());
+        }
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,305 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/queue.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING LOCK-FREE QUEUES
+// ============================================================================
+
+namespace {
+/// Counts live instances; the copy that exhausts `copies_left` throws.
+struct Brittle {
+    static int live;
+    static int copies_left;
+    int value;
+    Brittle(int v = 0) : value{v} { ++live; }
+    Brittle(const Brittle& other) : value{other.value} {
+        if (copies_left-- == 0) throw std::runtime_error("copy");
+        ++live;
+    }
+    Brittle(Brittle&& other) noexcept : value{other.value} { ++live; }
+    Brittle& operator=(const Brittle&) = default;
+    Brittle& operator=(Brittle&&) = default;
+    ~Brittle() { --live; }
+};
+int Brittle::live = 0;
+int Brittle::copies_left = 1 << 30;
+}  // namespace
+
+void run_queue_tests(void) {
+    TestManager tm{"Testing lock-free queues"};
+
+    {
+        BEGIN_TEST(tm, "SpscBasics", "capacity rounds up, FIFO order, full and empty");
+
+        sc::spsc_queue<int> q(5);
+        EXPECT_EQ(q.capacity(), 8);
+        EXPECT_TRUE(q.empty());
+        int out{0};
+        EXPECT_FALSE(q.try_pop(out));
+
+        for (int i{0}; i < 8; ++i) EXPECT_TRUE(q.try_push(i));
+        EXPECT_FALSE(q.try_push(8));
+        EXPECT_EQ(q.size(), 8);
+        for (int i{0}; i < 8; ++i) {
+            EXPECT_TRUE(q.try_pop(out));
+            EXPECT_EQ(out, i);
+        }
+        EXPECT_FALSE(q.try_pop(out));
+
+        bool threw{false};
+        try {
+            sc::spsc_queue<int> none(0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "SpscBatches", "try_push_n and try_pop_n move runs across the wrap");
+
+        sc::spsc_queue<std::uint32_t> q(8);
+        std::uint32_t in[12], out[12];
+        for (std::uint32_t i{0}; i < 12; ++i) in[i] = i * 3;
+
+        EXPECT_EQ(q.try_push_n(in, 5), 5);
+        EXPECT_EQ(q.try_pop_n(out, 4), 4);
+        EXPECT_EQ(out[3], 9);
+        // Positions 5..12 wrap around the end of the ring; only 7 slots are free.
+        EXPECT_EQ(q.try_push_n(sc::span<const std::uint32_t>(in + 5, 7)), 7);
+        EXPECT_EQ(q.try_push_n(in, 12), 0);
+        EXPECT_EQ(q.try_pop_n(sc::span<std::uint32_t>(out)), 8);
+        EXPECT_EQ(out[0], 12);
+        EXPECT_EQ(out[7], 33);
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        BEGIN_TEST(tm, "MoveOnly", "non-trivial and move-only elements, destroyed with the queue");
+
+        std::shared_ptr<int> counter = std::make_shared<int>(0);
+        {
+            sc::spsc_queue<std::unique_ptr<int>> q(4);
+            EXPECT_TRUE(q.try_push(std::unique_ptr<int>(new int(7))));
+            std::unique_ptr<int> p;
+            EXPECT_TRUE(q.try_pop(p));
+            EXPECT_EQ(*p, 7);
+
+            sc::mpmc_queue<std::shared_ptr<int>> m(4);
+            EXPECT_TRUE(m.try_push(counter));
+            EXPECT_TRUE(m.try_push(counter));
+            EXPECT_EQ(counter.use_count(), 3);
+            std::shared_ptr<int> got;
+            EXPECT_TRUE(m.try_pop(got));
+            EXPECT_EQ(counter.use_count(), 3);  // One moved to `got`, one left in the queue.
+        }
+        EXPECT_EQ(counter.use_count(), 1);
+
+        sc::spsc_queue<std::string> s(2);
+        std::string words[3]{"a", "bb", "ccc"};
+        EXPECT_EQ(s.try_push_n(words, 3), 2);
+        std::string back[2];
+        EXPECT_EQ(s.try_pop_n(back, 2), 2);
+        EXPECT_EQ(back[1], "bb");
+    }
+
+    {
+        BEGIN_TEST(tm, "ThrowingCopy", "a copy that throws leaves nothing half pushed");
+
+        Brittle items[4]{1, 2, 3, 4};
+        {
+            sc::spsc_queue<Brittle> s(4);
+            Brittle::copies_left = 2;
+            bool threw{false};
+            try {
+                s.try_push_n(items, 4);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            EXPECT_TRUE(threw);
+            EXPECT_EQ(Brittle::live, 4);  // The two copies already built were destroyed.
+            EXPECT_TRUE(s.empty());
+            Brittle::copies_left = 1 << 30;
+            EXPECT_EQ(s.try_push_n(items + 1, 3), 3);
+            Brittle out;
+            EXPECT_TRUE(s.try_pop(out));
+            EXPECT_EQ(out.value, 2);
+
+            sc::mpmc_queue<Brittle> m(4);
+            Brittle::copies_left = 0;
+            threw = false;
+            try {
+                m.try_push(items[0]);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            EXPECT_TRUE(threw);
+            Brittle::copies_left = 2;
+            threw = false;
+            try {
+                m.try_push_n(items, 4);
+            } catch (const std::runtime_error&) {
+                threw = true;
+            }
+            EXPECT_TRUE(threw);
+            EXPECT_TRUE(m.empty());
+            // No slot was left claimed but never filled: later pushes and pops go through.
+            Brittle::copies_left = 1 << 30;
+            EXPECT_TRUE(m.try_push(items[2]));
+            EXPECT_EQ(m.try_push_n(items, 2), 2);
+            EXPECT_TRUE(m.try_pop(out));
+            EXPECT_EQ(out.value, 3);
+            EXPECT_TRUE(m.try_pop(out));
+            EXPECT_EQ(out.value, 1);
+        }
+        EXPECT_EQ(Brittle::live, 4);
+    }
+
+    {
+        BEGIN_TEST(tm, "SpscThreads", "a producer and a consumer thread, blocking and batched");
+
+        const std::uint64_t n{200000};
+        sc::spsc_queue<std::uint64_t> q(64);
+        std::thread producer([&q, n] {
+            std::uint64_t batch[16];
+            std::uint64_t next{0};
+            while (next < n) {
+                if (next % 3 == 0) {
+                    q.push(next++);
+                    continue;
+                }
+                std::size_t k{0};
+                for (; k < 16 and next + k < n; ++k) batch[k] = next + k;
+                next += q.try_push_n(batch, k);
+            }
+        });
+        bool in_order{true};
+        std::uint64_t expected{0}, buffer[8];
+        while (expected < n) {
+            if (expected % 2 == 0) {
+                std::uint64_t v;
+                q.pop(v);
+                in_order = in_order and v == expected++;
+            } else {
+                std::size_t got = q.try_pop_n(buffer, 8);
+                for (std::size_t i{0}; i < got; ++i) in_order = in_order and buffer[i] == expected++;
+            }
+        }
+        producer.join();
+        EXPECT_TRUE(in_order);
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        BEGIN_TEST(tm, "SleepWait", "blocked push and pop wake up with the sleep_wait policy");
+
+        sc::spsc_queue<int, sc::sleep_wait> q(2);
+        int received[5]{0, 0, 0, 0, 0};
+        std::thread consumer([&q, &received] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));  // The producer fills the queue and blocks.
+            for (int& r : received) q.pop(r);
+        });
+        for (int i{1}; i <= 5; ++i) q.push(i);
+        consumer.join();
+        EXPECT_EQ(received[0], 1);
+        EXPECT_EQ(received[4], 5);
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        BEGIN_TEST(tm, "MpmcBasics", "FIFO order, full and empty, runs of slots");
+
+        sc::mpmc_queue<int> q(4);
+        int out{0};
+        EXPECT_FALSE(q.try_pop(out));
+        int items[6]{1, 2, 3, 4, 5, 6};
+        EXPECT_EQ(q.try_push_n(items, 6), 4);
+        EXPECT_FALSE(q.try_push(9));
+        EXPECT_EQ(q.size(), 4);
+        EXPECT_TRUE(q.try_pop(out));
+        EXPECT_EQ(out, 1);
+        EXPECT_EQ(q.try_push_n(sc::span<const int>(items + 4, 2)), 1);  // Wraps around.
+        int got[8];
+        EXPECT_EQ(q.try_pop_n(got, 8), 4);
+        EXPECT_EQ(got[0], 2);
+        EXPECT_EQ(got[3], 5);
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        BEGIN_TEST(tm, "MpmcThreads", "several producers and consumers hand over every item once");
+
+        const unsigned producers{3}, consumers{3};
+        const std::uint64_t per_producer{50000};
+        sc::mpmc_queue<std::uint64_t, sc::sleep_wait> q(128);
+        std::atomic<std::uint64_t> sum{0}, count{0};
+        std::vector<std::thread> threads;
+        for (unsigned p{0}; p < producers; ++p)
+            threads.emplace_back([&q, p, per_producer] {
+                std::uint64_t batch[4];
+                for (std::uint64_t i{0}; i < per_producer;) {
+                    std::uint64_t value = p * per_producer + i + 1;
+                    if (i % 4 != 0) {
+                        q.push(value);
+                        ++i;
+                        continue;
+                    }
+                    std::size_t k{0};
+                    for (; k < 4 and i + k < per_producer; ++k) batch[k] = value + k;
+                    i += q.try_push_n(batch, k);
+                }
+            });
+        const std::uint64_t total = producers * per_producer;
+        for (unsigned c{0}; c < consumers; ++c)
+            threads.emplace_back([&q, &sum, &count, total, c] {
+                std::uint64_t local{0}, batch[4];
+                while (count.load() < total) {
+                    std::size_t got;
+                    if (c == 0) {
+                        got = q.try_pop_n(batch, 4);
+                    } else {
+                        got = q.try_pop(batch[0]) ? 1 : 0;
+                    }
+                    for (std::size_t i{0}; i < got; ++i) local += batch[i];
+                    if (got != 0)
+                        count.fetch_add(got);
+                    else
+                        std::this_thread::yield();
+                }
+                sum.fetch_add(local);
+            });
+        for (std::thread& t : threads) t.join();
+        EXPECT_EQ(count.load(), total);
+        EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+        EXPECT_TRUE(q.empty());
+    }
+
+    {
+        sc::spsc_queue<std::uint64_t> spsc(1024);
+        sc::mpmc_queue<std::uint64_t> mpmc(1024);
+        std::uint64_t v{0};
+        BENCH_TEST(tm, "HandoffBench", "10000 push/pop pairs through each queue, one thread", 20) {
+            for (std::uint64_t i{0}; i < 10000; ++i) {
+                spsc.try_push(i);
+                spsc.try_pop(v);
+                mpmc.try_push(v);
+                mpmc.try_pop(v);
+            }
+            DoNotOptimize(v);
+        }
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,119 @@
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../include/rcu_vector.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING RCU VECTOR
+// ============================================================================
+
+void run_rcu_vector_tests(void) {
+    TestManager tm{"Testing an rcu vector"};
+
+    {
+        BEGIN_TEST(tm, "Snapshot", "a snapshot keeps its version alive across publishes");
+
+        sc::rcu_vector<int> rv(sc::vector<int>{1, 2, 3}, 4);
+        sc::rcu_vector<int>::reader r(rv);
+        {
+            auto snap = r.read();
+            rv.publish(sc::vector<int>{4, 5});
+            rv.update([](sc::vector<int>& v) { v.push_back(6); });
+
+            // The snapshot still sees the first version; the writer sees the last one.
+            EXPECT_EQ(snap.size(), 3);
+            EXPECT_EQ(snap[0], 1);
+            EXPECT_EQ(snap[2], 3);
+            EXPECT_EQ(rv.get(), (sc::vector<int>{4, 5, 6}));
+            EXPECT_EQ(rv.reclaim(), 2);
+        }
+        EXPECT_EQ(rv.reclaim(), 0);
+
+        auto snap = r.read();
+        auto sum{0};
+        for (auto e : snap) sum += e;
+        EXPECT_EQ(sum, 15);
+    }
+
+    {
+        BEGIN_TEST(tm, "Reuse", "reclaimed versions are reused and readers are limited");
+
+        sc::rcu_vector<int> rv(2);
+        sc::vector<int> big(1000);
+        rv.publish(big);
+        rv.publish(big);
+        rv.synchronize();  // The first two versions are now spares.
+
+        sc::rcu_vector<int>::reader r(rv);
+        const int* before;
+        {
+            auto snap = r.read();
+            before = snap.data();
+        }
+        rv.update([](sc::vector<int>& v) { v[0] = 1; });
+        rv.update([](sc::vector<int>& v) { v[1] = 2; });
+        {
+            // Two updates later the storage of `before` carries the newest version.
+            auto snap = r.read();
+            EXPECT_EQ(snap.data(), before);
+            EXPECT_EQ(snap[0], 1);
+            EXPECT_EQ(snap[1], 2);
+        }
+
+        sc::rcu_vector<int>::reader r2(rv);
+        bool threw{false};
+        try {
+            sc::rcu_vector<int>::reader r3(rv);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "ConcurrentReaders", "readers never see a torn or freed version");
+
+        const int versions{300};
+        const int length{64};
+        sc::rcu_vector<int> rv(sc::vector<int>(length), 8);
+        std::atomic<bool> done{false};
+        std::atomic<int> bad{0};
+
+        // Version k holds `length` copies of k, and readers must never see a mix.
+        std::vector<std::thread> readers;
+        for (auto t{0}; t < 4; ++t) {
+            readers.emplace_back([&]() {
+                sc::rcu_vector<int>::reader r(rv);
+                int last{0};
+                while (not done.load()) {
+                    auto snap = r.read();
+                    if (snap.size() != static_cast<unsigned long>(length)) ++bad;
+                    int first = snap[0];
+                    for (auto e : snap)
+                        if (e != first) ++bad;
+                    if (first < last) ++bad;  // Versions only move forward.
+                    last = first;
+                }
+            });
+        }
+        for (auto k{1}; k <= versions; ++k) {
+            rv.update([k](sc::vector<int>& v) {
+                for (auto& e : v) e = k;
+            });
+        }
+        done = true;
+        for (auto& t : readers) t.join();
+        rv.synchronize();
+
+        EXPECT_EQ(bad.load(), 0);
+        EXPECT_EQ(rv.pending(), 0);
+        EXPECT_EQ(rv.get()[length - 1], versions);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,182 @@
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+
+#include "../include/ring_vector.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING RING VECTOR
+// ============================================================================
+
+void run_ring_vector_tests(void) {
+    TestManager tm{"Testing a ring vector"};
+
+    {
+        BEGIN_TEST(tm, "Constructors", "ring_vector<int> rv{ 1, 2, 3 }, rv(n), rv(first, last), copy");
+
+        sc::ring_vector<int> rv{1, 2, 3, 4, 5};
+        EXPECT_TRUE(same_contents(rv, std::deque<int>{1, 2, 3, 4, 5}));
+        EXPECT_TRUE(same_contents(sc::ring_vector<int>(3), std::deque<int>(3)));
+        EXPECT_TRUE(sc::ring_vector<int>{}.empty());
+
+        std::deque<int> src{9, 8, 7};
+        sc::ring_vector<int> ranged(src.begin(), src.end());
+        EXPECT_TRUE(same_contents(ranged, src));
+
+        rv.pop_front();
+        rv.push_back(6);  // Wraps around.
+        sc::ring_vector<int> copy{rv};
+        EXPECT_EQ(copy, rv);
+        ranged = rv;
+        EXPECT_EQ(ranged, rv);
+    }
+
+    {
+        BEGIN_TEST(tm, "Fifo", "rv.push_back(x); rv.pop_front()");
+
+        sc::ring_vector<std::string> rv;
+        std::deque<std::string> ref;
+        for (auto i{0}; i < 1000; ++i) {
+            rv.push_back(std::to_string(i));
+            ref.push_back(std::to_string(i));
+            if (i % 3 != 0) {
+                rv.pop_front();
+                ref.pop_front();
+            }
+        }
+        EXPECT_TRUE(same_contents(rv, ref));
+
+        // Once warm, a steady-state queue stops growing.
+        auto cap = rv.capacity();
+        for (auto i{0}; i < 1000; ++i) {
+            rv.push_back(rv.front());
+            rv.pop_front();
+            ref.push_back(ref.front());
+            ref.pop_front();
+        }
+        EXPECT_EQ(rv.capacity(), cap);
+        EXPECT_TRUE(same_contents(rv, ref));
+    }
+
+    {
+        BEGIN_TEST(tm, "BothEnds", "push_front/pop_front/push_back/pop_back");
+
+        sc::ring_vector<int> rv;
+        std::deque<int> ref;
+        for (auto i{0}; i < 200; ++i) {
+            if (i % 2) {
+                rv.push_front(i);
+                ref.push_front(i);
+            } else {
+                rv.push_back(i);
+                ref.push_back(i);
+            }
+            if (i % 5 == 0) {
+                rv.pop_back();
+                ref.pop_back();
+            }
+        }
+        EXPECT_TRUE(same_contents(rv, ref));
+        EXPECT_EQ(rv.front(), ref.front());
+        EXPECT_EQ(rv.back(), ref.back());
+
+        rv.push_front(rv.back());
+        ref.push_front(ref.back());
+        EXPECT_TRUE(same_contents(rv, ref));
+
+        rv.clear();
+        bool worked{false};
+        try {
+            rv.pop_front();
+        } catch (std::length_error& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+    }
+
+    {
+        BEGIN_TEST(tm, "AsSpans", "auto halves = rv.as_spans()");
+
+        sc::ring_vector<int> rv;
+        rv.reserve(8);
+        for (auto i{0}; i < 8; ++i) rv.push_back(i);
+        for (auto i{0}; i < 3; ++i) rv.pop_front();
+        for (auto i{8}; i < 11; ++i) rv.push_back(i);  // Contents: 3..10, wrapped.
+
+        auto halves = rv.as_spans();
+        EXPECT_EQ(halves.first.size + halves.second.size, rv.size());
+        EXPECT_EQ(halves.second.size, 3);
+
+        int copy[8];
+        std::memcpy(copy, halves.first.data, halves.first.size * sizeof(int));
+        std::memcpy(copy + halves.first.size, halves.second.data, halves.second.size * sizeof(int));
+        bool ok{true};
+        for (auto i{0}; i < 8; ++i) ok = ok and copy[i] == i + 3;
+        EXPECT_TRUE(ok);
+
+        sc::ring_vector<int> unwrapped{1, 2};
+        EXPECT_EQ(unwrapped.as_spans().second.size, 0);
+    }
+
+    {
+        BEGIN_TEST(tm, "Linearize", "int* block = rv.linearize()");
+
+        sc::ring_vector<int> rv;
+        rv.reserve(6);
+        for (auto i{0}; i < 6; ++i) rv.push_back(i);
+        rv.pop_front();
+        rv.pop_front();
+        rv.push_back(6);
+
+        auto cap = rv.capacity();
+        size_t before = allocation_count();
+        int* block = rv.linearize();
+        EXPECT_EQ(allocation_count() - before, 0);  // Rotated in place.
+        EXPECT_EQ(rv.capacity(), cap);
+        EXPECT_EQ(rv.as_spans().second.size, 0);
+        bool ok{true};
+        for (auto i{0}; i < 5; ++i) ok = ok and block[i] == i + 2;
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(rv.linearize(), block);  // Already contiguous.
+
+        // Non-trivial elements: a wrapped ring with free slots, and a full one.
+        sc::ring_vector<std::string> words;
+        words.reserve(7);
+        for (auto i{0}; i < 5; ++i) words.push_back(std::string(20, char('a' + i)));
+        for (auto i{0}; i < 4; ++i) words.pop_front();
+        for (auto i{5}; i < 9; ++i) words.push_back(std::string(20, char('a' + i)));
+        std::deque<std::string> ref;
+        for (auto i{4}; i < 9; ++i) ref.push_back(std::string(20, char('a' + i)));
+        EXPECT_NE(words.as_spans().second.size, 0);
+        std::string* first = words.linearize();
+        EXPECT_TRUE(same_contents(words, ref));
+        EXPECT_TRUE((first[4] == ref[4]));
+
+        while (words.size() < words.capacity()) {
+            words.push_back("z");
+            ref.push_back("z");
+        }
+        words.pop_front();
+        ref.pop_front();
+        words.push_back("full");
+        ref.push_back("full");
+        EXPECT_EQ(words.size(), words.capacity());
+        words.linearize();
+        EXPECT_EQ(words.as_spans().second.size, 0);
+        EXPECT_TRUE(same_contents(words, ref));
+
+        bool worked{false};
+        try {
+            rv.at(5);
+        } catch (std::out_of_range& e) {
+            worked = true;
+        }
+        EXPECT_TRUE(worked);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
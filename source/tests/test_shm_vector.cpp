@@ -0,0 +1,236 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/wait.h>  // waitpid
+#include <unistd.h>    // fork, getpid, _exit
+
+#include "../include/shm_vector.h"
+#endif
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING SHARED MEMORY VECTORS
+// ============================================================================
+
+void run_shm_vector_tests(void) {
+    TestManager tm{"Testing shared memory vectors"};
+
+#if defined(__linux__)
+    const std::string name = "/sc_test_shm_vector_" + std::to_string(::getpid());
+
+    {
+        BEGIN_TEST(tm, "Basics", "append, view in place, capacity is fixed");
+
+        auto v = sc::shm_vector<int>::create_anonymous(6);
+        EXPECT_TRUE(v.empty());
+        EXPECT_EQ(v.capacity(), 6);
+        EXPECT_TRUE(v.writable());
+        v.push_back(1);
+        int more[3]{2, 3, 4};
+        v.append(more, 3);
+        v.append(sc::span<const int>(more, 2));
+        EXPECT_EQ(v.size(), 6);
+        EXPECT_EQ(v[3], 4);
+        EXPECT_EQ(v.view().back(), 3);
+        int sum{0};
+        for (int x : v) sum += x;
+        EXPECT_EQ(sum, 15);
+
+        bool threw{false};
+        try {
+            v.push_back(7);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+        EXPECT_EQ(v.size(), 6);
+
+        v.clear();
+        EXPECT_TRUE(v.empty());
+        v.push_back(9);
+        EXPECT_EQ(v[0], 9);
+    }
+
+    {
+        BEGIN_TEST(tm, "TwoMappings", "the same region at two addresses, read-write and read-only");
+
+        auto writer = sc::shm_vector<double>::create_anonymous(100);
+        auto reader = sc::shm_vector<double>::from_fd(writer.fd());
+        EXPECT_TRUE((writer.data() != reader.data()));
+        EXPECT_FALSE(reader.writable());
+        writer.push_back(2.5);
+        writer.push_back(-1.0);
+        EXPECT_EQ(reader.size(), 2);
+        EXPECT_EQ(reader[0], 2.5);
+        EXPECT_EQ(reader.snapshot(), (sc::vector<double>{2.5, -1.0}));
+
+        bool threw{false};
+        try {
+            reader.push_back(0.0);
+        } catch (const std::logic_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        // The moved-to object keeps the mapping.
+        sc::shm_vector<double> moved = std::move(writer);
+        moved.push_back(4.0);
+        EXPECT_EQ(reader.size(), 3);
+    }
+
+    {
+        BEGIN_TEST(tm, "Errors", "missing names, wrong element size, duplicate create");
+
+        bool threw{false};
+        try {
+            sc::shm_vector<int>::open(name + "_missing");
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        auto v = sc::shm_vector<std::uint32_t>::create(name, 8);
+        threw = false;
+        try {
+            sc::shm_vector<std::uint32_t>::create(name, 8);
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        threw = false;
+        try {
+            sc::shm_vector<std::uint64_t>::open(name);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        EXPECT_TRUE(sc::shm_vector<std::uint32_t>::unlink(name));
+        EXPECT_FALSE(sc::shm_vector<std::uint32_t>::unlink(name));
+        v.push_back(1);  // The mapping outlives the name.
+        EXPECT_EQ(v.size(), 1);
+
+        // A capacity whose size in bytes overflows, before anything is created.
+        threw = false;
+        try {
+            sc::shm_vector<std::uint64_t>::create(name, std::size_t(-1) / 4);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+        EXPECT_FALSE(sc::shm_vector<std::uint64_t>::unlink(name));
+        threw = false;
+        try {
+            sc::shm_vector<std::uint64_t>::create_anonymous(std::size_t(-1) / 8);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "SequenceLock", "read() never sees a change in place half done");
+
+        auto v = sc::shm_vector<std::uint64_t>::create_anonymous(256);
+        for (std::uint64_t i{0}; i < 256; ++i) v.push_back(0);
+        auto reader = sc::shm_vector<std::uint64_t>::from_fd(v.fd());
+
+        std::thread writer([&v] {
+            for (std::uint64_t k{1}; k <= 2000; ++k)
+                v.modify([k](sc::span<std::uint64_t> s) {
+                    for (std::uint64_t& x : s) x = k;
+                });
+        });
+        bool consistent{true};
+        std::uint64_t last{0};
+        while (last < 2000) {
+            auto seen = reader.read([](sc::span<const std::uint64_t> s) {
+                std::uint64_t first = s.front();
+                for (std::uint64_t x : s)
+                    if (x != first) return std::uint64_t(-1);
+                return first;
+            });
+            consistent = consistent and seen != std::uint64_t(-1) and seen >= last;
+            if (seen != std::uint64_t(-1)) last = seen;
+        }
+        writer.join();
+        EXPECT_TRUE(consistent);
+        EXPECT_EQ(reader.sequence(), 4000);
+
+        // A change that throws still releases the lock.
+        bool threw{false};
+        try {
+            v.modify([](sc::span<std::uint64_t> s) {
+                s[0] = 7;
+                throw std::runtime_error("modify");
+            });
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+        EXPECT_EQ(reader.sequence(), 4002);
+        EXPECT_EQ(reader.read([](sc::span<const std::uint64_t> s) { return s[0]; }), 7);
+    }
+
+    {
+        BEGIN_TEST(tm, "Fork", "a child process reads, in place, what its parent appends");
+
+        const std::uint64_t n{100000};
+        auto producer = sc::shm_vector<std::uint64_t>::create(name, n);
+        pid_t child = ::fork();
+        if (child == 0) {
+            // Maps the region read-only by name and checks each element where it lies.
+            int status{1};
+            try {
+                auto consumer = sc::shm_vector<std::uint64_t>::open(name);
+                std::uint64_t i{0};
+                bool ok{true};
+                while (i < n) {
+                    sc::span<const std::uint64_t> fresh = consumer.view().subspan(i);
+                    for (std::uint64_t x : fresh) ok = ok and x == 3 * i++;
+                    if (fresh.empty()) std::this_thread::yield();
+                }
+                status = ok ? 0 : 2;
+            } catch (...) {
+                status = 3;
+            }
+            ::_exit(status);
+        }
+
+        std::uint64_t batch[1000];
+        for (std::uint64_t start{0}; start < n; start += 1000) {
+            for (std::uint64_t k{0}; k < 1000; ++k) batch[k] = 3 * (start + k);
+            producer.append(batch, 1000);
+        }
+        int status{0};
+        EXPECT_EQ(::waitpid(child, &status, 0), child);
+        EXPECT_TRUE(WIFEXITED(status));
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+        EXPECT_TRUE(sc::shm_vector<std::uint64_t>::unlink(name));
+    }
+
+    {
+        auto v = sc::shm_vector<std::uint64_t>::create_anonymous(1 << 16);
+        std::uint64_t batch[256];
+        for (std::uint64_t k{0}; k < 256; ++k) batch[k] = k;
+        BENCH_TEST(tm, "AppendBench", "65536 elements appended in batches of 256, then summed in place", 20) {
+            v.clear();
+            for (int b{0}; b < 256; ++b) v.append(batch, 256);
+            std::uint64_t sum{0};
+            for (std::uint64_t x : v) sum += x;
+            DoNotOptimize(sum);
+        }
+    }
+#endif
+
+    tm.summary();
+    std::cout << "\n\n";
+}
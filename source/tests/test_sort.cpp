@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/sort.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING SORT
+// ============================================================================
+
+/// A record sorted by one of its fields.
+struct Order {
+    std::uint32_t id;  //!< Position in the input, to check stability.
+    float price;       //!< Sort key.
+};
+
+void run_sort_tests(void) {
+    TestManager tm{"Testing sort"};
+    std::mt19937_64 rng{2024};
+
+    {
+        BEGIN_TEST(tm, "Integers", "radix sort of signed and unsigned integers against std::sort");
+
+        for (std::size_t n : {0u, 1u, 100u, 5000u}) {
+            sc::vector<std::int64_t> v;
+            std::vector<std::int64_t> ref;
+            for (std::size_t i{0}; i < n; ++i) {
+                auto x = static_cast<std::int64_t>(rng());
+                if (i % 3 == 0) x %= 100;  // Small negatives and duplicates.
+                v.push_back(x);
+                ref.push_back(x);
+            }
+            std::sort(ref.begin(), ref.end());
+            sc::sort(v);
+            EXPECT_TRUE(same_contents(v, ref));
+        }
+
+        // Only the low byte varies: the other passes are skipped.
+        sc::vector<std::uint32_t, sc::compact<std::uint32_t>> small;
+        std::vector<std::uint32_t> ref;
+        for (auto i{0}; i < 1000; ++i) {
+            small.push_back(0xABCD0000u + static_cast<std::uint32_t>(rng() % 256));
+            ref.push_back(small.back());
+        }
+        std::sort(ref.begin(), ref.end());
+        sc::sort(small);
+        EXPECT_TRUE(same_contents(small, ref));
+    }
+
+    {
+        BEGIN_TEST(tm, "Floats", "negative values, zeros and infinities in order");
+
+        sc::vector<double> v;
+        for (auto i{0}; i < 2000; ++i) v.push_back(std::uniform_real_distribution<double>(-1e9, 1e9)(rng));
+        v.push_back(std::numeric_limits<double>::infinity());
+        v.push_back(-std::numeric_limits<double>::infinity());
+        v.push_back(0.0);
+        v.push_back(-0.0);
+        sc::sort(v);
+        EXPECT_TRUE(std::is_sorted(v.begin().base(), v.end().base()));
+        EXPECT_EQ(v.front(), -std::numeric_limits<double>::infinity());
+        EXPECT_EQ(v.back(), std::numeric_limits<double>::infinity());
+
+        sc::vector<float> f{2.5f, -1.0f, 0.0f, -3.5f, 1.0f};
+        sc::sort(f);
+        EXPECT_EQ(f, (sc::vector<float>{-3.5f, -1.0f, 0.0f, 1.0f, 2.5f}));
+    }
+
+    {
+        BEGIN_TEST(tm, "PairsAndRecords", "pairs by (first, second); records by a key, stably");
+
+        sc::vector<std::pair<std::uint16_t, std::int32_t>> pairs;
+        std::vector<std::pair<std::uint16_t, std::int32_t>> ref;
+        for (auto i{0}; i < 3000; ++i) {
+            pairs.push_back(std::make_pair(static_cast<std::uint16_t>(rng() % 20), static_cast<std::int32_t>(rng())));
+            ref.push_back(pairs.back());
+        }
+        std::sort(ref.begin(), ref.end());
+        sc::sort(pairs);
+        EXPECT_TRUE(same_contents(pairs, ref));
+
+        sc::vector<Order> orders;
+        for (std::uint32_t i{0}; i < 3000; ++i) orders.push_back(Order{i, static_cast<float>(rng() % 50) - 25.0f});
+        sc::sort(orders, [](const Order& o) { return o.price; });
+        bool ordered{true};
+        for (std::size_t i{1}; i < orders.size(); ++i) {
+            const Order& a = orders[i - 1];
+            const Order& b = orders[i];
+            if (a.price > b.price or (a.price == b.price and a.id > b.id)) ordered = false;
+        }
+        EXPECT_TRUE(ordered);
+    }
+
+    {
+        BEGIN_TEST(tm, "Fallback", "strings and small inputs use comparison sorts");
+
+        sc::vector<std::string> words{"pear", "apple", "fig", "banana", "apple"};
+        sc::sort(words);
+        EXPECT_EQ(words, (sc::vector<std::string>{"apple", "apple", "banana", "fig", "pear"}));
+        sc::sort(words, [](const std::string& w) { return w.size(); });
+        EXPECT_EQ(words, (sc::vector<std::string>{"fig", "pear", "apple", "apple", "banana"}));
+    }
+
+    {
+        BEGIN_TEST(tm, "Parallel", "sample sort on 4 threads against std::sort");
+
+        const std::size_t n = 300000;
+        sc::vector<std::uint64_t> v;
+        std::vector<std::uint64_t> ref;
+        v.reserve(n);
+        for (std::size_t i{0}; i < n; ++i) {
+            v.push_back(i % 4 == 0 ? 42 : rng());  // A heavy duplicate lands in a single bucket.
+            ref.push_back(v.back());
+        }
+        std::sort(ref.begin(), ref.end());
+        sc::parallel_sort(v, 4);
+        EXPECT_TRUE(same_contents(v, ref));
+
+        sc::vector<Order> orders;
+        for (std::uint32_t i{0}; i < n; ++i) orders.push_back(Order{i, static_cast<float>(rng() % 1000)});
+        sc::parallel_sort(orders, [](const Order& o) { return o.price; }, 4);
+        bool ordered{true};
+        for (std::size_t i{1}; i < orders.size(); ++i) {
+            const Order& a = orders[i - 1];
+            const Order& b = orders[i];
+            if (a.price > b.price or (a.price == b.price and a.id > b.id)) ordered = false;
+        }
+        EXPECT_TRUE(ordered);
+    }
+
+    {
+        BENCH_TEST(tm, "RadixBench", "sc::sort of 100000 random 64-bit keys", 10) {
+            sc::vector<std::uint64_t> keys;
+            keys.reserve(100000);
+            for (auto i{0}; i < 100000; ++i) keys.push_back(rng());
+            sc::sort(keys);
+            DoNotOptimize(keys.front());
+            EXPECT_TRUE(std::is_sorted(keys.begin().base(), keys.end().base()));
+        }
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../include/sort.h"
+#include "../include/span.h"
+#include "../include/static_vector.h"
+#include "../include/vector_hash.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING SPAN AND SLICE
+// ============================================================================
+
+/// Sums the viewed elements; takes any contiguous source without copying it.
+static long total(sc::span<const int> xs) {
+    long sum{0};
+    for (int x : xs) sum += x;
+    return sum;
+}
+
+void run_span_tests(void) {
+    TestManager tm{"Testing span and slice"};
+
+    {
+        BEGIN_TEST(tm, "Conversions", "spans of vectors, static_vectors, std::vectors and arrays");
+
+        sc::vector<int> vec{1, 2, 3, 4};
+        const sc::vector<int>& cvec = vec;
+        sc::static_vector<int, 8> sv{5, 6};
+        std::vector<int> stdvec{7, 8, 9};
+        int array[3]{10, 20, 30};
+
+        EXPECT_EQ(total(vec), 10);
+        EXPECT_EQ(total(cvec), 10);
+        EXPECT_EQ(total(sv), 11);
+        EXPECT_EQ(total(stdvec), 24);
+        EXPECT_EQ(total(array), 60);
+
+        // The const data() gives a pointer, so a const vector makes a span<const int>.
+        EXPECT_TRUE((std::is_same<decltype(cvec.data()), const int*>::value));
+        EXPECT_TRUE((std::is_convertible<const sc::vector<int>&, sc::span<const int>>::value));
+        EXPECT_FALSE((std::is_convertible<const sc::vector<int>&, sc::span<int>>::value));
+        EXPECT_FALSE((std::is_convertible<sc::vector<long>&, sc::span<int>>::value));
+
+        sc::span<int> s{vec};
+        EXPECT_TRUE((s.data() == vec.data()));
+        EXPECT_EQ(s.size(), 4);
+        EXPECT_EQ(s.size_bytes(), 4 * sizeof(int));
+        s[0] = 100;  // Writes through to the vector.
+        EXPECT_EQ(vec[0], 100);
+        sc::span<const int> cs = s;
+        EXPECT_EQ(cs.back(), 4);
+        EXPECT_TRUE(sc::span<int>().empty());
+        EXPECT_EQ(sizeof(sc::span<int>), 2 * sizeof(void*));
+    }
+
+    {
+        BEGIN_TEST(tm, "Subspans", "first, last and subspan, with range checks");
+
+        sc::vector<int> vec{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        sc::span<int> s{vec};
+
+        EXPECT_EQ(total(s.first(3)), 3);
+        EXPECT_EQ(total(s.last(2)), 17);
+        EXPECT_EQ(s.subspan(4).front(), 4);
+        EXPECT_EQ(s.subspan(4).size(), 6);
+        EXPECT_EQ(s.subspan(2, 3).back(), 4);
+        EXPECT_TRUE(s.subspan(10).empty());
+
+        sc::vector<int> copy(s.subspan(3, 4).begin(), s.subspan(3, 4).end());
+        EXPECT_EQ(copy, (sc::vector<int>{3, 4, 5, 6}));
+
+        int thrown{0};
+        try {
+            s.subspan(11);
+        } catch (const std::out_of_range&) {
+            ++thrown;
+        }
+        try {
+            s.subspan(5, 6);
+        } catch (const std::out_of_range&) {
+            ++thrown;
+        }
+        try {
+            s.first(11);
+        } catch (const std::out_of_range&) {
+            ++thrown;
+        }
+        try {
+            s.at(10);
+        } catch (const std::out_of_range&) {
+            ++thrown;
+        }
+        EXPECT_EQ(thrown, 4);
+    }
+
+    {
+        BEGIN_TEST(tm, "Strided", "strided views, their iterators and the standard algorithms");
+
+        // A 3x4 row-major matrix.
+        sc::vector<int> m{9, 1, 5, 0,  //
+                          3, 8, 2, 7,  //
+                          6, 4, 1, 2};
+        sc::slice<int> column(m.data() + 1, 3, 4);
+        EXPECT_EQ(column.size(), 3);
+        EXPECT_EQ(column[2], 4);
+        EXPECT_EQ(column.back(), 4);
+        EXPECT_EQ(std::accumulate(column.begin(), column.end(), 0), 13);
+        EXPECT_EQ(column.end() - column.begin(), 3);
+
+        std::sort(column.begin(), column.end());  // Sorts the column in place.
+        EXPECT_EQ(m, (sc::vector<int>{9, 1, 5, 0, 3, 4, 2, 7, 6, 8, 1, 2}));
+
+        sc::span<int> s{m};
+        sc::slice<int> even = s.strided(2);
+        EXPECT_EQ(even.size(), 6);
+        EXPECT_EQ(even[5], 1);
+        sc::slice<int> every4 = even.strided(2);  // Composes into a stride of 4.
+        EXPECT_EQ(every4.stride(), 4);
+        EXPECT_EQ(every4.size(), 3);
+        EXPECT_EQ(every4[1], 3);
+        EXPECT_EQ(s.strided(5).size(), 3);
+        EXPECT_EQ(even.last(2).front(), 6);
+        EXPECT_EQ(even.subslice(1, 2)[1], 3);
+        EXPECT_TRUE(s.strided(1).contiguous());
+        EXPECT_FALSE(even.contiguous());
+
+        sc::slice<const int> ceven = even;
+        EXPECT_EQ(*(ceven.begin() + 3), 2);
+
+        // Iterators never point past the array, even when the stride overshoots its end.
+        int five[5]{1, 2, 3, 4, 5};
+        sc::slice<int> odd = sc::span<int>(five).strided(2);
+        EXPECT_EQ(*(odd.end() - 1), 5);
+        EXPECT_EQ(*--odd.end(), 5);
+        EXPECT_EQ(std::accumulate(std::reverse_iterator<sc::slice<int>::iterator>(odd.end()),
+                                  std::reverse_iterator<sc::slice<int>::iterator>(odd.begin()), 0),
+                  9);
+        EXPECT_TRUE(odd.last(0).empty());
+        EXPECT_TRUE(odd.subslice(3).empty());
+        EXPECT_TRUE((odd.subslice(3).begin() == odd.subslice(3).end()));
+
+        bool threw{false};
+        try {
+            s.strided(0);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+    }
+
+    {
+        BEGIN_TEST(tm, "Bytes", "as_bytes and as_writable_bytes alias the elements");
+
+        sc::vector<std::uint32_t> vec{0x01020304u, 0xA0B0C0D0u};
+        sc::span<const unsigned char> bytes = sc::as_bytes(sc::span<const std::uint32_t>(vec));
+        EXPECT_EQ(bytes.size(), 8);
+        EXPECT_TRUE((bytes.data() == reinterpret_cast<const unsigned char*>(vec.data())));
+
+        sc::vector<std::uint32_t> target(2);
+        sc::span<unsigned char> raw = sc::as_writable_bytes(sc::span<std::uint32_t>(target));
+        std::memcpy(raw.data(), bytes.data(), bytes.size());
+        EXPECT_EQ(target, vec);
+    }
+
+    {
+        BEGIN_TEST(tm, "Algorithms", "sort and hash_value on spans");
+
+        sc::vector<int> vec{5, 9, 1, 7, 3, 8, 2, 6, 4, 0};
+        sc::sort(sc::span<int>(vec).subspan(2, 5));  // Only the middle.
+        EXPECT_EQ(vec, (sc::vector<int>{5, 9, 1, 2, 3, 7, 8, 6, 4, 0}));
+
+        sc::vector<std::uint64_t> big(5000);
+        for (std::size_t i{0}; i < big.size(); ++i) big[i] = (i * 2654435761u) % 10007;
+        sc::span<std::uint64_t> upper = sc::span<std::uint64_t>(big).last(3000);
+        sc::sort(upper);  // Radix path.
+        EXPECT_TRUE(std::is_sorted(upper.begin(), upper.end()));
+        sc::parallel_sort(sc::span<std::uint64_t>(big).first(2000), 4);
+        EXPECT_TRUE(std::is_sorted(big.data(), big.data() + 2000));
+
+        sc::vector<int> part{3, 7, 8};
+        EXPECT_EQ(sc::hash_value(sc::span<int>(vec).subspan(4, 3)), sc::hash_value(part));
+        EXPECT_NE(sc::hash_value(sc::span<int>(vec).subspan(3, 3)), sc::hash_value(part));
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,160 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../include/static_vector.h"
+#include "include/same_contents.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING STATIC VECTOR
+// ============================================================================
+
+/// Same layout and copy semantics as a C array for trivially copyable elements.
+static_assert(std::is_trivially_copyable<sc::static_vector<int, 16>>::value, "static_vector<int> must be memcpy-able");
+static_assert(not std::is_trivially_copyable<sc::static_vector<std::string, 4>>::value, "strings must be copied");
+static_assert(sizeof(sc::static_vector<std::uint8_t, 255>) == 256, "the size of a small vector takes one byte");
+
+/// Exercises the modifiers inside a function that is `constexpr` in C++20 mode.
+SC_CONSTEXPR int static_checksum(int n) {
+    sc::static_vector<int, 32> sv;
+    for (int i{1}; i <= n; ++i) sv.push_back(i * i);
+    sv.insert(sv.begin(), {-1, -2});
+    sv.erase(sv.begin(), sv.begin() + 2);
+    sc::static_vector<int, 32> copy{sv};
+
+    int sum{0};
+    for (auto it = copy.begin(); it != copy.end(); ++it) sum += *it;
+    return sum;
+}
+#if __cplusplus >= 202002L && defined(__cpp_constexpr_dynamic_alloc)
+static_assert(static_checksum(10) == 385, "static_vector must be usable in constant expressions");
+#endif
+
+void run_static_vector_tests(void) {
+    TestManager tm{"Testing a static vector"};
+
+    {
+        BEGIN_TEST(tm, "Basics", "push_back/pop_back/at within a fixed capacity");
+
+        sc::static_vector<int, 4> sv;
+        EXPECT_TRUE(sv.empty());
+        EXPECT_EQ(sv.capacity(), 4);
+        for (auto i{0}; i < 4; ++i) sv.push_back(i);
+        EXPECT_TRUE(sv.full());
+        EXPECT_TRUE(same_contents(sv, std::vector<int>{0, 1, 2, 3}));
+        EXPECT_EQ(sv.front(), 0);
+        EXPECT_EQ(sv.back(), 3);
+        EXPECT_EQ(sv.data()[2], 2);
+
+        bool threw{false};
+        try {
+            sv.push_back(4);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+        EXPECT_EQ(sv.size(), 4);
+
+        threw = false;
+        try {
+            sv.at(4);
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+
+        sv.pop_back();
+        sv.pop_back();
+        EXPECT_TRUE(same_contents(sv, std::vector<int>{0, 1}));
+        EXPECT_TRUE(same_contents(sc::static_vector<int, 4>(3), std::vector<int>(3)));
+    }
+
+    {
+        BEGIN_TEST(tm, "InsertErase", "insert/erase against std::vector, with strings");
+
+        sc::static_vector<std::string, 16> sv{"a", "e"};
+        std::vector<std::string> ref{"a", "e"};
+
+        sv.insert(sv.begin() + 1, {"b", "c", "d"});
+        ref.insert(ref.begin() + 1, {"b", "c", "d"});
+        EXPECT_TRUE(same_contents(sv, ref));
+
+        // Inserting one of our own elements, and a range of our own elements.
+        sv.insert(sv.begin(), sv[4]);
+        ref.insert(ref.begin(), std::string(ref[4]));
+        EXPECT_TRUE(same_contents(sv, ref));
+        auto pos = sv.insert(sv.end(), sv.begin(), sv.begin() + 3);
+        std::vector<std::string> head(ref.begin(), ref.begin() + 3);
+        ref.insert(ref.end(), head.begin(), head.end());
+        EXPECT_TRUE(same_contents(sv, ref));
+        EXPECT_EQ(*pos, "e");
+
+        sv.erase(sv.begin() + 2, sv.begin() + 5);
+        ref.erase(ref.begin() + 2, ref.begin() + 5);
+        sv.erase(sv.begin());
+        ref.erase(ref.begin());
+        EXPECT_TRUE(same_contents(sv, ref));
+
+        // An empty range is a no-op, also for elements that a self-move would empty.
+        auto same = sv.erase(sv.begin() + 1, sv.begin() + 1);
+        EXPECT_TRUE(same_contents(sv, ref));
+        EXPECT_TRUE((same == sv.begin() + 1));
+
+        // A range that does not fit leaves the container unchanged.
+        std::vector<std::string> many(20, "x");
+        bool threw{false};
+        try {
+            sv.insert(sv.begin(), many.begin(), many.end());
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        EXPECT_TRUE(threw);
+        EXPECT_TRUE(same_contents(sv, ref));
+    }
+
+    {
+        BEGIN_TEST(tm, "AssignCompare", "assign() variants and ==, !=");
+
+        sc::static_vector<int, 8> a{1, 2, 3};
+        sc::static_vector<int, 8> b;
+        b.assign(3, 7);
+        EXPECT_TRUE(same_contents(b, std::vector<int>{7, 7, 7}));
+        EXPECT_NE(a, b);
+
+        b.assign(a.begin(), a.end());
+        EXPECT_EQ(a, b);
+        b.assign(b.begin() + 1, b.end());  // From our own elements.
+        EXPECT_TRUE(same_contents(b, std::vector<int>{2, 3}));
+        b = {5, 6, 7, 8, 9};
+        EXPECT_TRUE(same_contents(b, std::vector<int>{5, 6, 7, 8, 9}));
+        b.clear();
+        EXPECT_TRUE(b.empty());
+
+        sc::static_vector<std::string, 4> s{"x", "y"};
+        sc::static_vector<std::string, 4> t;
+        t = s;
+        EXPECT_EQ(t, s);
+        t.assign({"z"});
+        EXPECT_NE(t, s);
+    }
+
+    {
+        BEGIN_TEST(tm, "TriviallyCopyable", "memcpy of a static_vector<int> and constexpr use");
+
+        sc::static_vector<int, 16> sv{4, 5, 6};
+        sc::static_vector<int, 16> copy;
+        std::memcpy(static_cast<void*>(&copy), static_cast<const void*>(&sv), sizeof sv);
+        EXPECT_EQ(copy, sv);
+
+        EXPECT_EQ(static_checksum(10), 385);
+        EXPECT_EQ(static_checksum(0), 0);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
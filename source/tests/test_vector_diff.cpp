@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "fuzz/vector_diff.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING VECTOR AGAINST STD::VECTOR
+// ============================================================================
+
+void run_vector_diff_tests(void) {
+    TestManager tm{"Testing vector against std::vector"};
+
+    {
+        BEGIN_TEST(tm, "RandomPrograms", "random operation sequences on every configuration match std::vector");
+
+        // A smoke run; tests/fuzz/stress_vector runs millions of operations.
+        std::mt19937_64 rng{45};
+        for (const fuzz::Config& config : fuzz::configs()) {
+            bool passed{true};
+            for (auto round{0}; round < 20; ++round)
+                if (config.run(fuzz::random_program(rng, 500), 128).failed()) passed = false;
+            EXPECT_TRUE(passed);
+        }
+    }
+
+    {
+        BEGIN_TEST(tm, "Programs", "decoding, encoding and the self-referencing operations");
+
+        std::vector<std::uint8_t> bytes{0, 1, 2, 3, 3, 0, 0, 0, 6, 0, 0, 2, 15, 0, 0, 0, 99};
+        fuzz::program_t program = fuzz::decode(bytes.data(), bytes.size());
+        EXPECT_EQ(program.size(), 4);  // The trailing byte is not an operation.
+        EXPECT_TRUE((program[1].kind == fuzz::op_t::INSERT_SELF));
+        EXPECT_TRUE((fuzz::encode(program) == std::vector<std::uint8_t>(bytes.begin(), bytes.end() - 1)));
+        EXPECT_EQ(fuzz::to_string(program[0]), "PUSH_BACK a=1 b=2 c=3");
+
+        for (const fuzz::Config& config : fuzz::configs()) EXPECT_FALSE(config.run(program, 16).failed());
+    }
+
+    {
+        BEGIN_TEST(tm, "Shrink", "a failing program shrinks to the operations that matter");
+
+        // "Fails" when an ERASE follows at least two PUSH_BACKs with a nonzero value byte.
+        auto fails = [](const fuzz::program_t& p) {
+            int pushes{0};
+            for (const fuzz::Op& op : p) {
+                if (op.kind == fuzz::op_t::PUSH_BACK and op.b != 0) ++pushes;
+                if (op.kind == fuzz::op_t::ERASE and pushes >= 2) return true;
+            }
+            return false;
+        };
+        std::mt19937_64 rng{7};
+        fuzz::program_t program = fuzz::random_program(rng, 300);
+        EXPECT_TRUE(fails(program));
+        fuzz::program_t small = fuzz::shrink(program, fails);
+        EXPECT_EQ(small.size(), 3);
+        EXPECT_TRUE(fails(small));
+        EXPECT_EQ(small[2].a, 0);  // Argument bytes that do not matter are zeroed.
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../include/vector_hash.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING VECTOR HASHING
+// ============================================================================
+
+void run_vector_hash_tests(void) {
+    TestManager tm{"Testing vector hashing"};
+
+    {
+        BEGIN_TEST(tm, "HashBytes", "sc::hash_bytes(data, len) is XXH64");
+
+        // Reference values of XXH64 with seed 0.
+        EXPECT_EQ(sc::hash_bytes("", 0), 0xEF46DB3751D8E999ULL);
+        EXPECT_EQ(sc::hash_bytes("a", 1), 0xD24EC4F1A98C6E5BULL);
+        EXPECT_EQ(sc::hash_bytes("abc", 3), 0x44BC2CF5AD770999ULL);
+
+        // The alignment of the input does not matter, for every tail length.
+        char buffer[80];
+        for (auto i{0u}; i < sizeof buffer; ++i) buffer[i] = static_cast<char>(i * 7);
+        bool ok{true};
+        for (auto len{0u}; len < 64; ++len) {
+            char shifted[80];
+            std::memcpy(shifted + 3, buffer, len);
+            ok = ok and sc::hash_bytes(buffer, len) == sc::hash_bytes(shifted + 3, len);
+        }
+        EXPECT_TRUE(ok);
+    }
+
+    {
+        BEGIN_TEST(tm, "StdHash", "std::hash<sc::vector<T>>");
+
+        std::hash<sc::vector<std::uint32_t>> hasher;
+        sc::vector<std::uint32_t> a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        sc::vector<std::uint32_t> b{a};
+        b.reserve(100);  // Capacity is not part of the value.
+        EXPECT_EQ(hasher(a), hasher(b));
+
+        b[9] = 11;
+        EXPECT_NE(hasher(a), hasher(b));
+        EXPECT_NE(hasher(sc::vector<std::uint32_t>{}), hasher(sc::vector<std::uint32_t>{0}));
+
+        // Elements that are not hashed through their bytes.
+        std::hash<sc::vector<std::string>> string_hasher;
+        sc::vector<std::string> s1{"ab", "c"};
+        sc::vector<std::string> s2{"a", "bc"};
+        EXPECT_EQ(string_hasher(s1), string_hasher(sc::vector<std::string>{"ab", "c"}));
+        EXPECT_NE(string_hasher(s1), string_hasher(s2));
+    }
+
+    {
+        BEGIN_TEST(tm, "UnorderedKeys", "std::unordered_set<sc::vector<std::uint8_t>>");
+
+        std::unordered_set<sc::vector<std::uint8_t>> seen;
+        for (auto i{0}; i < 1000; ++i) {
+            sc::vector<std::uint8_t> key{static_cast<std::uint8_t>(i % 100), static_cast<std::uint8_t>(i % 7)};
+            seen.insert(key);
+        }
+        EXPECT_EQ(seen.size(), 700);
+        EXPECT_EQ(seen.count(sc::vector<std::uint8_t>{5, 5}), 1u);
+        EXPECT_EQ(seen.count(sc::vector<std::uint8_t>{100, 0}), 0u);
+    }
+
+    {
+        BEGIN_TEST(tm, "HashedVector", "sc::hashed_vector caches its hash");
+
+        sc::hashed_vector<int> hv{1, 2, 3};
+        auto h = hv.hash();
+        EXPECT_EQ(h, sc::hash_value(hv.get()));
+        EXPECT_EQ(hv.hash(), h);
+
+        hv.push_back(4);
+        EXPECT_NE(hv.hash(), h);
+        EXPECT_EQ(hv.hash(), sc::hash_value(sc::vector<int>{1, 2, 3, 4}));
+
+        hv.pop_back();
+        EXPECT_EQ(hv.hash(), h);
+
+        hv.set(0, 10);
+        EXPECT_EQ(hv.hash(), sc::hash_value(sc::vector<int>{10, 2, 3}));
+
+        hv.modify([](sc::vector<int>& v) { v.insert(v.begin(), 0); });
+        EXPECT_EQ(hv.hash(), sc::hash_value(sc::vector<int>{0, 10, 2, 3}));
+
+        std::unordered_map<sc::hashed_vector<int>, int> counts;
+        counts[hv] = 1;
+        counts[sc::hashed_vector<int>{0, 10, 2, 3}] += 1;
+        EXPECT_EQ(counts.size(), 1);
+        EXPECT_EQ(counts[hv], 2);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
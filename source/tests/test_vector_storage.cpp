@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "../include/vector.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING VECTOR STORAGE STRATEGIES
+// ============================================================================
+
+/// An element type whose vectors all use the buffer cache.
+struct Token {
+    int kind;
+    int offset;
+};
+SC_VECTOR_STORAGE(Token, sc::cached_storage)
+
+static_assert(std::is_same<sc::vector<Token>,
+                           sc::vector<Token, unsigned long, sc::never_shrink, sc::cached_storage>>::value,
+              "the per-type default must apply to sc::vector<Token>");
+static_assert(std::is_same<sc::vector<int>, sc::vector<int, unsigned long, sc::never_shrink, sc::heap_storage>>::value,
+              "other types keep std::allocator");
+static_assert(sizeof(sc::vector<int, unsigned long, sc::never_shrink, sc::arena_storage>) == sizeof(sc::vector<int>),
+              "the strategy takes no room in the vector");
+
+/// A vector drawing from the active arena.
+template <typename T>
+using arena_vector = sc::vector<T, unsigned long, sc::never_shrink, sc::arena_storage>;
+
+void run_vector_storage_tests(void) {
+    TestManager tm{"Testing vector storage strategies"};
+
+    {
+        BEGIN_TEST(tm, "Arena", "vectors in an arena_scope bump-allocate and reset() frees them at once");
+
+        sc::vector_arena arena{4096};
+        arena_vector<int> survivor;
+        {
+            sc::arena_scope scope{arena};
+            arena_vector<int> a;
+            for (auto i{0}; i < 500; ++i) a.push_back(i);
+            EXPECT_EQ(arena.live_blocks(), 1);  // The blocks left behind by growth are not live.
+
+            arena_vector<std::string> b{"x", "y"};
+            EXPECT_EQ(arena.live_blocks(), 2);
+            b.insert(b.begin(), std::string(100, 'z'));
+            EXPECT_EQ(b.front().size(), 100);
+
+            survivor = a;
+            EXPECT_EQ(arena.live_blocks(), 3);
+        }
+        EXPECT_EQ(arena.live_blocks(), 1);
+        EXPECT_EQ(survivor[499], 499);
+
+        // Outside the scope a vector grows on the heap, and gives its old block back to the arena.
+        survivor.reserve(survivor.capacity() + 1);
+        EXPECT_EQ(arena.live_blocks(), 0);
+        EXPECT_EQ(survivor[499], 499);
+
+        // After reset() the same memory serves the next round; large blocks get their own chunk.
+        arena.reset();
+        {
+            sc::arena_scope scope{arena};
+            arena_vector<std::uint64_t> big(2000);
+            EXPECT_EQ(big.size(), 2000);
+            EXPECT_TRUE((arena.capacity() >= 4096 + 2000 * sizeof(std::uint64_t)));
+
+            sc::vector_arena inner;
+            {
+                sc::arena_scope nested{inner};
+                arena_vector<int> c{7};
+                EXPECT_EQ(inner.live_blocks(), 1);
+            }
+            arena_vector<int> d{8};
+            EXPECT_EQ(arena.live_blocks(), 2);
+        }
+        arena.reset();
+        EXPECT_EQ(arena.live_blocks(), 0);
+    }
+
+    {
+        BEGIN_TEST(tm, "BufferCache", "freed buffers are reused by the next vectors of the thread");
+
+        typedef sc::vector<int, unsigned long, sc::never_shrink, sc::cached_storage> cached_vector;
+        sc::cached_storage::release();
+        auto before = sc::cached_storage::thread_stats();
+
+        for (auto round{0}; round < 100; ++round) {
+            cached_vector v;
+            v.reserve(200);
+            for (auto i{0}; i < 200; ++i) v.push_back(i);
+            cached_vector w{v};
+            EXPECT_EQ(w[199], 199);
+        }
+        auto after = sc::cached_storage::thread_stats();
+        EXPECT_EQ(after.misses - before.misses, 2);
+        EXPECT_EQ(after.hits - before.hits, 198);
+        EXPECT_EQ(after.buffers, 2);
+
+        // Another thread has its own cache.
+        std::size_t other_hits{1};
+        std::thread t([&other_hits] {
+            cached_vector v(10);
+            other_hits = sc::cached_storage::thread_stats().hits;
+        });
+        t.join();
+        EXPECT_EQ(other_hits, 0);
+
+        // Per-type default, and the compact layout drawing from the cache.
+        sc::vector<Token> tokens{{1, 0}, {2, 4}};
+        tokens.push_back(Token{3, 9});
+        EXPECT_EQ(tokens.back().offset, 9);
+        sc::vector<int, sc::compact<std::uint32_t>, sc::never_shrink, sc::cached_storage> compact{1, 2, 3};
+        compact.reserve(1000);
+        EXPECT_EQ(compact[2], 3);
+
+        sc::cached_storage::release();
+        EXPECT_EQ(sc::cached_storage::thread_stats().buffers, 0);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}
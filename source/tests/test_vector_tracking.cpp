@@ -0,0 +1,135 @@
+// This translation unit is built in tracking mode; its vectors are the only tracked ones.
+#define SC_VECTOR_TRACKING
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../include/vector.h"
+#include "include/tm/test_manager.h"
+
+// ============================================================================
+// TESTING VECTOR TRACKING
+// ============================================================================
+
+/// Returns the usage of `site`, or an empty record when it has no live vector.
+static sc::site_usage usage_of(const std::string& site) {
+    for (const auto& u : sc::memory_usage())
+        if (u.site == site) return u;
+    return sc::site_usage{site, 0, 0, 0};
+}
+
+void run_vector_tracking_tests(void) {
+    TestManager tm{"Testing vector tracking"};
+
+    {
+        BEGIN_TEST(tm, "Report", "size, capacity and slack per site, as text and JSON");
+
+        {
+            sc::tracking_scope scope{"routes"};
+            sc::vector<int> a;
+            a.reserve(100);
+            for (auto i{0}; i < 10; ++i) a.push_back(i);
+            sc::vector<double> b(4);
+
+            auto u = usage_of("routes");
+            EXPECT_EQ(u.vectors, 2);
+            EXPECT_EQ(u.size_bytes, 10 * sizeof(int) + 4 * sizeof(double));
+            EXPECT_EQ(u.capacity_bytes, 100 * sizeof(int) + 4 * sizeof(double));
+            EXPECT_EQ(u.slack_bytes(), 90 * sizeof(int));
+
+            std::string text = sc::memory_report();
+            EXPECT_TRUE((text.find("routes") != std::string::npos));
+            EXPECT_TRUE((text.find("total") != std::string::npos));
+            std::string json = sc::memory_report(sc::report_format::json);
+            EXPECT_TRUE((json.find("\"site\": \"routes\", \"vectors\": 2") != std::string::npos));
+            EXPECT_EQ(json.front(), '[');
+        }
+        EXPECT_EQ(usage_of("routes").vectors, 0);
+    }
+
+    {
+        BEGIN_TEST(tm, "Sites", "SC_VECTOR_SITE(), nested scopes and copies");
+
+        sc::tracking_scope outer{"outer"};
+        sc::vector<int> a{1, 2, 3};
+        std::string here;
+        {
+            SC_VECTOR_SITE();
+            here = std::string(__FILE__) + ":" + std::to_string(__LINE__ - 1);
+            sc::vector<int> b{4, 5};
+            EXPECT_EQ(usage_of(here).vectors, 1);
+        }
+        EXPECT_EQ(usage_of(here).vectors, 0);
+        EXPECT_EQ(usage_of("outer").vectors, 1);
+
+        sc::vector<int> copy{a};  // Made inside "outer": takes the active tag.
+        EXPECT_EQ(usage_of("outer").vectors, 2);
+
+        // Swapping moves the recorded sizes along with the storage.
+        sc::vector<int> empty;
+        swap(a, empty);
+        EXPECT_EQ(usage_of("outer").size_bytes, 6 * sizeof(int));
+    }
+
+    {
+        BEGIN_TEST(tm, "TrimAll", "trim_all(threshold) shrinks only the wasteful vectors");
+
+        sc::tracking_scope scope{"trim"};
+        sc::vector<int> wasteful;
+        wasteful.reserve(1000);
+        wasteful.push_back(1);
+        sc::vector<int> snug;
+        snug.reserve(10);
+        for (auto i{0}; i < 9; ++i) snug.push_back(i);
+
+        // A vector of vectors: trimming the outer one copies the inner ones.
+        sc::vector<sc::vector<int>> nested;
+        nested.reserve(50);
+        nested.push_back(wasteful);
+
+        auto released = sc::trim_all(0.5);
+        EXPECT_EQ(wasteful.capacity(), 1);
+        EXPECT_EQ(snug.capacity(), 10);
+        EXPECT_EQ(nested.capacity(), 1);
+        EXPECT_EQ(nested[0].capacity(), 1);
+        EXPECT_TRUE((released >= 2 * 999 * sizeof(int)));
+        EXPECT_EQ(usage_of("trim").slack_bytes(), sizeof(int));
+    }
+
+    {
+        BEGIN_TEST(tm, "CopyWhileReporting", "copies take their source's site while other threads report");
+
+        sc::vector<int> original = [] {
+            sc::tracking_scope scope{"original"};
+            return sc::vector<int>{7, 8};
+        }();
+
+        std::atomic<bool> done{false};
+        std::thread copier([&original, &done] {
+            for (int i{0}; i < 2000; ++i) {
+                sc::vector<int> serial{original};  // Untagged thread: inherits "original".
+                sc::vector<int> parallel{original, sc::parallel_t{1}};
+                (void)serial;
+                (void)parallel;
+            }
+            done = true;
+        });
+        std::size_t reports{0};
+        bool only_original{true};
+        while (not done or reports == 0) {
+            for (const auto& u : sc::memory_usage()) only_original = only_original and u.site == "original";
+            ++reports;
+        }
+        copier.join();
+        EXPECT_TRUE(only_original);
+        EXPECT_EQ(usage_of("original").vectors, 1);
+
+        sc::vector<int> late{original};
+        EXPECT_EQ(usage_of("original").vectors, 2);
+    }
+
+    tm.summary();
+    std::cout << "\n\n";
+}